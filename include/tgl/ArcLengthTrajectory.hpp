@@ -0,0 +1,174 @@
+/*! \file       ArcLengthTrajectory.hpp
+ *  \brief      A constant speed trajectory along the arc-length parameterized spline through a Waypoint Set.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_ARCLENGTHTRAJECTORY_H
+#define TGL_ARCLENGTHTRAJECTORY_H
+
+// STL includes
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+#include "tgl/CubicSplineTrajectory.hpp"
+#include "tgl/PiecewisePolynomial.hpp"
+
+#ifndef TGL_ARC_LENGTH_TOLERANCE /*!< The relative tolerance of the arc-length table on each spline segment. */
+#define TGL_ARC_LENGTH_TOLERANCE 1e-10
+#endif
+
+#ifndef TGL_ARC_LENGTH_MAX_DEPTH /*!< The maximum bisection depth of the adaptive arc-length quadrature, which caps the table at 2^(depth+1) entries per spline segment. */
+#define TGL_ARC_LENGTH_MAX_DEPTH 12
+#endif
+
+namespace tgl
+{
+
+/*! \class ArcLengthTrajectory
+ *  \brief A trajectory moving at a constant speed along the path through a Waypoint Set.
+ *
+ *  The geometric path is the CubicSplineTrajectory \f$ p(t) \f$ through the waypoints, whose timing is ignored. The trajectory travels along it with \f$ \| \dot{x} \| = v \f$, i.e. the arc-length \f$ s = v (t - t_0) \f$ is inverted to the path time through
+    \f[
+        s(t) = \int_{t_0}^{t} \| p'(u) \| du
+    \f]
+ *  The outputs are \f$ x = p(t) \f$, \f$ \dot{x} = v \, p'/\|p'\| \f$ and \f$ \ddot{x} = v^2 \left( p'' - (p'^T p'') \, p' / \|p'\|^2 \right) / \|p'\|^2 \f$. Every DoF of the waypoints counts in the norm, so the waypoints should hold the Cartesian coordinates only.
+ *
+ *  The integral is computed in `setWaypoints()` with adaptive 5-point Gauss-Legendre quadrature on the spline coefficients, which bisects each spline segment until both the quadrature and the interpolant below agree within TGL_ARC_LENGTH_TOLERANCE times the segment length. The bisection points make a monotone table of \f$ (t_k, s_k, \dot{s}_k, \ddot{s}_k) \f$ quadruples, capped at TGL_ARC_LENGTH_MAX_DEPTH bisections per segment. At run time the table interval containing \f$ s \f$ is found with `findSegment()`, which is O(1) for a clock moving forward, and \f$ t \f$ is found by inverting the quintic Hermite interpolant of \f$ s(t) \f$ on the interval, a few flops per Newton step. The path is evaluated once per tick, for the outputs.
+ *
+ *  The speed jumps from 0 to \f$ v \f$ at the start and back to 0 at the end. Wrap the trajectory in a RetimedTrajectory to ramp it.
+ */
+class ArcLengthTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     */
+    ArcLengthTrajectory();
+
+    /*! Initializing constructor. Sets the waypoints and the speed.
+     *  \param newWptSet a Waypoint Set of TGL_WPT_VECTOR_XD waypoints with strictly increasing times.
+     *  \param newSpeed the speed along the path (must be positive)
+     */
+    ArcLengthTrajectory(const WaypointSet& newWptSet, const double newSpeed);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~ArcLengthTrajectory();
+
+    /*! Sets the waypoints, builds the path and its arc-length table.
+     *  \param newWptSet a Waypoint Set of at least two TGL_WPT_VECTOR_XD waypoints with strictly increasing times.
+     *  \return TGL_OK on success, TGL_ERROR if the path could not be built.
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+    /*! Sets the speed along the path.
+     *  \param newSpeed the speed (must be positive)
+     *  \return TGL_OK on success, TGL_ERROR if the speed is not positive.
+     */
+    TglMessage setSpeed(const double newSpeed);
+
+    /*! Get the speed along the path.
+     *  \return The speed.
+     */
+    double getSpeed() const;
+
+    /*! Get the length of the path.
+     *  \return The path length, 0 if the path has not been built.
+     */
+    double getPathLength() const;
+
+    /*! Get the duration of the motion, i.e. the path length over the speed.
+     *  \return The duration in seconds.
+     */
+    double getDuration() const;
+
+    /*! Inverts the arc-length function.
+     *  \param arcLength the arc-length from the start of the path, clamped to [0, getPathLength()]
+     *  \param pathTime the time of the underlying spline at which the arc-length is reached
+     *  \return TGL_OK on success, TGL_ERROR if the path has not been built.
+     */
+    TglMessage getPathTime(const double arcLength, double& pathTime);
+
+    /*! Get an estimate of the memory held by the trajectory, path and arc-length table included.
+     *  \return The size in bytes.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+protected:
+
+    /*! Open loop implementation. Returns the position, velocity and acceleration at constant speed.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    /*! The speed of the underlying spline \f$ \| p'(t) \| \f$, from its coefficients.
+     */
+    double getPathSpeed(const double pathTime);
+
+    /*! The speed of the underlying spline and its time derivative \f$ p'^T p'' / \| p' \| \f$.
+     */
+    void getPathSpeed(const double pathTime, double& pathSpeed, double& pathSpeedRate);
+
+    /*! The 5-point Gauss-Legendre integral of the path speed over [a, b].
+     */
+    double integratePathSpeed(const double a, const double b);
+
+    /*! Integrates the path speed over [a, b] adaptively and appends the bisection points to the table.
+     *  \param a the start of the interval, already in the table
+     *  \param b the end of the interval
+     *  \param speedB the path speed at b
+     *  \param speedRateB the time derivative of the path speed at b
+     *  \param estimate the Gauss-Legendre integral over [a, b]
+     *  \param tolerance the absolute tolerance on the integral over [a, b], halved at each bisection
+     *  \param depth the recursion depth
+     */
+    void buildTable(const double a, const double b, const double speedB, const double speedRateB, const double estimate, const double tolerance, const int depth);
+
+    CubicSplineTrajectory path;     /*!< The geometric path through the waypoints. */
+    std::shared_ptr<const PiecewisePolynomial> pathCore;    /*!< The coefficients of the path, evaluated directly to integrate its speed. */
+    int pathCursor;                 /*!< The segment search state of the path core. */
+    StdDoubleVector tableTimes;     /*!< The path times of the table, increasing. */
+    StdDoubleVector tableLengths;   /*!< The arc-lengths at tableTimes, non decreasing. */
+    StdDoubleVector tableSpeeds;    /*!< The path speeds at tableTimes, the slopes of the interpolant. */
+    StdDoubleVector tableSpeedRates;    /*!< The time derivatives of the path speeds at tableTimes, the curvatures of the interpolant. */
+    double speed;                   /*!< The speed along the path. */
+    int tableCursor;                /*!< The last table interval used, the starting point of the next search. */
+    Eigen::VectorXd pathPos;        /*!< Preallocated path position. */
+    Eigen::VectorXd pathVel;        /*!< Preallocated path velocity. */
+    Eigen::VectorXd pathAcc;        /*!< Preallocated path acceleration. */
+};
+
+} // end of namespace tgl
+#endif // TGL_ARCLENGTHTRAJECTORY_H
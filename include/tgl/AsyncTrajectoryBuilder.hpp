@@ -0,0 +1,140 @@
+/*! \file       AsyncTrajectoryBuilder.hpp
+ *  \brief      Builds trajectories in the background and hands out the latest one.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_ASYNCTRAJECTORYBUILDER_H
+#define TGL_ASYNCTRAJECTORYBUILDER_H
+
+// STL includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+#include "tgl/TrajectoryExecutor.hpp"
+
+namespace tgl
+{
+
+/*! \class AsyncTrajectoryBuilder
+ *  \brief Builds trajectories in the background and hands out the latest one.
+ *
+ *  Building a spline or an optimized trajectory can take from milliseconds to seconds. `submit()` queues the build on a TrajectoryExecutor and returns immediately with a future of the result, so the caller (a planner, a control loop) never waits for it. The control loop keeps following `getLatest()`, which switches to the new trajectory atomically once it is complete.
+ *
+ *  Each builder is a channel where only the newest request matters: submitting supersedes the requests which are still pending. A superseded request which has not started is skipped, and one which is already running has its result dropped when it ends. Superseded and failed requests resolve their future with a null pointer and do not call their ready callback. `cancel()` supersedes everything without submitting anything new.
+    ~~~~~~~~~~~~~~{.cpp}
+    tgl::AsyncTrajectoryBuilder builder;
+    builder.submit(std::make_shared<tgl::MinimumSnapTrajectory>(), wptSet,
+                   [](tgl::TrajectoryPtr traj) { std::cout << "New trajectory ready." << std::endl; });
+    // In the control loop:
+    tgl::TrajectoryPtr traj = builder.getLatest();
+    if (traj) traj->getDesired(pos, vel, acc, t);
+    ~~~~~~~~~~~~~~
+ *  The ready callbacks run on the executor threads. The destructor supersedes the pending requests and waits for the running one, so callbacks never outlive the builder.
+ */
+class AsyncTrajectoryBuilder {
+public:
+
+    /*! A function building a trajectory, returning null on failure.
+     */
+    using BuildFunction = std::function<TrajectoryPtr()>;
+
+    /*! A function called with each new trajectory once it is built.
+     */
+    using ReadyCallback = std::function<void(TrajectoryPtr)>;
+
+    /*! Initializing constructor.
+     *  \param newExecutor the pool running the builds, the library-owned one by default
+     */
+    AsyncTrajectoryBuilder(TrajectoryExecutor& newExecutor=TrajectoryExecutor::getDefault());
+
+    /*! Basic destructor. Cancels the pending requests and waits for the running one.
+     */
+    ~AsyncTrajectoryBuilder();
+
+    /*! Queues a build, superseding the pending ones.
+     *  \param build the function building the trajectory, run on the executor
+     *  \param onReady called on the executor with the trajectory once it is built, unless it was superseded. Exceptions it throws are logged and dropped.
+     *  \return A future of the trajectory, null if the build failed or was superseded.
+     */
+    std::shared_future<TrajectoryPtr> submit(BuildFunction build, ReadyCallback onReady=ReadyCallback());
+
+    /*! Queues `trajectory->setWaypoints(wptSet)`, superseding the pending builds. The trajectory must not be used elsewhere until its future is ready. It is built in place, so it must be a fresh object: the latest trajectory, which the readers of `getLatest()` may be evaluating, is rejected.
+     *  \param trajectory the trajectory to build
+     *  \param wptSet the waypoints, copied
+     *  \param onReady called on the executor with the trajectory once it is built, unless it was superseded. Exceptions it throws are logged and dropped.
+     *  \return A future of the trajectory, null if the trajectory is the latest one, setWaypoints() failed or the build was superseded.
+     */
+    std::shared_future<TrajectoryPtr> submit(TrajectoryPtr trajectory, const WaypointSet& wptSet, ReadyCallback onReady=ReadyCallback());
+
+    /*! Supersedes all the pending builds.
+     */
+    void cancel();
+
+    /*! Waits until no build is queued or running.
+     */
+    void wait();
+
+    /*! Get the most recently completed trajectory. Cheap enough for a control loop, it only copies a shared pointer.
+     *  \return The latest trajectory, null until a build completes.
+     */
+    TrajectoryPtr getLatest() const;
+
+    /*! Checks if builds are queued or running.
+     *  \return true while a build is in flight.
+     */
+    bool isBuilding() const;
+
+private:
+
+    /*! The state shared with the queued tasks.
+     */
+    struct State {
+        std::atomic<uint64_t> generation;   /*!< The id of the newest request, older requests are superseded. */
+        std::mutex mutex;                   /*!< Protects the counters and the publication of the latest trajectory. */
+        std::condition_variable idle;       /*!< Signaled when the last build in flight ends. */
+        int inFlight;                       /*!< The number of builds queued or running. */
+        TrajectoryPtr latest;               /*!< The latest trajectory, read with std::atomic_load. */
+    };
+
+    /*! Runs one request on the executor.
+     */
+    static void run(std::shared_ptr<State> state, const uint64_t id, const BuildFunction& build, const ReadyCallback& onReady, std::promise<TrajectoryPtr>& promise);
+
+    TrajectoryExecutor& executor;   /*!< The pool running the builds. */
+    std::shared_ptr<State> state;   /*!< The state shared with the tasks. */
+};
+
+} // end of namespace tgl
+#endif // TGL_ASYNCTRAJECTORYBUILDER_H
@@ -0,0 +1,131 @@
+/*! \file       BlendedTrajectory.hpp
+ *  \brief      A trajectory layer which blends online into new paths as goals stream in.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_BLENDEDTRAJECTORY_H
+#define TGL_BLENDEDTRAJECTORY_H
+
+// STL includes
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+
+namespace tgl
+{
+/*! \class BlendedTrajectory
+ *  \brief A trajectory layer which switches online to new paths through polynomial blends.
+ *
+ *  The trajectory is a short sequence of pieces, each one being either a child Trajectory or a quintic blend polynomial. When a new path arrives, `blendTo()` keeps the motion up to the switch time, splices in a quintic which joins the current position, velocity and acceleration to those of the new path after the blend duration, and then follows the new path. The result is \f$ C^2 \f$ across the switch as long as the paths themselves are.
+ *
+ *  Only the blend and the new path are computed when a goal arrives: the pieces after the switch time are dropped and so are the ones which ended before it, so the cost of accepting a goal and the memory used stay bounded no matter how long the motion has been running. The flip side is that the trajectory can not be evaluated before the last switch time anymore.
+ *
+ *  The children are evaluated with explicit times, so they must implement the **Open Loop** `getDesired()` and describe the same space (same dimension).
+ */
+class BlendedTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     */
+    BlendedTrajectory();
+
+    /*! Initializing constructor. Starts with a first path.
+     *  \param initialPath the path to follow until the first blend.
+     */
+    BlendedTrajectory(TrajectoryPtr initialPath);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~BlendedTrajectory();
+
+    /*! Replaces everything with a single path, without blending.
+     *  \param newPath the path to follow.
+     *  \return TGL_OK on success, TGL_ERROR if the path is null.
+     */
+    TglMessage setPath(TrajectoryPtr newPath);
+
+    /*! Sets a CubicSplineTrajectory built from the waypoints as the single path, without blending.
+     *  \param newWptSet the Waypoint Set to use for the trajectory.
+     *  \return TGL_OK on success, TGL_ERROR if the spline could not be built.
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+    /*! Blends from the current motion into a new path.
+     *  \param newPath the path to follow once the blend is over, evaluated with the same time base as this trajectory
+     *  \param switchTime the time at which the blend starts, usually the current time
+     *  \param blendDuration the duration of the blend (must be positive)
+     *  \return TGL_OK on success, TGL_ERROR if there is no current motion, the blend duration is not positive or the paths do not have the same dimension.
+     */
+    TglMessage blendTo(TrajectoryPtr newPath, const double switchTime, const double blendDuration);
+
+    /*! Blends from the current motion into a CubicSplineTrajectory built from new waypoints. See the other `blendTo()`.
+     *  \param newWptSet the waypoints of the new path
+     *  \param switchTime the time at which the blend starts, usually the current time
+     *  \param blendDuration the duration of the blend (must be positive)
+     *  \return TGL_OK on success, TGL_ERROR otherwise.
+     */
+    TglMessage blendTo(const WaypointSet& newWptSet, const double switchTime, const double blendDuration);
+
+    /*! Get the number of pieces (paths and blends) currently held.
+     *  \return The number of pieces.
+     */
+    int getNumberOfPieces() const;
+
+protected:
+
+    /*! Open loop implementation. Delegates to the path or blend active at the given time.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    /*! A path or a blend, active from its start time to the start time of the next piece.
+     */
+    struct Piece {
+        TrajectoryPtr path;                 /*!< The path to follow, null for a blend. */
+        Eigen::MatrixXd blendCoefficients;  /*!< The quintic blend coefficients c0 to c5 in the local time t - startTime, one column per power. */
+    };
+
+    /*! Appends a piece and its start time.
+     */
+    void appendPiece(const double startTime, TrajectoryPtr path, const Eigen::MatrixXd& blendCoefficients);
+
+    std::vector<Piece> pieces;      /*!< The pieces in time order. */
+    StdDoubleVector pieceBounds;    /*!< The piece start times followed by +infinity, piece i spans [pieceBounds[i], pieceBounds[i+1]]. */
+    int segmentCursor;              /*!< The last piece used, the starting point of the next piece search. */
+};
+
+} // end of namespace tgl
+#endif // TGL_BLENDEDTRAJECTORY_H
@@ -0,0 +1,145 @@
+/*! \file       CoefficientCache.hpp
+ *  \brief      A persistent on-disk cache of piecewise polynomial coefficients keyed by a waypoint content hash.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_COEFFICIENTCACHE_H
+#define TGL_COEFFICIENTCACHE_H
+
+// STL includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/WaypointSet.hpp"
+
+#ifndef TGL_COEFFICIENT_CACHE_VERSION /*!< The version of the cache file format. Files written with another version are ignored and replaced. */
+#define TGL_COEFFICIENT_CACHE_VERSION 1
+#endif
+
+namespace tgl
+{
+
+/*! \class CoefficientCache
+ *  \brief A persistent cache of computed trajectory coefficients on local disk.
+ *
+ *  Generators which take long to solve (splines over many waypoints, optimizers) can store their knot times and coefficients once and load them at the next process start instead of solving again. Entries are keyed by `computeKey()`, a 64-bit FNV-1a hash over the Waypoint Set content (type, times, coordinates, rotations) and the generator name and parameters. Generators should put a version in their name (e.g. "MinimumSnapTrajectory/1") so that changing the algorithm invalidates the old entries.
+ *
+ *  Each entry is a compact binary file `<key>.tglc` in the cache directory: a fixed header (magic number, format version, byte order marker, key, sizes and a checksum of the payload) followed by the knot times and the column-major coefficients. Files are written to a temporary file and renamed, so a crash never leaves a half written entry, and they are read through `mmap`. A file with a wrong header, size or checksum is treated as a miss and deleted.
+ *
+ *  The total size of the directory is bounded: after a store the least recently used entries (by modification time, refreshed on every hit) are evicted until the cache fits.
+    ~~~~~~~~~~~~~~{.cpp}
+    tgl::CoefficientCache cache("/var/cache/tgl", 512 << 20);
+    tgl::MinimumSnapTrajectory traj;
+    traj.setWaypoints(wptSet, cache);   // Solves and stores the first time, loads afterwards.
+    ~~~~~~~~~~~~~~
+ */
+class CoefficientCache {
+public:
+
+    /*! Initializing constructor. Creates the cache directory if needed.
+     *  \param newDirectory the directory holding the cache files (its parent must exist)
+     *  \param newMaxBytes the maximum total size of the cache files in bytes
+     */
+    CoefficientCache(const std::string& newDirectory, const std::size_t newMaxBytes=256*1024*1024);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~CoefficientCache();
+
+    /*! Computes the cache key of a trajectory.
+     *  \param wptSet the waypoints of the trajectory
+     *  \param generator the name and version of the generator, e.g. "CubicSplineTrajectory/1"
+     *  \param parameters the generator parameters which change the result
+     *  \return The 64-bit content hash.
+     */
+    static uint64_t computeKey(const WaypointSet& wptSet, const std::string& generator, const Eigen::VectorXd& parameters=Eigen::VectorXd());
+
+    /*! Loads an entry.
+     *  \param key the cache key
+     *  \param knotTimes the knot times of the entry
+     *  \param coefficients the coefficients of the entry
+     *  \return TGL_OK on a hit, TGL_WARNING on a miss (including corrupted or outdated entries, which are deleted).
+     */
+    TglMessage load(const uint64_t key, StdDoubleVector& knotTimes, Eigen::MatrixXd& coefficients);
+
+    /*! Stores an entry, replacing any previous one with the same key, then evicts the least recently used entries if the cache is too big.
+     *  \param key the cache key
+     *  \param knotTimes the knot times to store
+     *  \param coefficients the coefficients to store
+     *  \return TGL_OK on success, TGL_ERROR if the file could not be written.
+     */
+    TglMessage store(const uint64_t key, const StdDoubleVector& knotTimes, const Eigen::MatrixXd& coefficients);
+
+    /*! Deletes all the entries.
+     */
+    void clear();
+
+    /*! Get the total size of the entries on disk.
+     *  \return The size in bytes.
+     */
+    std::size_t getSizeOnDisk() const;
+
+    /*! Get the cache directory.
+     *  \return The directory path.
+     */
+    std::string getDirectory() const;
+
+private:
+
+    /*! A cache file found on disk.
+     */
+    struct Entry {
+        std::string path;       /*!< The file path. */
+        std::size_t size;       /*!< The file size in bytes. */
+        int64_t lastUse;        /*!< The modification time in nanoseconds, refreshed on every hit. */
+    };
+
+    /*! Lists the cache files.
+     */
+    std::vector<Entry> listEntries() const;
+
+    /*! Deletes the least recently used entries until the cache fits in maxBytes.
+     *  \param keptPath an entry which is never deleted, the one just stored
+     */
+    void evict(const std::string& keptPath);
+
+    /*! The path of the file of an entry.
+     */
+    std::string getEntryPath(const uint64_t key) const;
+
+    std::string directory;  /*!< The cache directory. */
+    std::size_t maxBytes;   /*!< The maximum total size of the entries. */
+};
+
+} // end of namespace tgl
+#endif // TGL_COEFFICIENTCACHE_H
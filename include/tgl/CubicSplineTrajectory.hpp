@@ -0,0 +1,203 @@
+/*! \file       CubicSplineTrajectory.hpp
+ *  \brief      A clamped cubic spline trajectory through vector or wrench waypoints.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_CUBICSPLINETRAJECTORY_H
+#define TGL_CUBICSPLINETRAJECTORY_H
+
+// STL includes
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+#include "tgl/PiecewisePolynomial.hpp"
+#include "tgl/SegmentBvh.hpp"
+#include "tgl/CoefficientCache.hpp"
+
+namespace tgl
+{
+
+/*! \class CubicSplineTrajectory
+ *  \brief A \f$ C^2 \f$ cubic spline trajectory passing exactly through every waypoint.
+ *
+ *  Works on TGL_WPT_VECTOR_XD and TGL_WPT_LGSM_WRENCH waypoints. Each segment \f$ i \f$ spans \f$ [t_i, t_{i+1}] \f$ and is a cubic in the local time \f$ \delta = t - t_i \f$:
+    \f[
+        p(\delta) = c_0 + c_1 \delta + c_2 \delta^2 + c_3 \delta^3
+    \f]
+ *  The spline is clamped with zero velocity at both ends, so the motion is rest to rest. The coefficients are computed once in `setWaypoints()` by solving the tridiagonal moment system for all DoF at once, which is O(n) in the number of waypoints.
+ *
+ *  The coefficients of a segment are stored as 4 contiguous DoF-sized columns, so evaluation is a Horner pass vectorized across the DoF with no allocation once the output vectors have the right size. They live in an immutable PiecewisePolynomial which `getCore()` shares with TrajectoryEvaluator objects for lock-free sampling from other threads.
+ *
+ *  For path following, `getClosestTime()` finds the time whose position is nearest to a point. The segments are indexed by a SegmentBvh over their Bernstein bounding boxes, built with the spline, and the candidate segments are refined exactly with a Newton iteration on the squared distance. The **Closed Loop** `getDesired()` uses it to return the reference nearest to `currentPos`, warm started from the previous answer and restricted to the projection window around it (see `setProjectionWindow()`).
+ */
+class CubicSplineTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     */
+    CubicSplineTrajectory();
+
+    /*! Initializing constructor. Sets waypoints and builds the spline.
+     *  \param newWptSet a Waypoint Set with strictly increasing times.
+     */
+    CubicSplineTrajectory(const WaypointSet& newWptSet);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~CubicSplineTrajectory();
+
+    /*! Sets the waypoints and computes the spline coefficients.
+     *  \param newWptSet a Waypoint Set of at least two TGL_WPT_VECTOR_XD or TGL_WPT_LGSM_WRENCH waypoints with strictly increasing times.
+     *  \return TGL_OK on success, TGL_ERROR if the waypoints cannot be used (the previous spline is then cleared).
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+    /*! Sets the waypoints and loads the spline coefficients from a cache, or computes and stores them on a miss. An entry whose knot times differ from the waypoint times counts as a miss.
+     *  \param newWptSet a Waypoint Set of at least two TGL_WPT_VECTOR_XD or TGL_WPT_LGSM_WRENCH waypoints with strictly increasing times.
+     *  \param cache the coefficient cache to use
+     *  \return TGL_OK on success, TGL_ERROR if the waypoints cannot be used (the previous spline is then cleared).
+     */
+    TglMessage setWaypoints(const WaypointSet& newWptSet, CoefficientCache& cache);
+
+    /*! Uses an existing cubic spline instead of interpolating waypoints, e.g. one fitted by a SplineFitter. The waypoints of the trajectory become the spline positions at its knots. The core is used as it is, its ends are not clamped.
+     *  \param newCore a non-empty PiecewisePolynomial of order 4
+     *  \return TGL_OK on success, TGL_ERROR if the core cannot be used (the previous spline is then cleared).
+     */
+    TglMessage setCore(std::shared_ptr<const PiecewisePolynomial> newCore);
+
+    /*! Get the number of DoF of the spline.
+     *  \return The spline dimension, 0 if it has not been built.
+     */
+    int getDimension() const;
+
+    /*! Get an estimate of the memory held by the spline, waypoints included.
+     *  \return The size in bytes.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+    /*! Get the immutable core holding the knot times and coefficients. See Trajectory::getCore().
+     *  \return The core, empty if the spline has not been built.
+     */
+    virtual TrajectoryCorePtr getCore() const;
+
+    /*! Finds the time whose position is nearest to a point, over the whole spline.
+     *  \param point the point to project, with the spline dimension
+     *  \param closestTime the time of the nearest position
+     *  \param distance the distance from the point to the nearest position
+     *  \return TGL_OK on success, TGL_ERROR if the spline has not been built or the point has the wrong size.
+     */
+    TglMessage getClosestTime(const Eigen::VectorXd& point, double& closestTime, double& distance);
+
+    /*! Finds the time whose position is nearest to a point, only looking at the segments within a time window around a previous answer. The segment of the previous answer seeds the search, so the query is fast when the point moved little.
+     *  \param point the point to project, with the spline dimension
+     *  \param previousTime the previous answer
+     *  \param timeWindow the half width of the time window to search, infinity for the whole spline
+     *  \param closestTime the time of the nearest position
+     *  \param distance the distance from the point to the nearest position
+     *  \return TGL_OK on success, TGL_ERROR if the spline has not been built or the point has the wrong size.
+     */
+    TglMessage getClosestTimeNear(const Eigen::VectorXd& point, const double previousTime, const double timeWindow, double& closestTime, double& distance);
+
+    /*! Sets the half width of the time window searched by the **Closed Loop** `getDesired()` around its previous answer. Keeping it small stops the reference from jumping to another part of a path which crosses itself.
+     *  \param newProjectionWindow the half width of the time window, infinity (the default) for the whole spline.
+     */
+    void setProjectionWindow(const double newProjectionWindow);
+
+    /*! Verifies velocity, acceleration and jerk limits exactly from the coefficients, see PiecewisePolynomial::verifyLimits(). On each segment the velocity is a quadratic whose extremum is at the root of the (linear) acceleration, the acceleration is extremal at the segment ends and the jerk is constant, so the worst values are found without sampling.
+     *  \param maxVel the velocity limits on the absolute values, one per DoF, or an empty vector to skip velocities
+     *  \param maxAcc the acceleration limits, or an empty vector to skip accelerations
+     *  \param maxJerk the jerk limits, or an empty vector to skip jerks
+     *  \param violations the worst violation for each violated DoF and derivative, sorted from the largest to the smallest value/limit ratio
+     *  \return TGL_OK if all the limits are respected, TGL_WARNING if some are violated and TGL_ERROR if the spline has not been built or the limits have the wrong size.
+     */
+    TglMessage verifyLimits(const Eigen::VectorXd& maxVel,
+                            const Eigen::VectorXd& maxAcc,
+                            const Eigen::VectorXd& maxJerk,
+                            std::vector<TglLimitViolation>& violations) const;
+
+protected:
+
+    /*! Open loop implementation. Returns the position, velocity and acceleration of the spline.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+    /*! Closed loop implementation. Returns the reference at the time nearest to currentPos, `time_step` is not used.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const Eigen::VectorXd& currentPos,
+                                                const Eigen::VectorXd& currentVel,
+                                                const Eigen::VectorXd& currentAcc,
+                                                const double time_step);
+
+    /*! Evaluates the spline. Outside of the waypoint times the first or last waypoint is held with zero derivatives.
+     *  \param time the time at which to evaluate
+     *  \param pos the resulting position, resized if needed
+     *  \param vel the resulting velocity, resized if needed
+     *  \param acc the resulting acceleration, resized if needed
+     *  \return TGL_START before the first waypoint time, TGL_RUNNING during the motion, TGL_FINISHED after the last waypoint time and TGL_ERROR if the spline has not been built.
+     */
+    TglMessage evaluate(const double time, Eigen::VectorXd& pos, Eigen::VectorXd& vel, Eigen::VectorXd& acc);
+
+    /*! Checks whether a waypoint type can be used by this trajectory. Derived classes can restrict the types.
+     *  \param wptType the type of the waypoints
+     *  \return true if the type is supported.
+     */
+    virtual bool supportsWaypointType(TglWaypointType wptType) const;
+
+private:
+
+    /*! The exact distance from a point to a segment, by Newton iterations on the squared distance started from the best of a few samples.
+     *  \param segment the segment index
+     *  \param point the point to project
+     *  \param localTime the local time of the nearest position on the segment
+     *  \return The distance.
+     */
+    double getSegmentDistance(const int segment, const Eigen::VectorXd& point, double& localTime) const;
+
+    /*! Builds the bounding volume hierarchy of the segments from the coefficients.
+     */
+    void buildBoundingVolumes();
+
+    std::shared_ptr<const PiecewisePolynomial> core;     /*!< The waypoint times and the spline coefficients, segment i occupies columns 4i to 4i+3 (c0 to c3). Never null, empty before the spline is built. */
+    int segmentCursor;              /*!< The last segment used, the starting point of the next segment search. */
+    SegmentBvh segmentBvh;          /*!< The bounding volume hierarchy over the segment positions. */
+    double projectionWindow;        /*!< The half width of the time window searched by the closed loop getDesired(). */
+    double lastProjectionTime;      /*!< The previous answer of the closed loop getDesired(). */
+};
+
+} // end of namespace tgl
+#endif // TGL_CUBICSPLINETRAJECTORY_H
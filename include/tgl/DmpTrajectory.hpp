@@ -0,0 +1,204 @@
+/*! \file       DmpTrajectory.hpp
+ *  \brief      A dynamic movement primitive learned from a demonstration.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_DMPTRAJECTORY_H
+#define TGL_DMPTRAJECTORY_H
+
+// STL includes
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+
+#ifndef TGL_DMP_INTEGRATION_STEP /*!< The default fixed time step of the DMP integrator, in seconds. */
+#define TGL_DMP_INTEGRATION_STEP 0.001
+#endif
+
+namespace tgl
+{
+
+/*! \class DmpTrajectory
+ *  \brief A discrete dynamic movement primitive (DMP) which reproduces a demonstration and generalizes it to new goals and durations.
+ *
+ *  Each DoF follows a critically damped spring towards the goal \f$ g \f$, driven by a learned forcing term which vanishes with the phase \f$ s \f$:
+    \f[
+        \tau \dot{s} = -\alpha_s s, \qquad
+        \tau \dot{z} = \alpha_z \left( \beta_z (g - y) - z \right) + k \, f(s), \qquad
+        \tau \dot{y} = z, \qquad
+        f(s) = \frac{\sum_i \psi_i(s) w_i}{\sum_i \psi_i(s)} s
+    \f]
+ *  with Gaussian basis functions \f$ \psi_i \f$ spread evenly in time and \f$ k = (g - y_0) / (g_{demo} - y_{0,demo}) \f$ per DoF (1 where the demonstration does not move), so the shape scales with the new amplitude.
+ *
+ *  `setWaypoints()` learns the weights of all the DoF at once: the demonstration derivatives are taken by finite differences over the waypoint columns, and one regularized least-squares system over the basis functions is solved for every DoF with a single factorization. The demonstration is best recorded densely, the number of waypoints bounds the detail the forcing term can learn.
+ *
+ *  The rollout integrates the phase exactly and the spring with a semi-implicit Euler step of fixed size. The state is kept between calls, so an increasing time only costs the steps since the previous call, and `setGoal()` and `setDuration()` take effect at the next step without relearning or restarting: the motion bends smoothly towards the new goal. Asking for an earlier time restarts from the first waypoint. `rollout()` integrates many goal variants at once from the start, in parallel.
+ */
+class DmpTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     *  \param newNumberOfBasisFunctions the number of basis functions of the forcing term
+     */
+    DmpTrajectory(const int newNumberOfBasisFunctions=30);
+
+    /*! Initializing constructor. Learns from a demonstration.
+     *  \param newWptSet the demonstration, see `setWaypoints()`
+     *  \param newNumberOfBasisFunctions the number of basis functions of the forcing term
+     */
+    DmpTrajectory(const WaypointSet& newWptSet, const int newNumberOfBasisFunctions=30);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~DmpTrajectory();
+
+    /*! Learns the forcing term from a demonstration. The start and goal become the first and last waypoints, the duration is the demonstration duration and the rollouts start with the demonstration start velocity.
+     *  \param newWptSet a Waypoint Set of at least 3 TGL_WPT_VECTOR_XD waypoints with strictly increasing times.
+     *  \return TGL_OK on success, TGL_ERROR if the waypoints cannot be used (the previous primitive is then cleared).
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+    /*! Changes the goal. Takes effect from the next integration step, the current motion is not restarted.
+     *  \param newGoal the goal, with the primitive dimension
+     *  \return TGL_OK on success, TGL_ERROR if the dimension does not match.
+     */
+    TglMessage setGoal(const Eigen::VectorXd& newGoal);
+
+    /*! Get the goal.
+     *  \return The goal.
+     */
+    const Eigen::VectorXd& getGoal() const;
+
+    /*! Changes the duration \f$ \tau \f$, which scales the speed of the whole motion. Takes effect from the next integration step, the current motion is not restarted.
+     *  \param newDuration the positive duration
+     *  \return TGL_OK on success, TGL_ERROR if it is not positive.
+     */
+    TglMessage setDuration(const double newDuration);
+
+    /*! Get the duration. The motion is considered finished one duration after the first waypoint time.
+     *  \return The duration.
+     */
+    double getDuration() const;
+
+    /*! Sets the fixed step of the integrator. Also restarts the motion.
+     *  \param newIntegrationStep the positive time step
+     *  \return TGL_OK on success, TGL_ERROR if it is not positive.
+     */
+    TglMessage setIntegrationStep(const double newIntegrationStep);
+
+    /*! Get the number of DoF of the primitive.
+     *  \return The dimension, 0 if nothing has been learned.
+     */
+    int getDimension() const;
+
+    /*! Get the learned weights of the forcing term.
+     *  \return The weights, one row per DoF and one column per basis function.
+     */
+    const Eigen::MatrixXd& getWeights() const;
+
+    /*! Rolls out the primitive from the start for several goals, in parallel, with the current duration. The online state is not touched.
+     *  \param goals the goals, one column per rollout
+     *  \param timeStep the time between two returned positions
+     *  \param positions the positions of each rollout, one column per time from the first waypoint time to one duration later
+     *  \return TGL_OK on success, TGL_ERROR if nothing has been learned, the goals have the wrong dimension or the time step is not positive.
+     */
+    TglMessage rollout(const Eigen::MatrixXd& goals, const double timeStep, std::vector<Eigen::MatrixXd>& positions) const;
+
+    /*! Get an estimate of the memory held by the primitive, waypoints included.
+     *  \return The size in bytes.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+protected:
+
+    /*! Open loop implementation. Integrates the primitive up to the time and returns its state.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    /*! The integrated state of a rollout.
+     */
+    struct State {
+        double time;                /*!< The time of the state. */
+        double phase;               /*!< The phase s, from 1 to 0. */
+        Eigen::VectorXd pos;        /*!< The position y. */
+        Eigen::VectorXd z;          /*!< The scaled velocity z = tau * dy/dt. */
+        Eigen::VectorXd acc;        /*!< The acceleration of the last step. */
+    };
+
+    /*! Resets a state to the start, with the start velocity of the demonstration.
+     *  \param newState the state to reset
+     */
+    void startState(State& newState) const;
+
+    /*! Integrates a state by one step.
+     *  \param currentState the state to integrate
+     *  \param stepGoal the goal
+     *  \param scale the forcing term scale k of each DoF for this goal
+     *  \param dt the step size
+     *  \param work a work vector of the dimension, to avoid allocations
+     */
+    void step(State& currentState, const Eigen::VectorXd& stepGoal, const Eigen::VectorXd& scale, const double dt, Eigen::VectorXd& work) const;
+
+    /*! Integrates a state with fixed steps up to the last grid time before a time. See `step()` for the parameters.
+     */
+    void integrateTo(State& currentState, const Eigen::VectorXd& stepGoal, const Eigen::VectorXd& scale, const double time, Eigen::VectorXd& work) const;
+
+    /*! Computes the forcing term scale k for a goal.
+     *  \param newGoal the goal
+     *  \param scale the scale of each DoF
+     */
+    void computeAmplitudeScale(const Eigen::VectorXd& newGoal, Eigen::VectorXd& scale) const;
+
+    int nBasis;                     /*!< The number of basis functions. */
+    Eigen::VectorXd centers;        /*!< The basis function centers in phase. */
+    Eigen::VectorXd widths;         /*!< The basis function widths h_i, psi_i(s) = exp(-h_i (s - c_i)^2). */
+    Eigen::MatrixXd weights;        /*!< The forcing term weights, one row per DoF. */
+    Eigen::VectorXd start;          /*!< The start position y0. */
+    Eigen::VectorXd startVelocity;  /*!< The start velocity of the demonstration, usually zero. */
+    Eigen::VectorXd goal;           /*!< The goal g. */
+    Eigen::VectorXd demoAmplitude;  /*!< The demonstration goal minus start. */
+    Eigen::VectorXd amplitudeScale; /*!< The forcing term scale k for the current goal. */
+    double startTime;               /*!< The first waypoint time, where the motion starts. */
+    double duration;                /*!< The duration tau. */
+    double integrationStep;         /*!< The fixed integrator step. */
+    State state;                    /*!< The online state, always on the step grid. */
+    State outputState;              /*!< The online state advanced to the asked time, which may be off the grid. */
+    Eigen::VectorXd forcing;        /*!< Work vector of the online rollout. */
+};
+
+} // end of namespace tgl
+#endif // TGL_DMPTRAJECTORY_H
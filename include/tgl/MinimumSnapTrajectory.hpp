@@ -0,0 +1,165 @@
+/*! \file       MinimumSnapTrajectory.hpp
+ *  \brief      A minimum snap (or jerk) piecewise polynomial trajectory through a Waypoint Set.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_MINIMUMSNAPTRAJECTORY_H
+#define TGL_MINIMUMSNAPTRAJECTORY_H
+
+// STL includes
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+#include "tgl/PiecewisePolynomial.hpp"
+#include "tgl/CoefficientCache.hpp"
+
+namespace tgl
+{
+
+/*! \class MinimumSnapTrajectory
+ *  \brief A piecewise polynomial trajectory through the waypoints which minimizes the integral of a squared derivative.
+ *
+ *  For a minimized derivative order \f$ r \f$ (3 for jerk, 4 for snap) each segment is a polynomial of degree \f$ 2r - 1 \f$ and the trajectory solves, for each DoF,
+    \f[
+        \min \sum_i \int_{t_i}^{t_{i+1}} \left( p^{(r)}(t) \right)^2 dt
+        \quad \text{s.t.} \quad p(t_i) = w_i, \quad p^{(j)} \text{ continuous for } j < r, \quad p^{(j)}(t_0) = p^{(j)}(t_n) = 0 \text{ for } 0 < j < r
+    \f]
+ *  The optimum is then \f$ C^{2r-2} \f$ at the waypoints. The KKT system is assembled with Eigen Sparse with the unknowns of each segment followed by the multipliers of its constraints, so the matrix is banded with a bandwidth independent of the number of waypoints and the sparse LU solve is O(n). The matrix only depends on the segment times, so it is factorized once and the per-DoF right-hand sides are solved in parallel.
+ *
+ *  The segment times are the waypoint times, or given explicitly with the second `setWaypoints()` to allocate time per segment. Coefficients are stored per segment as \f$ 2r \f$ contiguous DoF-sized columns in the local time \f$ \delta = t - t_i \f$, like the CubicSplineTrajectory.
+ */
+class MinimumSnapTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Minimizes the snap.
+     *  \param newMinimizedDerivative the derivative order whose squared integral is minimized, 3 for jerk and 4 for snap (from 2 to 6)
+     */
+    MinimumSnapTrajectory(const int newMinimizedDerivative=4);
+
+    /*! Initializing constructor. Sets waypoints and solves for the trajectory.
+     *  \param newWptSet a Waypoint Set of TGL_WPT_VECTOR_XD waypoints with strictly increasing times.
+     *  \param newMinimizedDerivative the derivative order whose squared integral is minimized
+     */
+    MinimumSnapTrajectory(const WaypointSet& newWptSet, const int newMinimizedDerivative=4);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~MinimumSnapTrajectory();
+
+    /*! Sets the waypoints and solves for the trajectory, with the segment times of the waypoints.
+     *  \param newWptSet a Waypoint Set of at least two TGL_WPT_VECTOR_XD waypoints with strictly increasing times.
+     *  \return TGL_OK on success, TGL_ERROR if the waypoints cannot be used or the solve fails (the previous trajectory is then cleared).
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+    /*! Sets the waypoints and solves for the trajectory with given segment durations. The waypoint times are ignored except for the first one, where the trajectory starts.
+     *  \param newWptSet a Waypoint Set of at least two TGL_WPT_VECTOR_XD waypoints.
+     *  \param segmentDurations the positive durations of the n - 1 segments.
+     *  \return TGL_OK on success, TGL_ERROR otherwise (the previous trajectory is then cleared).
+     */
+    TglMessage setWaypoints(const WaypointSet& newWptSet, const Eigen::VectorXd& segmentDurations);
+
+    /*! Sets the waypoints and loads the coefficients from a cache, or solves and stores them on a miss. An entry whose knot times differ from the waypoint times counts as a miss. Uses the segment times of the waypoints and the minimized derivative is part of the cache key.
+     *  \param newWptSet a Waypoint Set of at least two TGL_WPT_VECTOR_XD waypoints with strictly increasing times
+     *  \param cache the coefficient cache to use
+     *  \return TGL_OK on success, TGL_ERROR if the waypoints cannot be used or the solve fails.
+     */
+    TglMessage setWaypoints(const WaypointSet& newWptSet, CoefficientCache& cache);
+
+    /*! Get the derivative order whose squared integral is minimized.
+     *  \return The derivative order.
+     */
+    int getMinimizedDerivative() const;
+
+    /*! Get the optimal cost, summed over the DoF.
+     *  \return The integral of the squared minimized derivative.
+     */
+    double getCost() const;
+
+    /*! Get the number of DoF of the trajectory.
+     *  \return The dimension, 0 if the trajectory has not been built.
+     */
+    int getDimension() const;
+
+    /*! Get an estimate of the memory held by the trajectory, waypoints included.
+     *  \return The size in bytes.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+    /*! Get the immutable core holding the segment times and coefficients. See Trajectory::getCore().
+     *  \return The core, empty if the trajectory has not been built.
+     */
+    virtual TrajectoryCorePtr getCore() const;
+
+    /*! Verifies velocity, acceleration and jerk limits exactly from the coefficients, see PiecewisePolynomial::verifyLimits().
+     *  \param maxVel the velocity limits on the absolute values, one per DoF, or an empty vector to skip velocities
+     *  \param maxAcc the acceleration limits, or an empty vector to skip accelerations
+     *  \param maxJerk the jerk limits, or an empty vector to skip jerks
+     *  \param violations the worst violation for each violated DoF and derivative, sorted from the largest to the smallest value/limit ratio
+     *  \return TGL_OK if all the limits are respected, TGL_WARNING if some are violated and TGL_ERROR if the trajectory has not been built or the limits have the wrong size.
+     */
+    TglMessage verifyLimits(const Eigen::VectorXd& maxVel,
+                            const Eigen::VectorXd& maxAcc,
+                            const Eigen::VectorXd& maxJerk,
+                            std::vector<TglLimitViolation>& violations) const;
+
+protected:
+
+    /*! Open loop implementation. Returns the position, velocity and acceleration of the polynomials.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    /*! Assembles the KKT system, factorizes it once, solves it for every DoF and sets the core.
+     *  \param wpts the waypoint positions, one column per waypoint
+     *  \param knotTimes the segment times, one per waypoint
+     *  \return TGL_OK on success, TGL_ERROR if the factorization fails.
+     */
+    TglMessage solve(const Eigen::MatrixXd& wpts, const StdDoubleVector& knotTimes);
+
+    /*! Computes the cost of the current coefficients, used when they come from a cache.
+     */
+    void computeCost();
+
+    int minimizedDerivative;        /*!< The derivative order whose squared integral is minimized, the polynomials have 2 * minimizedDerivative coefficients. */
+    std::shared_ptr<const PiecewisePolynomial> core;     /*!< The segment times and the polynomial coefficients, segment i occupies the 2 * minimizedDerivative columns from 2 * minimizedDerivative * i. Never null. */
+    double cost;                    /*!< The optimal cost summed over the DoF. */
+    int segmentCursor;              /*!< The last segment used, the starting point of the next segment search. */
+};
+
+} // end of namespace tgl
+#endif // TGL_MINIMUMSNAPTRAJECTORY_H
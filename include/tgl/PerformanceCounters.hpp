@@ -0,0 +1,196 @@
+/*! \file       PerformanceCounters.hpp
+ *  \brief      Cheap counters of the work done by trajectories and waypoint sets, and their export.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_PERFORMANCECOUNTERS_H
+#define TGL_PERFORMANCECOUNTERS_H
+
+// STL includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// TGL includes
+#include "tgl/TglTypes.hpp"
+
+#ifndef TGL_ENABLE_METRICS /*!< Set to 0 to compile the counting out, the counters then stay at zero. */
+#define TGL_ENABLE_METRICS 1
+#endif
+
+#ifndef TGL_METRICS_LATENCY_PERIOD /*!< One evaluation in this many is timed for the last evaluation latency, reading the clock costs more than the rest of the counting. */
+#define TGL_METRICS_LATENCY_PERIOD 64
+#endif
+
+namespace tgl
+{
+
+/*! \class PerformanceCounters
+ *  \brief Cheap counters of the work done by a trajectory or a waypoint set.
+ *
+ *  Every Trajectory and WaypointSet owns one and updates it as it works: evaluations, segment lookups answered from the cursor (hits) or by a search (misses), rebuilds with the time they took and the bytes they allocated, and the latency of the last timed evaluation (one in TGL_METRICS_LATENCY_PERIOD). All the counters are relaxed atomics, so updating them costs a few uncontended atomic additions and never blocks, and `getSnapshot()` can be called from any thread while the owner runs. The values of a snapshot are each exact but not taken at the same instant.
+ *
+ *  Counters describe the object which owns them: copying or assigning the owner does not carry them over. Counters which do not apply to an owner stay at zero.
+ *
+ *  `writePrometheus()` formats snapshots in the Prometheus text exposition format, one `object` label per snapshot, and `writePrometheusFile()` writes them to a file which is replaced atomically, e.g. for the textfile collector of the node exporter:
+    ~~~~~~~~~~~~~~{.cpp}
+    tgl::PerformanceCounters::NamedSnapshots snapshots;
+    snapshots.push_back(std::make_pair("left_arm", leftArmTrajectory.getPerformanceSnapshot()));
+    snapshots.push_back(std::make_pair("right_arm", rightArmTrajectory.getPerformanceSnapshot()));
+    tgl::PerformanceCounters::writePrometheusFile("/var/lib/node_exporter/tgl.prom", snapshots);
+    ~~~~~~~~~~~~~~
+ */
+class PerformanceCounters {
+public:
+
+    using Clock = std::chrono::steady_clock;    /*!< The clock of the timings. */
+
+    /*! A snapshot of the counters.
+     */
+    struct Snapshot {
+        uint64_t evaluations;           /*!< The number of evaluations. */
+        uint64_t segmentHits;           /*!< The number of segment lookups answered by the current or next segment of the cursor. */
+        uint64_t segmentMisses;         /*!< The number of segment lookups which needed a search. */
+        uint64_t rebuilds;              /*!< The number of successful rebuilds. */
+        uint64_t allocatedBytes;        /*!< The bytes held after each rebuild, summed over the rebuilds. */
+        double totalBuildTime;          /*!< The time spent in rebuilds, in seconds. */
+        double lastBuildTime;           /*!< The time the last rebuild took, in seconds. */
+        double lastEvaluationLatency;   /*!< The time the last timed evaluation took, in seconds. */
+    };
+
+    using NamedSnapshots = std::vector<std::pair<std::string, Snapshot>>;   /*!< Snapshots with the name of the object they come from. */
+
+    /*! Basic constructor. All the counters are zero.
+     */
+    PerformanceCounters();
+
+    /*! Copy constructor. The counters of the copy start at zero.
+     */
+    PerformanceCounters(const PerformanceCounters& other);
+
+    /*! Assignment. Keeps the counters of this object.
+     */
+    PerformanceCounters& operator=(const PerformanceCounters& other);
+
+    /*! Get the current time, to be passed to `countEvaluation()` or `countRebuild()`. Does not read the clock if the metrics are compiled out.
+     *  \return The current time.
+     */
+    static Clock::time_point now();
+
+    /*! Get the start time of an evaluation, to be passed to `countEvaluation()`. Only reads the clock for the evaluations which are timed.
+     *  \return The current time, or a default time point if this evaluation is not timed.
+     */
+    Clock::time_point startEvaluation() const;
+
+    /*! Counts evaluations, and their latency if they were timed. A batch records the mean latency of its evaluations.
+     *  \param start the time at which they started, from `now()` or `startEvaluation()`, a default time point if they were not timed
+     *  \param count the number of evaluations done in that time
+     */
+    void countEvaluation(const Clock::time_point& start, const uint64_t count=1);
+
+    /*! Counts a segment lookup.
+     *  \param previousSegment the segment of the cursor before the lookup
+     *  \param segment the segment found
+     */
+    void countSegmentLookup(const int previousSegment, const int segment);
+
+    /*! Counts a successful rebuild.
+     *  \param start the time at which it started, from `now()`
+     *  \param bytes the bytes held after the rebuild
+     */
+    void countRebuild(const Clock::time_point& start, const std::size_t bytes);
+
+    /*! Get a snapshot of the counters.
+     *  \return The snapshot.
+     */
+    Snapshot getSnapshot() const;
+
+    /*! Sets all the counters to zero.
+     */
+    void reset();
+
+    /*! Writes snapshots in the Prometheus text exposition format.
+     *  \param stream the stream to write
+     *  \param snapshots the snapshots, with the name used as the `object` label
+     */
+    static void writePrometheus(std::ostream& stream, const NamedSnapshots& snapshots);
+
+    /*! Writes snapshots in the Prometheus text exposition format to a file. The file is written next to its destination then renamed, so readers never see it half written.
+     *  \param filename the file to write
+     *  \param snapshots the snapshots, with the name used as the `object` label
+     *  \return TGL_OK on success, TGL_ERROR if the file cannot be written.
+     */
+    static TglMessage writePrometheusFile(const std::string& filename, const NamedSnapshots& snapshots);
+
+private:
+
+    std::atomic<uint64_t> evaluations;              /*!< The number of evaluations. */
+    std::atomic<uint64_t> segmentHits;              /*!< The number of segment lookups answered from the cursor. */
+    std::atomic<uint64_t> segmentMisses;            /*!< The number of segment lookups which needed a search. */
+    std::atomic<uint64_t> rebuilds;                 /*!< The number of rebuilds. */
+    std::atomic<uint64_t> allocatedBytes;           /*!< The bytes held after each rebuild, summed. */
+    std::atomic<uint64_t> totalBuildNanoseconds;    /*!< The time spent in rebuilds. */
+    std::atomic<uint64_t> lastBuildNanoseconds;     /*!< The time the last rebuild took. */
+    std::atomic<uint64_t> lastLatencyNanoseconds;   /*!< The time the last timed evaluation took, averaged over its batch. */
+};
+
+inline PerformanceCounters::Clock::time_point PerformanceCounters::now()
+{
+    return TGL_ENABLE_METRICS ? Clock::now() : Clock::time_point();
+}
+
+inline PerformanceCounters::Clock::time_point PerformanceCounters::startEvaluation() const
+{
+    if (TGL_ENABLE_METRICS && evaluations.load(std::memory_order_relaxed) % TGL_METRICS_LATENCY_PERIOD == 0) {
+        return Clock::now();
+    }
+    return Clock::time_point();
+}
+
+inline void PerformanceCounters::countEvaluation(const Clock::time_point& start, const uint64_t count)
+{
+    if (TGL_ENABLE_METRICS) {
+        evaluations.fetch_add(count, std::memory_order_relaxed);
+        if (start != Clock::time_point() && count > 0) {
+            lastLatencyNanoseconds.store(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / count, std::memory_order_relaxed);
+        }
+    }
+}
+
+inline void PerformanceCounters::countSegmentLookup(const int previousSegment, const int segment)
+{
+    if (TGL_ENABLE_METRICS) {
+        const bool hit = segment == previousSegment || segment == previousSegment + 1;
+        (hit ? segmentHits : segmentMisses).fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // end of namespace tgl
+#endif // TGL_PERFORMANCECOUNTERS_H
@@ -0,0 +1,202 @@
+/*! \file       PiecewisePolynomial.hpp
+ *  \brief      A piecewise polynomial container shared by the polynomial trajectories.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_PIECEWISEPOLYNOMIAL_H
+#define TGL_PIECEWISEPOLYNOMIAL_H
+
+// STL includes
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/TrajectoryCore.hpp"
+
+#ifndef TGL_BATCH_SORT_BYTES /*!< The size of the coefficients above which evaluateBatch() groups the times by segment instead of following their order. */
+#define TGL_BATCH_SORT_BYTES 4194304
+#endif
+
+#ifndef TGL_BATCH_CHUNK_SIZE /*!< The number of samples per thread above which evaluateBatch() runs in parallel. */
+#define TGL_BATCH_CHUNK_SIZE 32768
+#endif
+
+#ifndef TGL_SERIALIZED_MAX_ORDER /*!< The highest polynomial order deserialize() accepts. */
+#define TGL_SERIALIZED_MAX_ORDER 64
+#endif
+
+#ifndef TGL_SERIALIZED_MAX_BYTES /*!< The largest data size deserialize() allocates for, 1 GiB. */
+#define TGL_SERIALIZED_MAX_BYTES 1073741824ULL
+#endif
+
+namespace tgl
+{
+
+/*! \class PiecewisePolynomial
+ *  \brief An immutable piecewise polynomial, the trajectory core of the polynomial generators.
+ *
+ *  Segment i spans [knotTimes[i], knotTimes[i+1]] and is a polynomial with `order` coefficients in the local time \f$ \delta = t - t_i \f$, stored as `order` contiguous DoF-sized columns starting at column `order * i`. The DoF are innermost, so one Horner pass over the columns of a segment gives the position, velocity and acceleration of all the DoF with vector instructions. The CubicSplineTrajectory (order 4), the MinimumSnapTrajectory (order 2r) and the SplineFitter keep their results in one, and any generator which produces one can be evaluated through a PolynomialTrajectory, a TrajectoryEvaluator or a PolynomialKernel.
+ *
+ *  The cubic, quintic and degree 7 orders with up to 7 DoF are evaluated by a PolySegment kernel unrolled at compile time, chosen once at construction and used by `evaluate()` as well as by the batch evaluations. Other sizes use a generic Horner loop.
+ *
+ *  Segment lookup starts from the caller's cursor, so a clock moving forward costs O(1). Random times cost O(1) too when the knots are uniform (within rounding), as with the SplineFitter, and a binary search otherwise.
+ *
+ *  `slice()` extracts a time window as a new polynomial, and `serialize()` / `deserialize()` store one in a portable binary format.
+ */
+class PiecewisePolynomial : public TrajectoryCore {
+public:
+
+    /*! Basic constructor. Makes an empty polynomial.
+     */
+    PiecewisePolynomial();
+
+    /*! Initializing constructor. Takes the data over, pass temporaries or use std::move to avoid copies.
+     *  \param newKnotTimes the increasing segment times, at least 2
+     *  \param newCoefficients the coefficients, order * (knotTimes.size() - 1) columns
+     *  \param newOrder the number of coefficients per segment (polynomial degree + 1)
+     *  If the sizes do not match, an error is logged and the polynomial is empty.
+     */
+    PiecewisePolynomial(StdDoubleVector newKnotTimes, Eigen::MatrixXd newCoefficients, const int newOrder);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~PiecewisePolynomial();
+
+    virtual TglMessage evaluate(Eigen::VectorXd& desiredPos,
+                                Eigen::VectorXd& desiredVel,
+                                Eigen::VectorXd& desiredAcc,
+                                const double time,
+                                int& segmentCursor) const;
+
+    /*! Evaluates the polynomial at many times in any order, with the segment kernels of `evaluateSorted()`. When the coefficients fit in TGL_BATCH_SORT_BYTES they stay in cache, so the times are evaluated in their order, which writes the outputs sequentially, with one kernel call per run of times in the same segment. Larger polynomials would miss the cache on most random times: the times are then bucketed by segment with a counting sort, the kernel runs over each bucket in one go and the results are scattered back in the order of `times`. Segment lookup is O(1) per time with uniform knots, otherwise batches with more times than segments bound each binary search with a uniform grid over the knots. Large batches are split between threads.
+     */
+    virtual TglMessage evaluateBatch(const Eigen::Ref<const Eigen::VectorXd>& times,
+                                     Eigen::MatrixXd& positions,
+                                     Eigen::MatrixXd& velocities,
+                                     Eigen::MatrixXd& accelerations) const;
+
+    virtual int getDimension() const;
+
+    virtual double getStartTime() const;
+
+    virtual double getEndTime() const;
+
+    /*! Checks if the polynomial holds a trajectory.
+     *  \return true if there are no segments.
+     */
+    bool empty() const;
+
+    /*! Get the number of segments.
+     *  \return The number of segments, 0 if empty.
+     */
+    int getNumberOfSegments() const;
+
+    /*! Get the segment times.
+     *  \return The knot times, segment i spans [knotTimes[i], knotTimes[i+1]].
+     */
+    const StdDoubleVector& getKnotTimes() const;
+
+    /*! Get the coefficients.
+     *  \return The coefficients, segment i occupies the `order` columns from `order * i`.
+     */
+    const Eigen::MatrixXd& getCoefficients() const;
+
+    /*! Get the number of coefficients per segment.
+     *  \return The order.
+     */
+    int getOrder() const;
+
+    /*! Evaluates the polynomial at many increasing times. The samples are processed segment by segment: the kernel chosen at construction runs over all the samples of a segment in one go. Times out of bounds follow the `evaluate()` conventions.
+     *  \param times the non-decreasing times
+     *  \param positions the positions, one column per time
+     *  \param velocities the velocities, one column per time
+     *  \param accelerations the accelerations, one column per time
+     *  \return TGL_OK on success, TGL_ERROR if the polynomial is empty or the times are not sorted.
+     */
+    TglMessage evaluateSorted(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::MatrixXd& positions, Eigen::MatrixXd& velocities, Eigen::MatrixXd& accelerations) const;
+
+    /*! Finds the segment which contains a time, see TrajectoryCore::findSegment(). Uses the knot spacing directly when the knots are uniform.
+     *  \param time the time to look up, clamped to the first or last segment if out of bounds
+     *  \param segmentCursor the previously used segment, updated with the result
+     *  \return The segment index.
+     */
+    int findSegment(const double time, int& segmentCursor) const;
+
+    /*! Verifies velocity, acceleration and jerk limits exactly from the coefficients, for any order. On a segment a derivative is extremal at the segment ends or at a root of the next derivative. The roots are found from the highest derivative down: between two consecutive roots of a derivative the one below is monotonic, so each interval brackets at most one of its roots, refined by safeguarded Newton steps. No sampling is involved. Segments are processed in parallel.
+     *  \param maxVel the velocity limits on the absolute values, one per DoF, or an empty vector to skip velocities
+     *  \param maxAcc the acceleration limits, or an empty vector to skip accelerations
+     *  \param maxJerk the jerk limits, or an empty vector to skip jerks
+     *  \param violations the worst violation for each violated DoF and derivative, sorted from the largest to the smallest value/limit ratio
+     *  \return TGL_OK if all the limits are respected, TGL_WARNING if some are violated and TGL_ERROR if the polynomial is empty or the limits have the wrong size.
+     */
+    TglMessage verifyLimits(const Eigen::VectorXd& maxVel,
+                            const Eigen::VectorXd& maxAcc,
+                            const Eigen::VectorXd& maxJerk,
+                            std::vector<TglLimitViolation>& violations) const;
+
+    /*! Extracts the part of the polynomial between two times. The segments which overlap the window are copied, and the first one is re-expanded around the window start, so the slice evaluates like the original over the window.
+     *  \param sliceStartTime the start of the window
+     *  \param sliceEndTime the end of the window, greater than the start
+     *  \param sliced the polynomial of the window
+     *  \return TGL_OK on success, TGL_ERROR if the polynomial is empty or the window is not within its times.
+     */
+    TglMessage slice(const double sliceStartTime, const double sliceEndTime, std::shared_ptr<const PiecewisePolynomial>& sliced) const;
+
+    /*! Writes the polynomial to a binary stream: a small header with the sizes and byte order, the data and a checksum.
+     *  \param stream the stream to write, opened in binary mode
+     *  \return TGL_OK on success, TGL_ERROR if the polynomial is empty or the stream fails.
+     */
+    TglMessage serialize(std::ostream& stream) const;
+
+    /*! Reads a polynomial written by `serialize()`. The sizes in the header are checked before anything is allocated: the order against TGL_SERIALIZED_MAX_ORDER, the data size against TGL_SERIALIZED_MAX_BYTES and, on a seekable stream, against the bytes left in it.
+     *  \param stream the stream to read, opened in binary mode
+     *  \param polynomial the polynomial read
+     *  \return TGL_OK on success, TGL_ERROR if the stream fails, does not hold a valid polynomial or the memory can not be allocated.
+     */
+    static TglMessage deserialize(std::istream& stream, std::shared_ptr<const PiecewisePolynomial>& polynomial);
+
+    /*! Get the memory held by the data.
+     *  \return The size in bytes.
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+
+    StdDoubleVector knotTimes;      /*!< The segment times. */
+    Eigen::MatrixXd coefficients;   /*!< The polynomial coefficients. */
+    int order;                      /*!< The number of coefficients per segment. */
+    double uniformStep;             /*!< The knot spacing if the knots are uniform, 0 otherwise. */
+    void (*segmentKernel)(const double*, const double*, const int, double*, double*, double*);  /*!< The unrolled PolySegment kernel of the order and dimension, null if there is none. */
+};
+
+} // end of namespace tgl
+#endif // TGL_PIECEWISEPOLYNOMIAL_H
@@ -0,0 +1,139 @@
+/*! \file       PolySegment.hpp
+ *  \brief      Polynomial segment kernels unrolled for a compile-time order and number of DoF.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_POLYSEGMENT_H
+#define TGL_POLYSEGMENT_H
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTypes.hpp"
+
+#ifndef TGL_FLATTEN /*!< Inlines everything a segment kernel calls, Eigen's fixed-size assignment loops included, which GCC otherwise leaves as calls in a unit with many kernels. */
+#if defined(__GNUC__)
+#define TGL_FLATTEN __attribute__((flatten))
+#else
+#define TGL_FLATTEN
+#endif
+#endif
+
+namespace tgl
+{
+
+/*! The factor brought by differentiating \f$ \delta^k \f$ d times, k! / (k - d)!, 0 when d > k. Evaluated at compile time in the segment kernels.
+ *  \param k the power
+ *  \param d the derivative order
+ *  \return The falling factorial.
+ */
+constexpr double polyDerivativeFactor(const int k, const int d)
+{
+    return d == 0 ? 1.0 : (k <= 0 ? 0.0 : k * polyDerivativeFactor(k - 1, d - 1));
+}
+
+/*! One Horner step of a PolySegment on coefficient K, followed by the steps on the lower coefficients. The recursion is resolved at compile time, so the loop is fully unrolled.
+ */
+template<int Order, int Dof, int K>
+struct PolySegmentStep {
+    template<typename Coefficients, typename Vector>
+    static inline void run(const Coefficients& c, const double dt, Vector& pos, Vector& vel, Vector& acc)
+    {
+        if (K >= 2) {
+            acc = dt * acc + polyDerivativeFactor(K, 2) * c.col(K);
+        }
+        vel = dt * vel + polyDerivativeFactor(K, 1) * c.col(K);
+        pos = dt * pos + c.col(K - 1);
+        PolySegmentStep<Order, Dof, K - 1>::run(c, dt, pos, vel, acc);
+    }
+};
+
+/*! The end of the PolySegmentStep recursion.
+ */
+template<int Order, int Dof>
+struct PolySegmentStep<Order, Dof, 0> {
+    template<typename Coefficients, typename Vector>
+    static inline void run(const Coefficients&, const double, Vector&, Vector&, Vector&)
+    {
+    }
+};
+
+/*! \class PolySegment
+ *  \brief Evaluation of one polynomial segment with the order and the number of DoF known at compile time.
+ *
+ *  The coefficients follow the PiecewisePolynomial layout: `Order` contiguous columns of `Dof` values, for the powers 0 to Order - 1 of the local time. With both sizes fixed, Eigen keeps the vectors in registers and the Horner recursion of PolySegmentStep is unrolled, with the derivative factors as compile-time constants, so there is no loop, size check or allocation left.
+ *
+ *  A PiecewisePolynomial picks the cubic, quintic or degree 7 kernel of its dimension (up to 7 DoF) once, at construction. `PiecewisePolynomial::evaluate()` runs it on the single sample of each control tick, so the `getDesired()` of the polynomial trajectories and TrajectoryEvaluator use it, and the batch evaluations run it over all the samples which fall in a segment.
+ */
+template<int Order, int Dof>
+class PolySegment {
+public:
+
+    static_assert(Order >= 1 && Dof >= 1, "A polynomial segment needs at least one coefficient and one DoF.");
+
+    using Coefficients = Eigen::Matrix<double, Dof, Order>;    /*!< The coefficients of a segment. */
+    using Vector = Eigen::Matrix<double, Dof, 1>;              /*!< A DoF-sized vector. */
+
+    /*! Evaluates the segment at one local time.
+     *  \param c the coefficients of the segment
+     *  \param dt the local time
+     *  \param pos the position
+     *  \param vel the velocity
+     *  \param acc the acceleration
+     */
+    template<typename CoefficientsType>
+    static inline void evaluate(const CoefficientsType& c, const double dt, Vector& pos, Vector& vel, Vector& acc)
+    {
+        pos = c.col(Order - 1);
+        vel.setZero();
+        acc.setZero();
+        PolySegmentStep<Order, Dof, Order - 1>::run(c, dt, pos, vel, acc);
+    }
+
+    /*! Evaluates the segment at several local times, with raw pointers so that it can sit behind a function pointer chosen at run time.
+     *  \param coefficients the Dof x Order coefficients of the segment, column major
+     *  \param localTimes the local times
+     *  \param n the number of local times
+     *  \param pos the positions, Dof values per local time
+     *  \param vel the velocities, Dof values per local time
+     *  \param acc the accelerations, Dof values per local time
+     */
+    TGL_FLATTEN static void evaluateSamples(const double* coefficients, const double* localTimes, const int n, double* pos, double* vel, double* acc)
+    {
+        const Eigen::Map<const Coefficients> c(coefficients);
+        Vector p, v, a;
+        for (int i = 0; i < n; ++i) {
+            evaluate(c, localTimes[i], p, v, a);
+            Eigen::Map<Vector>(pos + Dof * i) = p;
+            Eigen::Map<Vector>(vel + Dof * i) = v;
+            Eigen::Map<Vector>(acc + Dof * i) = a;
+        }
+    }
+};
+
+} // end of namespace tgl
+#endif // TGL_POLYSEGMENT_H
@@ -0,0 +1,126 @@
+/*! \file       PolynomialTrajectory.hpp
+ *  \brief      A trajectory which evaluates a given piecewise polynomial.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_POLYNOMIALTRAJECTORY_H
+#define TGL_POLYNOMIALTRAJECTORY_H
+
+// STL includes
+#include <memory>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+#include "tgl/PiecewisePolynomial.hpp"
+
+namespace tgl
+{
+
+/*! \class PolynomialTrajectory
+ *  \brief A trajectory backed by any PiecewisePolynomial.
+ *
+ *  Generators which produce a PiecewisePolynomial without waypoints to interpolate (a slice of another trajectory, a deserialized polynomial, a fitted spline of any order) are evaluated through this class. The polynomial is shared, not copied. The waypoints of the trajectory are the polynomial positions at its knots, for reference only: `setWaypoints()` is not supported.
+ */
+class PolynomialTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     */
+    PolynomialTrajectory();
+
+    /*! Initializing constructor. See `setPolynomial()`.
+     */
+    PolynomialTrajectory(std::shared_ptr<const PiecewisePolynomial> newPolynomial);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~PolynomialTrajectory();
+
+    /*! Not supported, the trajectory is defined by its polynomial.
+     *  \return TGL_ERROR.
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+    /*! Sets the polynomial to evaluate.
+     *  \param newPolynomial a non-empty piecewise polynomial of any order
+     *  \return TGL_OK on success, TGL_ERROR if it is null or empty (the previous polynomial is then cleared).
+     */
+    TglMessage setPolynomial(std::shared_ptr<const PiecewisePolynomial> newPolynomial);
+
+    /*! Get the polynomial.
+     *  \return The polynomial, empty if none has been set.
+     */
+    std::shared_ptr<const PiecewisePolynomial> getPolynomial() const;
+
+    /*! Get the number of DoF of the trajectory.
+     *  \return The dimension, 0 if no polynomial has been set.
+     */
+    int getDimension() const;
+
+    /*! Get an estimate of the memory held by the trajectory, polynomial included.
+     *  \return The size in bytes.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+    /*! Get the polynomial as a trajectory core. See Trajectory::getCore().
+     *  \return The polynomial.
+     */
+    virtual TrajectoryCorePtr getCore() const;
+
+    /*! Verifies velocity, acceleration and jerk limits exactly from the coefficients, see PiecewisePolynomial::verifyLimits().
+     *  \param maxVel the velocity limits on the absolute values, one per DoF, or an empty vector to skip velocities
+     *  \param maxAcc the acceleration limits, or an empty vector to skip accelerations
+     *  \param maxJerk the jerk limits, or an empty vector to skip jerks
+     *  \param violations the worst violation for each violated DoF and derivative, sorted from the largest to the smallest value/limit ratio
+     *  \return TGL_OK if all the limits are respected, TGL_WARNING if some are violated and TGL_ERROR if the trajectory has not been built or the limits have the wrong size.
+     */
+    TglMessage verifyLimits(const Eigen::VectorXd& maxVel,
+                            const Eigen::VectorXd& maxAcc,
+                            const Eigen::VectorXd& maxJerk,
+                            std::vector<TglLimitViolation>& violations) const;
+
+protected:
+
+    /*! Open loop implementation. Returns the position, velocity and acceleration of the polynomial.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    std::shared_ptr<const PiecewisePolynomial> polynomial;  /*!< The polynomial evaluated. Never null. */
+    int segmentCursor;                                      /*!< The last segment used, the starting point of the next segment search. */
+};
+
+} // end of namespace tgl
+#endif // TGL_POLYNOMIALTRAJECTORY_H
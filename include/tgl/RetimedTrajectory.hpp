@@ -0,0 +1,128 @@
+/*! \file       RetimedTrajectory.hpp
+ *  \brief      A retiming layer applying a live speed override to any trajectory.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_RETIMEDTRAJECTORY_H
+#define TGL_RETIMEDTRAJECTORY_H
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+
+namespace tgl
+{
+/*! \class RetimedTrajectory
+ *  \brief A retiming layer which plays a path at a live speed override.
+ *
+ *  The path is evaluated at the path time \f$ \tau(t) \f$ obtained by integrating the speed scale \f$ s(t) = \dot{\tau} \f$ over the time \f$ t \f$ given to `getDesired()`. The outputs are scaled accordingly,
+    \f[
+        \dot{x} = s \, x'(\tau), \qquad \ddot{x} = s^2 x''(\tau) + \dot{s} \, x'(\tau),
+    \f]
+ *  so the path itself is never rebuilt. When `setSpeedOverride()` is called the scale moves from its current value and rate to the new value along a cubic Hermite ramp of duration \f$ D \f$ which ends with a zero rate,
+    \f[
+        s(u) = s_0 + (s_1 - s_0)(3u^2 - 2u^3) + D \dot{s}_0 \, u (1 - u)^2, \qquad u = (t - t_0) / D,
+    \f]
+ *  starting right away. It is the smoothstep when the scale was steady, and an override given during a ramp continues from the rate of that ramp, so the scale stays \f$ C^1 \f$ and the velocity and the acceleration stay continuous. The only exception is a decreasing scale whose rate would take it below zero, the starting rate is then limited to \f$ -s_0 / D \f$. \f$ \tau \f$ has a closed form so an evaluation costs a few flops on top of the path evaluation.
+ *
+ *  The override times are in the time base of `getDesired()`. The path must implement the **Open Loop** `getDesired()`.
+ */
+class RetimedTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     */
+    RetimedTrajectory();
+
+    /*! Initializing constructor. Plays a path at full speed.
+     *  \param newPath the path to play.
+     */
+    RetimedTrajectory(TrajectoryPtr newPath);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~RetimedTrajectory();
+
+    /*! Sets the path to play and resets the override to full speed, i.e. the path time equals the time.
+     *  \param newPath the path to play.
+     *  \return TGL_OK on success, TGL_ERROR if the path is null.
+     */
+    TglMessage setPath(TrajectoryPtr newPath);
+
+    /*! Changes the speed override. The ramp starts at `time`, from the scale and its rate at that time.
+     *  \param newSpeedScale the target speed scale, 1 for the nominal speed and 0 to stop (must not be negative)
+     *  \param newRampDuration the time to reach the target scale, 0 for an immediate (velocity discontinuous) change
+     *  \param time the time at which the ramp starts. If not given, will default to the internal clock.
+     *  \return TGL_OK on success, TGL_ERROR if the scale or the ramp duration is negative.
+     */
+    TglMessage setSpeedOverride(const double newSpeedScale, const double newRampDuration=0.1, const double time=TGL_USE_INTERNAL_CLOCK);
+
+    /*! Get the speed scale at a given time.
+     *  \param time the time at which to get the scale
+     *  \return The speed scale \f$ s(t) \f$.
+     */
+    double getSpeedScale(const double time) const;
+
+    /*! Get the path time at a given time.
+     *  \param time the time at which to get the path time
+     *  \return The path time \f$ \tau(t) \f$.
+     */
+    double getPathTime(const double time) const;
+
+protected:
+
+    /*! Open loop implementation. Evaluates the path at the path time and scales the derivatives.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    /*! Evaluates the retiming function.
+     *  \param time the time at which to evaluate
+     *  \param pathTime the resulting path time
+     *  \param speedScale the resulting speed scale
+     *  \param speedScaleRate the resulting time derivative of the speed scale
+     */
+    void evaluateRetiming(const double time, double& pathTime, double& speedScale, double& speedScaleRate) const;
+
+    TrajectoryPtr path;         /*!< The path to play. */
+    double rampStartTime;       /*!< The time at which the last ramp started. */
+    double rampStartPathTime;   /*!< The path time at the start of the last ramp. */
+    double rampDuration;        /*!< The duration of the last ramp. */
+    double startSpeedScale;     /*!< The speed scale at the start of the last ramp. */
+    double startSpeedScaleRate; /*!< The time derivative of the speed scale at the start of the last ramp. */
+    double targetSpeedScale;    /*!< The speed scale at the end of the last ramp. */
+};
+
+} // end of namespace tgl
+#endif // TGL_RETIMEDTRAJECTORY_H
@@ -0,0 +1,185 @@
+/*! \file       SampleRange.hpp
+ *  \brief      A lazy range of trajectory samples for streaming output.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_SAMPLERANGE_H
+#define TGL_SAMPLERANGE_H
+
+// STL includes
+#include <cstddef>
+#include <iterator>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTypes.hpp"
+
+namespace tgl
+{
+
+class Trajectory;
+class TrajectoryEvaluator;
+
+/*! A trajectory sample. In a SampleRange it is a view into the buffer of the range, overwritten by the next sample.
+ */
+struct TrajectorySample {
+    double time;                    /*!< The sample time. */
+    TglMessage status;              /*!< The status returned by getDesired() for this sample. */
+    Eigen::VectorXd position;       /*!< The desired position. */
+    Eigen::VectorXd velocity;       /*!< The desired velocity. */
+    Eigen::VectorXd acceleration;   /*!< The desired acceleration. */
+};
+
+/*! \class SampleRange
+ *  \brief A lazy range of trajectory samples for streaming output.
+ *
+ *  Samples are computed one at a time while the range is iterated, at the times \f$ t_0 + k\,dt \f$ up to \f$ t_1 \f$ included (up to rounding), so exporters and publishers can stream trajectories of any length without materializing them:
+    ~~~~~~~~~~~~~~{.cpp}
+    for (const tgl::TrajectorySample& s : traj.samples(0.001, 0.0, 3600.0)) {
+        out << s.time << " " << s.position.transpose() << "\n";
+    }
+    ~~~~~~~~~~~~~~
+ *  The samples are taken at explicit times, so a grid time of exactly -1 is a time like any other and not TGL_USE_INTERNAL_CLOCK, and the internal clock is left alone. Each sample is written into a buffer owned by the range, so there is no allocation per sample once the vectors have the trajectory dimension. The flip side is that a sample reference is only valid until the iterator moves on: copy the sample to keep it. The range is a single pass input range, and it uses the trajectory (or evaluator) it was made from, which must outlive it and must not be used elsewhere while it is iterated.
+ */
+class SampleRange {
+public:
+
+    /*! An input iterator over the samples.
+     */
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;  /*!< Single pass. */
+        using value_type = TrajectorySample;                /*!< The samples. */
+        using difference_type = std::ptrdiff_t;             /*!< The distance between iterators. */
+        using pointer = const TrajectorySample*;            /*!< A pointer to the current sample. */
+        using reference = const TrajectorySample&;          /*!< A reference to the current sample. */
+
+        /*! What post-increment returns. The buffer of the range already holds the next sample, so it keeps a copy of the previous one for `*it++`.
+         */
+        class PostIncrement {
+        public:
+            /*! Initializing constructor.
+             *  \param newSample the sample to keep
+             */
+            PostIncrement(const TrajectorySample& newSample);
+
+            /*! Get the kept sample.
+             *  \return The sample the iterator was on before the increment.
+             */
+            const TrajectorySample& operator*() const;
+
+        private:
+            TrajectorySample sample;    /*!< The copy of the previous sample. */
+        };
+
+        /*! Initializing constructor, used by SampleRange.
+         *  \param newRange the range iterated
+         *  \param newIndex the index of the sample
+         */
+        Iterator(SampleRange* newRange, const long newIndex);
+
+        /*! Get the current sample.
+         *  \return A reference into the buffer of the range.
+         */
+        reference operator*() const;
+
+        /*! Access the current sample.
+         *  \return A pointer into the buffer of the range.
+         */
+        pointer operator->() const;
+
+        /*! Moves to the next sample and computes it.
+         *  \return This iterator.
+         */
+        Iterator& operator++();
+
+        /*! Moves to the next sample and computes it. Copies the previous sample, prefer pre-increment in loops.
+         *  \return A holder of the previous sample.
+         */
+        PostIncrement operator++(int);
+
+        /*! Compares the sample indices.
+         */
+        bool operator==(const Iterator& other) const;
+
+        /*! Compares the sample indices.
+         */
+        bool operator!=(const Iterator& other) const;
+
+    private:
+        SampleRange* range;     /*!< The range iterated. */
+        long index;             /*!< The index of the current sample. */
+    };
+
+    /*! Initializing constructor, usually called through `Trajectory::samples()`.
+     *  \param newTrajectory the trajectory to sample
+     *  \param newTimeStep the time between samples (must be positive)
+     *  \param newStartTime the time of the first sample
+     *  \param newEndTime the time of the last sample
+     */
+    SampleRange(Trajectory& newTrajectory, const double newTimeStep, const double newStartTime, const double newEndTime);
+
+    /*! Initializing constructor, usually called through `TrajectoryEvaluator::samples()`.
+     *  \param newEvaluator the evaluator of the trajectory to sample
+     *  \param newTimeStep the time between samples (must be positive)
+     *  \param newStartTime the time of the first sample
+     *  \param newEndTime the time of the last sample
+     */
+    SampleRange(TrajectoryEvaluator& newEvaluator, const double newTimeStep, const double newStartTime, const double newEndTime);
+
+    /*! Computes the first sample.
+     *  \return An iterator on the first sample.
+     */
+    Iterator begin();
+
+    /*! Get the end of the range.
+     *  \return The past the end iterator.
+     */
+    Iterator end();
+
+    /*! Get the number of samples.
+     *  \return The number of samples, 0 if the time step is not positive or the end is before the start.
+     */
+    long size() const;
+
+private:
+
+    /*! Computes a sample into the buffer.
+     */
+    void evaluate(const long index);
+
+    Trajectory* trajectory;             /*!< The trajectory sampled, or null. */
+    TrajectoryEvaluator* evaluator;     /*!< The evaluator sampled, or null. */
+    double timeStep;                    /*!< The time between samples. */
+    double startTime;                   /*!< The time of the first sample. */
+    long nSamples;                      /*!< The number of samples. */
+    TrajectorySample sample;            /*!< The buffer holding the current sample. */
+};
+
+} // end of namespace tgl
+#endif // TGL_SAMPLERANGE_H
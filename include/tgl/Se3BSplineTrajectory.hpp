@@ -0,0 +1,142 @@
+/*! \file       Se3BSplineTrajectory.hpp
+ *  \brief      A cumulative cubic B-spline trajectory on SE(3) for Displacementd waypoints.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_SE3BSPLINETRAJECTORY_H
+#define TGL_SE3BSPLINETRAJECTORY_H
+
+// STL includes
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+#include <Eigen/Lgsm>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+
+namespace tgl
+{
+using Vector6d = Eigen::Matrix<double, 6, 1>;                                                   /*!< A fixed size 6 vector (twists and wrenches). */
+using StdVector6dVector = std::vector<Vector6d, Eigen::aligned_allocator<Vector6d>>;            /*!< A std vector of fixed size 6 vectors. */
+using StdDisplacementdVector = std::vector<Eigen::Displacementd, Eigen::aligned_allocator<Eigen::Displacementd>>; /*!< A std vector of Lgsm Displacementd objects. */
+using CumulativeBasisMatrix = Eigen::Matrix<double, 3, 4>;                                      /*!< The polynomial coefficients of the 3 cumulative basis functions of a cubic B-spline segment. */
+using StdCumulativeBasisVector = std::vector<CumulativeBasisMatrix, Eigen::aligned_allocator<CumulativeBasisMatrix>>; /*!< A std vector of cumulative basis coefficient matrices. */
+
+/*! \class Se3BSplineTrajectory
+ *  \brief A cumulative cubic B-spline trajectory on the Lie group SE(3).
+ *
+ *  The trajectory is built from TGL_WPT_LGSM_DISP waypoints and interpolates position and orientation together through the Lgsm exp/log maps, so the motion between two poses is a screw motion rather than a separate translation and SLERP. The pose is given by
+    \f[
+        T(t) = C_i \prod_{j=1}^{3} \exp\left(\tilde{B}_{i+j}(t) \, \Omega_{i+j}\right), \qquad \Omega_k = \log\left(C_{k-1}^{-1} C_k\right)
+    \f]
+ *  where \f$ \tilde{B} \f$ are the cumulative basis functions of a clamped, non-uniform cubic B-spline whose interior knots are the waypoint times. The first and last waypoints are doubled, so the trajectory starts and ends exactly on them at rest and segment \f$ i \f$ spans \f$ [t_i, t_{i+1}] \f$. Interior waypoints are control poses: the trajectory is \f$ C^2 \f$ and passes close to, but not exactly through, them.
+ *
+ *  The log maps \f$ \Omega_k \f$ and the cumulative basis polynomials are computed once in `setWaypoints()`, so an evaluation costs three exponentials and no allocation.
+ *
+ *  The typed `getDesired()` returns the pose, the body twist \f$ (T^{-1}\dot{T})^\vee \f$ and its time derivative. The Eigen::VectorXd interface returns them with the layouts of TglTools, i.e. \f$ [x, y, z, q_w, q_x, q_y, q_z] \f$ for the pose and linear-then-angular for the twists.
+ */
+class Se3BSplineTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     */
+    Se3BSplineTrajectory();
+
+    /*! Initializing constructor. Sets waypoints and builds the spline.
+     *  \param newWptSet a Waypoint Set of TGL_WPT_LGSM_DISP waypoints with strictly increasing times.
+     */
+    Se3BSplineTrajectory(const WaypointSet& newWptSet);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~Se3BSplineTrajectory();
+
+    using Trajectory::getDesired;
+
+    /*! Get the desired pose, body twist and body twist derivative from the trajectory.
+     *  \param desiredPose the pose reference provided by the trajectory
+     *  \param desiredTwist the body twist reference provided by the trajectory
+     *  \param desiredTwistDerivative the time derivative of the body twist reference
+     *  \param time_step the time with which to calculate the desired values. If not given, will default to an interal clock.
+     *  \return TGL_START before the first waypoint time, TGL_RUNNING during the motion, TGL_FINISHED after the last waypoint time and TGL_ERROR if the spline has not been built.
+     */
+    TglMessage getDesired(  Eigen::Displacementd& desiredPose,
+                            Eigen::Twistd& desiredTwist,
+                            Eigen::Twistd& desiredTwistDerivative,
+                            const double time_step=TGL_USE_INTERNAL_CLOCK);
+
+    /*! Evaluates the trajectory at many times in one call. Consecutive times falling in the same segment reuse the segment lookup, so sorted times are the fastest. The internal clock is not used or modified.
+     *  \param times the times at which to evaluate the trajectory
+     *  \param desiredPoses a \f$ 7 \times n \f$ matrix of poses \f$ [x, y, z, q_w, q_x, q_y, q_z]^T \f$
+     *  \param desiredTwists a \f$ 6 \times n \f$ matrix of body twists (linear then angular)
+     *  \param desiredTwistDerivatives a \f$ 6 \times n \f$ matrix of body twist derivatives (linear then angular)
+     *  \return TGL_OK on success, TGL_ERROR if the spline has not been built.
+     */
+    TglMessage getDesiredBatch( const Eigen::VectorXd& times,
+                                Eigen::MatrixXd& desiredPoses,
+                                Eigen::MatrixXd& desiredTwists,
+                                Eigen::MatrixXd& desiredTwistDerivatives);
+
+    /*! Sets the waypoints and builds the spline: control poses, per-segment log maps and cumulative basis polynomials.
+     *  \param newWptSet a Waypoint Set of at least two TGL_WPT_LGSM_DISP waypoints with strictly increasing times.
+     *  \return TGL_OK on success, TGL_ERROR if the waypoints cannot be used (the previous spline is then cleared).
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+protected:
+
+    /*! Open loop implementation. See `getDesired()` for the output layouts.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    /*! Evaluates the spline.
+     *  \param time the time at which to evaluate
+     *  \param pose the resulting pose
+     *  \param twist the resulting body twist (Lgsm ordering: angular then linear)
+     *  \param twistDerivative the resulting body twist derivative (Lgsm ordering: angular then linear)
+     *  \return The trajectory status at this time.
+     */
+    TglMessage evaluate(const double time, Eigen::Displacementd& pose, Vector6d& twist, Vector6d& twistDerivative);
+
+    StdDoubleVector knotTimes;                  /*!< The waypoint times, segment i spans [knotTimes[i], knotTimes[i+1]]. */
+    StdDisplacementdVector controlPoses;        /*!< The control poses, i.e. the waypoints with the first and last doubled. */
+    StdVector6dVector controlLogs;              /*!< The cached log maps between consecutive control poses, controlLogs[k] = log(C_{k-1}^{-1} C_k). */
+    StdCumulativeBasisVector cumulativeBasis;   /*!< Per-segment polynomial coefficients (in the normalized segment time) of the cumulative basis functions. */
+    int segmentCursor;                          /*!< The last segment used, the starting point of the next segment search. */
+};
+
+} // end of namespace tgl
+#endif // TGL_SE3BSPLINETRAJECTORY_H
@@ -0,0 +1,185 @@
+/*! \file       SegmentBvh.hpp
+ *  \brief      A bounding volume hierarchy over the segments of a piecewise trajectory.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_SEGMENTBVH_H
+#define TGL_SEGMENTBVH_H
+
+// STL includes
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+
+namespace tgl
+{
+
+/*! \class SegmentBvh
+ *  \brief A bounding volume hierarchy of axis aligned boxes, one box per trajectory segment.
+ *
+ *  The boxes are split recursively at the median of their centers along the widest axis, so the tree is balanced and built in O(n log n). Each node also stores the range of segment indices below it, which lets queries be restricted to a window of consecutive segments, i.e. a time window.
+ *
+ *  `nearest()` is a branch and bound search: nodes are visited closest box first and pruned as soon as their box is further than the best exact distance found so far, which is given by a user callback on the leaf segments.
+ */
+class SegmentBvh {
+public:
+
+    /*! Basic constructor. Creates an empty hierarchy.
+     */
+    SegmentBvh();
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~SegmentBvh();
+
+    /*! Builds the hierarchy.
+     *  \param boxMin the lower corners of the segment boxes, one column per segment
+     *  \param boxMax the upper corners of the segment boxes, one column per segment
+     *  \return TGL_OK on success, TGL_ERROR if the sizes do not match.
+     */
+    TglMessage build(const Eigen::MatrixXd& boxMin, const Eigen::MatrixXd& boxMax);
+
+    /*! Removes all the nodes.
+     */
+    void clear();
+
+    /*! Checks if the hierarchy has been built.
+     *  \return true if there are no segments.
+     */
+    bool empty() const;
+
+    /*! Get the memory held by the nodes.
+     *  \return The size in bytes.
+     */
+    std::size_t getMemoryUsage() const;
+
+    /*! Finds the segment nearest to a point.
+     *  \param point the query point, with the dimension of the boxes
+     *  \param firstSegment the first segment to consider
+     *  \param lastSegment the last segment to consider
+     *  \param segmentDistance a callable `double(int segment, double bound)` returning the exact distance from the point to a segment. It may return any value at least `bound` when the segment is further than `bound`.
+     *  \param bestSegment the nearest segment, unchanged if none is closer than bestDistance
+     *  \param bestDistance on input an upper bound on the distance (e.g. from a warm start), on output the distance to the nearest segment
+     */
+    template<typename SegmentDistance>
+    void nearest(   const Eigen::VectorXd& point,
+                    const int firstSegment,
+                    const int lastSegment,
+                    SegmentDistance segmentDistance,
+                    int& bestSegment,
+                    double& bestDistance) const
+    {
+        if (nodes.empty()) {
+            return;
+        }
+        // Balanced median splits keep the depth around log2(n), so a fixed stack is plenty.
+        int stack[128];
+        double stackDistance[128];
+        int stackSize = 0;
+        stack[stackSize] = 0;
+        stackDistance[stackSize++] = boxDistance(0, point);
+        while (stackSize > 0) {
+            const int n = stack[--stackSize];
+            if (stackDistance[stackSize] >= bestDistance) {
+                continue;
+            }
+            const Node& node = nodes[n];
+            if (node.maxSegment < firstSegment || node.minSegment > lastSegment) {
+                continue;
+            }
+            if (node.left < 0) {
+                for (int i = node.first; i < node.first + node.count; ++i) {
+                    const int s = segmentOrder[i];
+                    if (s < firstSegment || s > lastSegment) {
+                        continue;
+                    }
+                    double d = segmentDistance(s, bestDistance);
+                    if (d < bestDistance) {
+                        bestDistance = d;
+                        bestSegment = s;
+                    }
+                }
+                continue;
+            }
+            // Push the further child first so the closer one is explored first.
+            double leftDistance = boxDistance(node.left, point);
+            double rightDistance = boxDistance(node.right, point);
+            int nearChild = node.left, farChild = node.right;
+            if (rightDistance < leftDistance) {
+                std::swap(nearChild, farChild);
+                std::swap(leftDistance, rightDistance);
+            }
+            if (rightDistance < bestDistance) {
+                stack[stackSize] = farChild;
+                stackDistance[stackSize++] = rightDistance;
+            }
+            if (leftDistance < bestDistance) {
+                stack[stackSize] = nearChild;
+                stackDistance[stackSize++] = leftDistance;
+            }
+        }
+    }
+
+private:
+
+    /*! A node of the hierarchy. Leaves have no children and own `count` entries of `segmentOrder` from `first`.
+     */
+    struct Node {
+        int left;           /*!< The left child node, -1 for a leaf. */
+        int right;          /*!< The right child node, -1 for a leaf. */
+        int first;          /*!< The first entry of segmentOrder below this node. */
+        int count;          /*!< The number of segments below this node. */
+        int minSegment;     /*!< The smallest segment index below this node. */
+        int maxSegment;     /*!< The largest segment index below this node. */
+    };
+
+    /*! Builds the node covering entries first to first + count of segmentOrder.
+     *  \return The node index.
+     */
+    int buildNode(const Eigen::MatrixXd& boxMin, const Eigen::MatrixXd& boxMax, const int first, const int count);
+
+    /*! The Euclidean distance from a point to the box of a node, 0 inside.
+     */
+    double boxDistance(const int node, const Eigen::VectorXd& point) const
+    {
+        return (nodeMin.col(node) - point).cwiseMax(point - nodeMax.col(node)).cwiseMax(0.0).norm();
+    }
+
+    std::vector<Node> nodes;        /*!< The nodes, the root first. */
+    std::vector<int> segmentOrder;  /*!< The segment indices, ordered so each leaf owns a contiguous range. */
+    Eigen::MatrixXd nodeMin;        /*!< The lower corners of the node boxes, one column per node. */
+    Eigen::MatrixXd nodeMax;        /*!< The upper corners of the node boxes, one column per node. */
+};
+
+} // end of namespace tgl
+#endif // TGL_SEGMENTBVH_H
@@ -0,0 +1,187 @@
+/*! \file       SequenceTrajectory.hpp
+ *  \brief      A trajectory which plays child trajectories one after the other, building them lazily.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_SEQUENCETRAJECTORY_H
+#define TGL_SEQUENCETRAJECTORY_H
+
+// STL includes
+#include <vector>
+#include <functional>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+
+namespace tgl
+{
+using TrajectoryFactory = std::function<TrajectoryPtr()>;  /*!< A function which builds a trajectory when it is first needed. */
+
+/*! \class SequenceTrajectory
+ *  \brief A composite trajectory which plays child trajectories one after the other.
+ *
+ *  Long tasks are described as a sequence of steps instead of one giant Waypoint Set. Each step plays a time window of a child trajectory, forwards or reversed, or holds the end of the previous step. Since a SequenceTrajectory is itself a Trajectory, sequences can be nested to build a composition tree, and `setStartTime()` shifts the whole sequence in time.
+ *
+ *  Children can be given as factories which are only called the first time the step is evaluated, so adding thousands of steps is cheap and the cost of building each sub-motion is paid when the motion gets there. The step containing a given time is found with `findSegment()`, i.e. O(1) for a clock moving forward and O(log n) otherwise.
+ *
+ *  Children are evaluated with explicit times, so they must implement the **Open Loop** `getDesired()`.
+    ~~~~~~~~~~~~~~{.cpp}
+    tgl::SequenceTrajectory task;
+    task.append(approachPath, 2.0);
+    task.appendHold(0.5);
+    task.append([&](){ return buildInsertion(); }, 4.0);
+    task.appendReversed(approachPath, 2.0);
+    ~~~~~~~~~~~~~~
+ */
+class SequenceTrajectory : public Trajectory {
+public:
+
+    /*! Basic constructor. Creates an empty sequence starting at time 0.
+     */
+    SequenceTrajectory();
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~SequenceTrajectory();
+
+    /*! Appends a step which plays a child trajectory.
+     *  \param child the trajectory to play
+     *  \param duration the duration of the step (must be positive)
+     *  \param childStartTime the child time at which the step starts, the step plays the child from childStartTime to childStartTime + duration
+     *  \return TGL_OK on success, TGL_ERROR if the child is null or the duration is not positive.
+     */
+    TglMessage append(TrajectoryPtr child, const double duration, const double childStartTime=0.0);
+
+    /*! Appends a step whose child trajectory is built by a factory the first time the step is evaluated.
+     *  \param childFactory the function building the trajectory to play
+     *  \param duration the duration of the step (must be positive)
+     *  \param childStartTime the child time at which the step starts
+     *  \return TGL_OK on success, TGL_ERROR if the factory is empty or the duration is not positive.
+     */
+    TglMessage append(TrajectoryFactory childFactory, const double duration, const double childStartTime=0.0);
+
+    /*! Appends a step which plays a child trajectory backwards, from childStartTime + duration to childStartTime. The velocities are negated, the accelerations are unchanged.
+     *  \param child the trajectory to play backwards
+     *  \param duration the duration of the step (must be positive)
+     *  \param childStartTime the child time at which the step ends
+     *  \return TGL_OK on success, TGL_ERROR if the child is null or the duration is not positive.
+     */
+    TglMessage appendReversed(TrajectoryPtr child, const double duration, const double childStartTime=0.0);
+
+    /*! Appends a step whose child trajectory is built lazily and played backwards. See the other `appendReversed()`.
+     */
+    TglMessage appendReversed(TrajectoryFactory childFactory, const double duration, const double childStartTime=0.0);
+
+    /*! Appends a step which holds the final position of the previous step with zero velocity and acceleration.
+     *  \param duration the duration of the hold (must be positive)
+     *  \return TGL_OK on success, TGL_ERROR if there is no previous step or the duration is not positive.
+     */
+    TglMessage appendHold(const double duration);
+
+    /*! Removes all the steps.
+     */
+    void clear();
+
+    /*! Shifts the whole sequence in time.
+     *  \param newStartTime the time at which the first step starts
+     */
+    void setStartTime(const double newStartTime);
+
+    /*! Get the time at which the first step starts.
+     *  \return The start time.
+     */
+    double getStartTime() const;
+
+    /*! Get the total duration of the steps.
+     *  \return The duration in seconds.
+     */
+    double getDuration() const;
+
+    /*! Get the number of steps.
+     *  \return The number of steps.
+     */
+    int getNumberOfSteps() const;
+
+    /*! Get the number of child trajectories which have been built so far, i.e. given directly or built by their factory.
+     *  \return The number of built children.
+     */
+    int getNumberOfBuiltSteps() const;
+
+protected:
+
+    /*! Open loop implementation. Delegates to the step active at the given time.
+     *  \return TGL_START before the start time, TGL_FINISHED after the last step, TGL_RUNNING in between and TGL_ERROR if the sequence is empty or a child fails.
+     */
+    virtual TglMessage getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time_step);
+
+private:
+
+    /*! The ways a step can use its child.
+     */
+    enum StepMode {
+        STEP_FORWARD,   /*!< Plays the child forwards. */
+        STEP_REVERSED,  /*!< Plays the child backwards. */
+        STEP_HOLD       /*!< Holds the end of the previous step. */
+    };
+
+    /*! A step of the sequence.
+     */
+    struct Step {
+        StepMode mode;                  /*!< How the child is played. */
+        TrajectoryPtr child;            /*!< The child trajectory, null until built for lazy steps and always null for holds. */
+        TrajectoryFactory factory;      /*!< The function building the child, released once it has been called. */
+        double childStartTime;          /*!< The child time at which the step window starts. */
+        double duration;                /*!< The duration of the step. */
+    };
+
+    /*! Appends a step after validating it.
+     */
+    TglMessage appendStep(const Step& newStep);
+
+    /*! Evaluates a step at a time relative to its start, building the child if needed.
+     *  \param stepIndex the step to evaluate
+     *  \param localTime the time since the start of the step, in [0, duration]
+     *  \return TGL_OK on success, TGL_ERROR if the child can not be built or evaluated.
+     */
+    TglMessage evaluateStep(const int stepIndex, const double localTime, Eigen::VectorXd& desiredPos, Eigen::VectorXd& desiredVel, Eigen::VectorXd& desiredAcc);
+
+    std::vector<Step> steps;        /*!< The steps in time order. */
+    StdDoubleVector stepBounds;     /*!< The step boundaries relative to the start time, step i spans [stepBounds[i], stepBounds[i+1]]. */
+    double startTime;               /*!< The time at which the first step starts. */
+    int builtSteps;                 /*!< The number of children built so far. */
+    int segmentCursor;              /*!< The last step used, the starting point of the next step search. */
+};
+
+} // end of namespace tgl
+#endif // TGL_SEQUENCETRAJECTORY_H
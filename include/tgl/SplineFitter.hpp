@@ -0,0 +1,173 @@
+/*! \file       SplineFitter.hpp
+ *  \brief      Streaming least-squares fitting of cubic splines to dense samples.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_SPLINEFITTER_H
+#define TGL_SPLINEFITTER_H
+
+// STL includes
+#include <istream>
+#include <memory>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/WaypointSet.hpp"
+#include "tgl/PiecewisePolynomial.hpp"
+#include "tgl/CubicSplineTrajectory.hpp"
+
+#ifndef TGL_FIT_CHUNK_SIZE /*!< The number of samples read and accumulated at once by the SplineFitter. */
+#define TGL_FIT_CHUNK_SIZE 65536
+#endif
+
+namespace tgl
+{
+
+/*! \class SplineFitter
+ *  \brief Fits a smoothing cubic spline to dense noisy samples, streamed in chunks.
+ *
+ *  Interpolating every sample of a demonstration recorded at a high rate is slow and reproduces the sensor noise. The fitter instead finds the uniform cubic B-spline \f$ p(t) = \sum_k c_k B_k(t) \f$ with `nSegments` segments over `[startTime, endTime]` which solves
+    \f[
+        \min_c \sum_s \left\| p(t_s) - y_s \right\|^2 + \lambda \int \left\| p''(t) \right\|^2 dt
+    \f]
+ *  Each sample only touches 4 consecutive basis functions, so the normal equations are banded with 3 off-diagonals. `addSamples()` accumulates them as the samples come, in parallel over large chunks, and drops the samples: the memory is O(nSegments * DoF) whatever the number of samples, so recordings too big to load can be fitted from a stream. `solve()` then factorizes the banded system once with an O(nSegments) LDLT and converts the B-spline to the per-segment polynomials of a PiecewisePolynomial.
+ *
+ *  The smoothing weight \f$ \lambda \f$ trades fidelity for smoothness, it is in (sample units)^2 x time^3. Without smoothing every segment needs samples, and at least 4 in total, for the system to be solvable.
+    ~~~~~~~~~~~~~~{.cpp}
+    tgl::SplineFitter fitter(0.0, 60.0, 600, 7, 1e-4);
+    std::ifstream recording("demo.txt"); // one "t q1 ... q7" line per sample
+    fitter.addSamples(recording);
+    tgl::CubicSplineTrajectory traj;
+    fitter.solve(traj);
+    ~~~~~~~~~~~~~~
+ */
+class SplineFitter {
+public:
+
+    /*! Basic constructor. The fitter must be reset before adding samples.
+     */
+    SplineFitter();
+
+    /*! Initializing constructor. See `reset()`.
+     */
+    SplineFitter(const double newStartTime, const double newEndTime, const int newNumberOfSegments, const int newDimension, const double newSmoothing=0.0);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~SplineFitter();
+
+    /*! Clears the accumulated samples and sets the spline to fit.
+     *  \param newStartTime the start of the spline
+     *  \param newEndTime the end of the spline, greater than the start
+     *  \param newNumberOfSegments the number of uniform segments, at least 1
+     *  \param newDimension the number of DoF of the samples, at least 1
+     *  \param newSmoothing the weight of the integral of the squared acceleration, non-negative
+     *  \return TGL_OK on success, TGL_ERROR if a parameter is invalid (the fitter is then unusable until the next reset).
+     */
+    TglMessage reset(const double newStartTime, const double newEndTime, const int newNumberOfSegments, const int newDimension, const double newSmoothing=0.0);
+
+    /*! Accumulates one sample.
+     *  \param time the sample time, within the spline times
+     *  \param position the sample position
+     *  \return TGL_OK on success, TGL_ERROR if the sample is outside of the spline times, not finite or of the wrong size.
+     */
+    TglMessage addSample(const double time, const Eigen::Ref<const Eigen::VectorXd>& position);
+
+    /*! Accumulates a chunk of samples. Large chunks are accumulated in parallel.
+     *  \param times the sample times
+     *  \param positions the sample positions, one column per sample
+     *  \return TGL_OK on success, TGL_WARNING if some samples were skipped because they are outside of the spline times or not finite, TGL_ERROR if the sizes do not match.
+     */
+    TglMessage addSamples(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& positions);
+
+    /*! Accumulates all the waypoints of a set as samples, chunk by chunk from its contiguous storage.
+     *  \param wptSet the samples, with the fitter dimension
+     *  \return As `addSamples()` on matrices.
+     */
+    TglMessage addSamples(const WaypointSet& wptSet);
+
+    /*! Accumulates the samples of a text stream until its end, TGL_FIT_CHUNK_SIZE at a time. Each line holds the time then the position, separated by white space. Empty lines and lines starting with '#' are ignored.
+     *  \param stream the stream to read
+     *  \return TGL_OK on success, TGL_WARNING if some samples were skipped, TGL_ERROR if a line cannot be parsed (the samples before it are kept).
+     */
+    TglMessage addSamples(std::istream& stream);
+
+    /*! Solves for the spline fitting the samples accumulated so far. More samples can still be added and the spline solved again.
+     *  \param fittedCore the fitted spline, a cubic PiecewisePolynomial with the uniform segments
+     *  \return TGL_OK on success, TGL_ERROR if the fitter has not been reset or the system is singular (not enough samples for the smoothing).
+     */
+    TglMessage solve(std::shared_ptr<const PiecewisePolynomial>& fittedCore) const;
+
+    /*! Solves for the spline and sets it in a CubicSplineTrajectory. See `CubicSplineTrajectory::setCore()`.
+     *  \param trajectory the trajectory to set
+     *  \return TGL_OK on success, TGL_ERROR otherwise.
+     */
+    TglMessage solve(CubicSplineTrajectory& trajectory) const;
+
+    /*! Get the number of samples accumulated since the last reset.
+     *  \return The number of samples.
+     */
+    long long getNumberOfSamples() const;
+
+    /*! Get the number of DoF of the samples.
+     *  \return The dimension, 0 before the first reset.
+     */
+    int getDimension() const;
+
+    /*! Get the memory held by the normal equations, which does not grow with the number of samples.
+     *  \return The size in bytes.
+     */
+    std::size_t getMemoryUsage() const;
+
+private:
+
+    /*! Accumulates samples into a slice of the normal equations.
+     *  \param times the sample times
+     *  \param positions the sample positions
+     *  \param begin the first sample to accumulate
+     *  \param end one past the last sample to accumulate
+     *  \param sliceBand the band of the slice, laid out like `band`
+     *  \param sliceRhs the right-hand side of the slice
+     *  \param firstBasis the basis function of the first slice column, the samples must not touch earlier ones
+     *  \return The number of samples skipped because they are outside of the spline times or not finite.
+     */
+    int accumulate(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& positions, const int begin, const int end, Eigen::MatrixXd& sliceBand, Eigen::MatrixXd& sliceRhs, const int firstBasis) const;
+
+    double startTime;               /*!< The start of the spline. */
+    double endTime;                 /*!< The end of the spline. */
+    int nSegments;                  /*!< The number of uniform segments. */
+    double smoothing;               /*!< The weight of the integral of the squared acceleration. */
+    Eigen::MatrixXd band;           /*!< The normal matrix, band(k, i) is the entry (i, i + k) for k from 0 to 3, one column per basis function. */
+    Eigen::MatrixXd rhs;            /*!< The right-hand side of the normal equations, one column per basis function. */
+    long long nSamples;             /*!< The number of samples accumulated. */
+};
+
+} // end of namespace tgl
+#endif // TGL_SPLINEFITTER_H
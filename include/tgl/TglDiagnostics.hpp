@@ -0,0 +1,165 @@
+/*! \file       TglDiagnostics.hpp
+ *  \brief      Non-blocking, rate-limited error reporting for real-time threads.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_TGLDIAGNOSTICS_H
+#define TGL_TGLDIAGNOSTICS_H
+
+// STL includes
+#include <atomic>
+#include <cstdint>
+
+// TGL includes
+#include "tgl/TglTypes.hpp"
+
+#ifndef TGL_DIAGNOSTICS_CAPACITY /*!< The number of records the diagnostics ring holds, a power of 2. Records reported while it is full are dropped. */
+#define TGL_DIAGNOSTICS_CAPACITY 1024
+#endif
+
+#ifndef TGL_DIAGNOSTICS_MAX_VALUES /*!< The number of values a diagnostic record carries. */
+#define TGL_DIAGNOSTICS_MAX_VALUES 4
+#endif
+
+#ifndef TGL_DIAGNOSTICS_RATE /*!< The number of records a reporting site may log per rate window, the others are counted as suppressed. */
+#define TGL_DIAGNOSTICS_RATE 10
+#endif
+
+#ifndef TGL_DIAGNOSTICS_WINDOW /*!< The length of the rate window, in seconds. */
+#define TGL_DIAGNOSTICS_WINDOW 1.0
+#endif
+
+#ifndef TGL_DIAGNOSTICS_DRAIN_PERIOD /*!< The time between two drains of the ring by the background thread, in milliseconds. */
+#define TGL_DIAGNOSTICS_DRAIN_PERIOD 10
+#endif
+
+/*! \brief Reports an error without blocking, see TglDiagnostics.
+ *
+ *  Takes a format string literal and up to TGL_DIAGNOSTICS_MAX_VALUES numbers, which the format must read as doubles (%g, %f, %e), e.g. `TGL_REPORT_ERROR("Waypoint dimensions do not match: %.0f ~= %.0f.", a, b);`. Each use is its own rate-limited site.
+ */
+#ifndef TGL_REPORT_ERROR
+#define TGL_REPORT_ERROR(...) do { static tgl::DiagnosticSite tglDiagnosticSite(__FILE__, __LINE__, tgl::TGL_DIAGNOSTIC_ERROR); tgl::TglDiagnostics::report(tglDiagnosticSite, __VA_ARGS__); } while (0)
+#endif
+
+/*! \brief Reports a warning without blocking, see TGL_REPORT_ERROR.
+ */
+#ifndef TGL_REPORT_WARNING
+#define TGL_REPORT_WARNING(...) do { static tgl::DiagnosticSite tglDiagnosticSite(__FILE__, __LINE__, tgl::TGL_DIAGNOSTIC_WARNING); tgl::TglDiagnostics::report(tglDiagnosticSite, __VA_ARGS__); } while (0)
+#endif
+
+namespace tgl
+{
+
+/*! \brief The glog severity a diagnostic is logged with.
+ */
+enum TglDiagnosticSeverity {
+    TGL_DIAGNOSTIC_WARNING,     // 0
+    TGL_DIAGNOSTIC_ERROR        // 1
+};
+
+/*! \brief A place in the code which reports diagnostics, with its rate limiting state. Made once per use of TGL_REPORT_ERROR or TGL_REPORT_WARNING.
+ */
+struct DiagnosticSite {
+
+    /*! Initializing constructor.
+     *  \param newFile the source file
+     *  \param newLine the source line
+     *  \param newSeverity the severity of the records of the site
+     */
+    DiagnosticSite(const char* newFile, const int newLine, const TglDiagnosticSeverity newSeverity);
+
+    const char* file;                       /*!< The source file. */
+    int line;                               /*!< The source line. */
+    TglDiagnosticSeverity severity;         /*!< The severity of the records. */
+    std::atomic<int64_t> windowStart;       /*!< The start of the current rate window, in nanoseconds of the steady clock. */
+    std::atomic<uint32_t> windowCount;      /*!< The number of records reported in the current window. */
+    std::atomic<uint64_t> suppressed;       /*!< The number of records suppressed since the last one which was kept. */
+};
+
+/*! \class TglDiagnostics
+ *  \brief Non-blocking, rate-limited error reporting for real-time threads.
+ *
+ *  `LOG(ERROR)` takes a mutex and writes to files in the calling thread, which a real-time loop cannot afford, and a misconfigured input can make a hot function log thousands of lines per second. The functions on the evaluation path (`Trajectory::getDesired()` implementations, trajectory cores, `Waypoint` getters and operators) report through TGL_REPORT_ERROR instead, which only stores a small record: the site, the format string and a few numbers. No allocation, lock or system call is made.
+ *
+ *  Records go into a lock-free ring of TGL_DIAGNOSTICS_CAPACITY entries (a bounded multi-producer queue, so any number of threads can report). A background thread drains it every TGL_DIAGNOSTICS_DRAIN_PERIOD ms, formats the records and logs them to glog with the file and line of their site. Each site may keep TGL_DIAGNOSTICS_RATE records per TGL_DIAGNOSTICS_WINDOW seconds, and the first record kept after a window with suppressed ones says how many were suppressed. Records which find the ring full are dropped and counted.
+ *
+ *  The drain thread is started by the first report. Real-time applications should call `start()` during their initialization so that the first report does not create it. `flush()` logs the pending records from the calling thread, e.g. before exiting.
+ */
+class TglDiagnostics {
+public:
+
+    /*! A snapshot of the diagnostics counters.
+     */
+    struct Statistics {
+        uint64_t reported;      /*!< The number of records reported. */
+        uint64_t logged;        /*!< The number of records logged to glog. */
+        uint64_t suppressed;    /*!< The number of records suppressed by the rate limit. */
+        uint64_t dropped;       /*!< The number of records dropped because the ring was full. */
+    };
+
+    /*! Reports a record. Never blocks. Use the TGL_REPORT_ERROR and TGL_REPORT_WARNING macros rather than calling it directly.
+     *  \param site the reporting site
+     *  \param format a printf format with static storage duration (a string literal), reading its values as doubles
+     *  \param values up to TGL_DIAGNOSTICS_MAX_VALUES numbers
+     */
+    template<typename... Values>
+    static void report(DiagnosticSite& site, const char* format, const Values... values);
+
+    /*! Starts the drain thread if it is not running.
+     */
+    static void start();
+
+    /*! Stops the drain thread after a last drain. A later report starts it again.
+     */
+    static void stop();
+
+    /*! Logs the pending records from the calling thread.
+     *  \return The number of records logged.
+     */
+    static int flush();
+
+    /*! Get a snapshot of the counters.
+     *  \return The statistics.
+     */
+    static Statistics getStatistics();
+
+private:
+
+    /*! Applies the rate limit of the site and pushes the record into the ring.
+     */
+    static void submit(DiagnosticSite& site, const char* format, const double* values, const int nValues);
+};
+
+template<typename... Values>
+void TglDiagnostics::report(DiagnosticSite& site, const char* format, const Values... values)
+{
+    static_assert(sizeof...(Values) <= TGL_DIAGNOSTICS_MAX_VALUES, "Too many values for a diagnostic record, see TGL_DIAGNOSTICS_MAX_VALUES.");
+    const double packed[] = {0.0, static_cast<double>(values)...};
+    submit(site, format, packed + 1, sizeof...(Values));
+}
+
+} // end of namespace tgl
+#endif // TGL_TGLDIAGNOSTICS_H
@@ -30,6 +30,9 @@
 #define TGL_TGLTOOLS_H
 // STL includes
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 
 
 // Eigen includes
@@ -137,6 +140,21 @@ public:
      */
     static Eigen::VectorXd eigenRotation3dToVectorXd(const Eigen::Rotation3d& inputRotation3d);
 
+    /*! Runs a loop over [0, n) in parallel. The range is cut into one contiguous chunk per hardware thread and `body(begin, end)` is called once per chunk, the calling thread taking the first one. Small ranges run on the calling thread only.
+     *  \param n the size of the range
+     *  \param body the function processing the items begin to end - 1, called concurrently so it must only share read-only or synchronized state
+     *  \param minChunkSize the minimum number of items worth a thread
+     */
+    static void parallelFor(const int n, const std::function<void(int, int)>& body, const int minChunkSize=1024);
+
+    /*! Updates a 64-bit FNV-1a hash with a block of bytes. Fast and stable across runs and platforms of the same byte order, but not cryptographic.
+     *  \param data the bytes to hash
+     *  \param size the number of bytes
+     *  \param hash the hash to update, the FNV offset basis to start a new one
+     *  \return The updated hash.
+     */
+    static uint64_t hashBytes(const void* data, const std::size_t size, uint64_t hash=14695981039346656037ULL);
+
 };
 
 } // End of namespace tgl
@@ -81,5 +81,39 @@ inline std::ostream& operator<<(std::ostream& os, const TglWaypointType& wptType
     return os;
 }
 
+/*! \brief The derivatives whose limits can be verified.
+ */
+enum TglDerivative {
+    TGL_VELOCITY,       // 0
+    TGL_ACCELERATION,   // 1
+    TGL_JERK            // 2
+};
+
+inline std::ostream& operator<<(std::ostream& os, const TglDerivative& derivative)
+{
+    switch (derivative) {
+        case TGL_VELOCITY:
+            os << "TGL_VELOCITY";
+            break;
+        case TGL_ACCELERATION:
+            os << "TGL_ACCELERATION";
+            break;
+        case TGL_JERK:
+            os << "TGL_JERK";
+            break;
+    }
+    return os;
+}
+
+/*! \brief The worst violation of a kinematic limit for one DoF and one derivative.
+ */
+struct TglLimitViolation {
+    int dof;                    /*!< The DoF index. */
+    TglDerivative derivative;   /*!< The derivative whose limit is violated. */
+    double time;                /*!< The time of the worst value. */
+    double value;               /*!< The worst value (signed). */
+    double limit;               /*!< The limit on the absolute value. */
+};
+
 } // End of namespace tgl
 #endif //TGL_TGLTYPES_H
@@ -34,6 +34,7 @@
 #include <vector>
 #include <chrono>
 #include <sstream>
+#include <memory>
 
 // Eigen includes
 #include <Eigen/Dense>
@@ -42,6 +43,9 @@
 #include "tgl/TglTools.hpp"
 #include "tgl/TglTypes.hpp"
 #include "tgl/WaypointSet.hpp"
+#include "tgl/TrajectoryCore.hpp"
+#include "tgl/SampleRange.hpp"
+#include "tgl/PerformanceCounters.hpp"
 
 #ifndef TGL_USE_INTERNAL_CLOCK /*!< Tells the getDesired functions to use the internal trajectory clock. */
 #define TGL_USE_INTERNAL_CLOCK -1.0
@@ -89,6 +93,18 @@ public:
                             Eigen::VectorXd& desiredAcc,
                             const double time_step=TGL_USE_INTERNAL_CLOCK);
 
+    /*! Get the desired values from the trajectory at an explicit time. **Open Loop** Unlike `getDesired()`, any time is a time: TGL_USE_INTERNAL_CLOCK (-1) is evaluated like the others, and the internal clock is neither read nor reset. Used to sample a time grid which may go through -1.
+     *  \param desiredPos the position reference provided by the trajectory
+     *  \param desiredVel the velocity reference provided by the trajectory
+     *  \param desiredAcc the acceleration reference provided by the trajectory
+     *  \param time the time with which to calculate the desired values
+     *  \return A TglMessage indicating the status of the trajectory (see TglTypes.hpp)
+     */
+    TglMessage getDesiredAt(Eigen::VectorXd& desiredPos,
+                            Eigen::VectorXd& desiredVel,
+                            Eigen::VectorXd& desiredAcc,
+                            const double time);
+
     /*! Get the desired values from the trajectory. **Closed Loop**
      *  \param time_step the time with which to calculate the desired values.
      *  \param desiredPos the position reference provided by the trajectory
@@ -107,6 +123,56 @@ public:
                              const Eigen::VectorXd& currentAcc,
                              const double time_step=TGL_USE_INTERNAL_CLOCK);
 
+    /*! Get the desired values at many times at once, in any order, e.g. for an optimizer or a collision checker. The internal clock is not used. Trajectories with a core hand the times to `TrajectoryCore::evaluateBatch()`, which groups them by segment. The others are evaluated through the **Open Loop** implementation in increasing time order, so piecewise trajectories walk their segments forward, and the results are put back in the order of `times`.
+     *  \param times the times at which to evaluate, in any order
+     *  \param positions the position references, one column per time
+     *  \param velocities the velocity references, one column per time
+     *  \param accelerations the acceleration references, one column per time
+     *  \return TGL_OK on success, TGL_ERROR if the trajectory cannot be evaluated or a time is NaN.
+     */
+    TglMessage getDesiredBatch(const Eigen::Ref<const Eigen::VectorXd>& times,
+                               Eigen::MatrixXd& positions,
+                               Eigen::MatrixXd& velocities,
+                               Eigen::MatrixXd& accelerations);
+
+    /*! Sets the trajectory waypoints. Specific trajectory types override this to compute their internal representation and should call the base version to store the waypoints.
+     *  \param newWptSet the Waypoint Set to use for the trajectory.
+     *  \return A TglMessage indicating the success of the operation.
+     */
+    virtual TglMessage setWaypoints(const WaypointSet& newWptSet);
+
+    /*! Get a lazy range of samples for streaming the trajectory out. See SampleRange.
+     *  \param timeStep the time between samples (must be positive)
+     *  \param startTime the time of the first sample
+     *  \param endTime the time of the last sample
+     *  \return A single pass range evaluating this trajectory as it is iterated.
+     */
+    SampleRange samples(const double timeStep, const double startTime, const double endTime);
+
+    /*! Get an estimate of the memory held by the trajectory, used to budget caches. Derived classes add their own data to the base estimate, which counts the waypoints.
+     *  \return The size in bytes.
+     */
+    virtual std::size_t getMemoryUsage() const;
+
+    /*! Get the immutable core of the computed trajectory, to be sampled from several threads through TrajectoryEvaluator objects. The core is shared, not copied, and stays valid after the trajectory is rebuilt or destroyed.
+     *  \return The core, null if this type of trajectory does not separate its data from its evaluation state.
+     */
+    virtual TrajectoryCorePtr getCore() const;
+
+    /*! Get the waypoints the trajectory was built from, e.g. to keep them along with its core.
+     *  \return The Waypoint Set, empty if none was set.
+     */
+    const WaypointSet& getWaypointSet() const;
+
+    /*! Get a snapshot of the performance counters of the trajectory: its evaluations through `getDesired()` and `getDesiredBatch()`, its segment lookups, its rebuilds and their timings. See PerformanceCounters.
+     *  \return The snapshot.
+     */
+    PerformanceCounters::Snapshot getPerformanceSnapshot() const;
+
+    /*! Sets the performance counters of the trajectory to zero.
+     */
+    void resetPerformanceCounters();
+
 
 protected:
 
@@ -140,11 +206,6 @@ protected:
                                                  const Eigen::VectorXd& currentAcc,
                                                  const double time_step);
 
-    /*! Sets the trajectory waypoints.
-     *  \param newWptSet the Waypoint Set to use for the trajectory.
-     */
-    TglMessage setWaypoints(const WaypointSet& newWptSet);
-
     /*! Gets the trajectory waypoints.
      *  \return The Waypoint Set to use for the trajectory.
      */
@@ -160,13 +221,35 @@ protected:
      */
     double getInternalClockTime();
 
+    /*! Finds the segment of a piecewise trajectory which contains a given time. The search starts from the previously used segment so that a clock moving forward costs O(1), and falls back on a binary search otherwise. The lookup is counted in the performance counters.
+     *  \param knotTimes the increasing segment boundary times, segment i spans [knotTimes[i], knotTimes[i+1]]
+     *  \param time the time to look up, clamped to the first or last segment if out of bounds
+     *  \param segmentCursor the previously used segment, updated with the result
+     *  \return The segment index.
+     */
+    int findSegment(const StdDoubleVector& knotTimes, const double time, int& segmentCursor) const;
+
+    /*! Counts a segment lookup done without `findSegment()`, e.g. by a TrajectoryCore.
+     *  \param previousSegment the segment of the cursor before the lookup
+     *  \param segment the segment found
+     */
+    void countSegmentLookup(const int previousSegment, const int segment) const;
+
+    /*! Counts a successful rebuild, with the memory held by the trajectory once rebuilt. Trajectory types call it at the end of their `setWaypoints()`.
+     *  \param buildStart the time at which the rebuild started, from `PerformanceCounters::now()`
+     */
+    void countRebuild(const PerformanceCounters::Clock::time_point& buildStart);
+
 private:
     WaypointSet wptSet;                                                         /*!< The Waypoint Set for the trajectory. */
     bool internalClockResetTrigger;                                             /*!< Used to determine whether or not to reset the internal clock. */
     std::chrono::time_point<std::chrono::system_clock> internalClockStartTime;  /*!< The time at which the internal trajectory clock was triggered. */
+    mutable PerformanceCounters counters;                                       /*!< The performance counters, updated by const lookups too. */
 
 
 };
 
+using TrajectoryPtr = std::shared_ptr<Trajectory>;     /*!< A shared pointer to any type of trajectory. */
+
 } // end of namespace tgl
 #endif // TGL_TRAJECTORY_H
@@ -0,0 +1,193 @@
+/*! \file       TrajectoryCache.hpp
+ *  \brief      A thread-safe in-memory LRU cache of built trajectories.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_TRAJECTORYCACHE_H
+#define TGL_TRAJECTORYCACHE_H
+
+// STL includes
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/Trajectory.hpp"
+#include "tgl/TrajectoryCore.hpp"
+#include "tgl/TrajectoryEvaluator.hpp"
+#include "tgl/WaypointSet.hpp"
+
+namespace tgl
+{
+
+/*! \class TrajectoryCache
+ *  \brief A thread-safe in-memory LRU cache of built trajectories.
+ *
+ *  Planners often ask for the same moves again (going back home, to the same pick pose). The cache sits in front of trajectory construction: `getOrBuild()` returns the trajectory already built for a key, or calls the builder and keeps its result. Keys come from `computeKey()`, a hash of the waypoints and limits rounded to a quantum, and of the generator name, so requests which differ by less than the quantum share an entry. The quantum must therefore be below the positioning accuracy which matters to the caller.
+ *
+ *  The cache holds at most `maxBytes` as estimated by `Trajectory::getMemoryUsage()`, and evicts the least recently used entries beyond that. Hits, misses and evictions are counted.
+ *
+ *  The cache never hands out the built trajectory itself, whose evaluation state (internal clock, segment cursor) would be shared by all the callers. It keeps the immutable TrajectoryCore of the trajectory and the waypoints it was built from, which are shared read-only, and every lookup returns a fresh TrajectoryEvaluator of the core which belongs to that caller alone. Only trajectories which provide a core (`Trajectory::getCore()`) can be cached.
+    ~~~~~~~~~~~~~~{.cpp}
+    tgl::TrajectoryCache cache;
+    uint64_t key = cache.computeKey(wptSet, "MinimumSnapTrajectory", limits);
+    tgl::TrajectoryCache::CachedTrajectory cached = cache.getOrBuild(key, [&]() {
+        return std::make_shared<tgl::MinimumSnapTrajectory>(wptSet);
+    });
+    if (cached.core) {
+        cached.evaluator.getDesired(pos, vel, acc, t);
+    }
+    ~~~~~~~~~~~~~~
+ */
+class TrajectoryCache {
+public:
+
+    /*! A function which builds the trajectory of a key on a miss. Returning a null pointer means the build failed.
+     */
+    using TrajectoryBuilder = std::function<TrajectoryPtr()>;
+
+    /*! What a lookup returns. The core and the waypoints are shared with the other callers and never change, the evaluator is a copy owned by the caller. Like any TrajectoryEvaluator, keep it in containers through pointers.
+     */
+    struct CachedTrajectory {
+        TrajectoryCorePtr core;                         /*!< The immutable core, null on a miss or a failed build. */
+        std::shared_ptr<const WaypointSet> waypoints;   /*!< The waypoints the core was built from, null on a miss or a failed build. */
+        TrajectoryEvaluator evaluator;                  /*!< An evaluator of the core with its own clock and cursor, for this caller only. */
+    };
+
+    /*! A snapshot of the cache counters.
+     */
+    struct Statistics {
+        uint64_t hits;          /*!< The number of lookups which found their key. */
+        uint64_t misses;        /*!< The number of lookups which did not. */
+        uint64_t evictions;     /*!< The number of entries evicted to fit the memory budget. */
+        std::size_t entries;    /*!< The number of entries held. */
+        std::size_t bytes;      /*!< The estimated memory held by the entries. */
+    };
+
+    /*! Initializing constructor.
+     *  \param newMaxBytes the memory budget in bytes
+     *  \param newQuantum the resolution to which times, coordinates and limits are rounded in the keys
+     */
+    TrajectoryCache(const std::size_t newMaxBytes=64*1024*1024, const double newQuantum=1e-6);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~TrajectoryCache();
+
+    /*! Computes the key of a trajectory request.
+     *  \param wptSet the waypoints of the request (start and goal for a point to point move)
+     *  \param generator the name of the generator, e.g. "CubicSplineTrajectory"
+     *  \param limits the limits or parameters which change the result
+     *  \return The 64-bit hash of the quantized request.
+     */
+    uint64_t computeKey(const WaypointSet& wptSet, const std::string& generator, const Eigen::VectorXd& limits=Eigen::VectorXd()) const;
+
+    /*! Returns the trajectory of a key, building and inserting it on a miss. The builder runs without holding the cache lock, so other lookups are not blocked by a long build. If two threads miss on the same key at the same time both build, and the core inserted first is returned to both.
+     *  \param key the request key
+     *  \param builder the function building the trajectory on a miss
+     *  \return The shared core and waypoints with a new evaluator, an empty result if the builder failed or its trajectory has no core.
+     */
+    CachedTrajectory getOrBuild(const uint64_t key, const TrajectoryBuilder& builder);
+
+    /*! Looks a key up without building.
+     *  \param key the request key
+     *  \return The shared core and waypoints with a new evaluator, an empty result on a miss.
+     */
+    CachedTrajectory find(const uint64_t key);
+
+    /*! Inserts the core and the waypoints of a trajectory, replacing any previous entry with the same key, then evicts the least recently used entries beyond the budget. A trajectory bigger than the whole budget is not kept. The trajectory itself is not kept and may be rebuilt afterwards, its core does not change.
+     *  \param key the request key
+     *  \param trajectory the built trajectory
+     *  \return TGL_OK if the trajectory is held, TGL_WARNING if it is too big, TGL_ERROR if it is null or has no core.
+     */
+    TglMessage insert(const uint64_t key, TrajectoryPtr trajectory);
+
+    /*! Removes all the entries. The counters are kept.
+     */
+    void clear();
+
+    /*! Get a snapshot of the counters.
+     *  \return The statistics.
+     */
+    Statistics getStatistics() const;
+
+private:
+
+    /*! A cached trajectory.
+     */
+    struct Entry {
+        uint64_t key;                                   /*!< The request key. */
+        TrajectoryCorePtr core;                         /*!< The shared immutable core. */
+        std::shared_ptr<const WaypointSet> waypoints;   /*!< The waypoints the core was built from. */
+        std::size_t bytes;                              /*!< The estimated memory of the trajectory. */
+    };
+
+    using EntryList = std::list<Entry>;                                 /*!< The entries, most recently used first. */
+    using EntryIndex = std::unordered_map<uint64_t, EntryList::iterator>; /*!< The entries by key. */
+
+    /*! Makes an entry out of a built trajectory.
+     *  \param key the request key
+     *  \param trajectory the built trajectory
+     *  \param entry the entry, with a null core if the trajectory has none
+     */
+    static void makeEntry(const uint64_t key, const TrajectoryPtr& trajectory, Entry& entry);
+
+    /*! Makes the result of a lookup, with a new evaluator of the core.
+     *  \param entry the entry found or inserted
+     *  \return The result handed to the caller.
+     */
+    static CachedTrajectory makeResult(const Entry& entry);
+
+    /*! Moves an entry to the front of the LRU list. The lock must be held.
+     */
+    const Entry& touch(EntryIndex::iterator found);
+
+    /*! Evicts the least recently used entries until the cache fits its budget. The lock must be held.
+     */
+    void evict();
+
+    std::size_t maxBytes;                                                   /*!< The memory budget. */
+    double quantum;                                                         /*!< The key rounding resolution. */
+    mutable std::mutex mutex;                                               /*!< Protects everything below. */
+    EntryList entries;                                                      /*!< The entries, most recently used first. */
+    EntryIndex index;                                                       /*!< The entries by key. */
+    std::size_t bytes;                                                      /*!< The estimated memory held. */
+    uint64_t hits;                                                          /*!< The number of hits. */
+    uint64_t misses;                                                        /*!< The number of misses. */
+    uint64_t evictions;                                                     /*!< The number of evictions. */
+};
+
+} // end of namespace tgl
+#endif // TGL_TRAJECTORYCACHE_H
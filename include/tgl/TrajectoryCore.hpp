@@ -0,0 +1,114 @@
+/*! \file       TrajectoryCore.hpp
+ *  \brief      The immutable, shareable part of a computed trajectory.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_TRAJECTORYCORE_H
+#define TGL_TRAJECTORYCORE_H
+
+// STL includes
+#include <memory>
+#include <vector>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/WaypointSet.hpp"
+
+namespace tgl
+{
+
+/*! \class TrajectoryCore
+ *  \brief The immutable, shareable part of a computed trajectory.
+ *
+ *  A Trajectory mixes the data computed from the waypoints with evaluation state: the internal clock and the segment cursor. A core only holds the former and is never modified once built, so any number of threads can evaluate it at the same time without locks. The evaluation state is passed in by the caller, see TrajectoryEvaluator which bundles it per thread.
+ *
+ *  Trajectories which support this return their core from `Trajectory::getCore()`. Rebuilding the trajectory makes a new core, evaluators keep the one they were given until they are pointed at the new one.
+ */
+class TrajectoryCore {
+public:
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~TrajectoryCore();
+
+    /*! Evaluates the trajectory. Before the start time the start position is returned with TGL_START, after the end time the end position with TGL_FINISHED, in both cases with zero velocity and acceleration.
+     *  \param desiredPos the position at the given time
+     *  \param desiredVel the velocity at the given time
+     *  \param desiredAcc the acceleration at the given time
+     *  \param time the time at which to evaluate
+     *  \param segmentCursor the segment search state of the caller, updated with the segment used
+     *  \return TGL_RUNNING, TGL_START or TGL_FINISHED, TGL_ERROR if the core is empty.
+     */
+    virtual TglMessage evaluate(Eigen::VectorXd& desiredPos,
+                                Eigen::VectorXd& desiredVel,
+                                Eigen::VectorXd& desiredAcc,
+                                const double time,
+                                int& segmentCursor) const = 0;
+
+    /*! Evaluates the trajectory at many times in any order, without touching any cursor of the caller. The default implementation sorts the times, evaluates them in increasing order so the segment search stays O(1), and scatters the results back in the order of `times`. Cores which can do better override it.
+     *  \param times the times at which to evaluate, in any order
+     *  \param positions the positions, one column per time
+     *  \param velocities the velocities, one column per time
+     *  \param accelerations the accelerations, one column per time
+     *  \return TGL_OK on success, TGL_ERROR if the core is empty or a time is NaN.
+     */
+    virtual TglMessage evaluateBatch(const Eigen::Ref<const Eigen::VectorXd>& times,
+                                     Eigen::MatrixXd& positions,
+                                     Eigen::MatrixXd& velocities,
+                                     Eigen::MatrixXd& accelerations) const;
+
+    /*! Get the number of DoF.
+     *  \return The dimension, 0 for an empty core.
+     */
+    virtual int getDimension() const = 0;
+
+    /*! Get the time at which the trajectory starts.
+     *  \return The start time.
+     */
+    virtual double getStartTime() const = 0;
+
+    /*! Get the time at which the trajectory ends.
+     *  \return The end time.
+     */
+    virtual double getEndTime() const = 0;
+
+    /*! Finds the segment of a piecewise trajectory which contains a given time. The search starts from the previously used segment so that a clock moving forward costs O(1), and falls back on a binary search otherwise.
+     *  \param knotTimes the increasing segment boundary times, segment i spans [knotTimes[i], knotTimes[i+1]]
+     *  \param time the time to look up, clamped to the first or last segment if out of bounds
+     *  \param segmentCursor the previously used segment, updated with the result
+     *  \return The segment index.
+     */
+    static int findSegment(const StdDoubleVector& knotTimes, const double time, int& segmentCursor);
+};
+
+using TrajectoryCorePtr = std::shared_ptr<const TrajectoryCore>;     /*!< A shared pointer to an immutable trajectory core. */
+
+} // end of namespace tgl
+#endif // TGL_TRAJECTORYCORE_H
@@ -0,0 +1,151 @@
+/*! \file       TrajectoryEvaluator.hpp
+ *  \brief      A lightweight per-thread evaluator of a shared trajectory core.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_TRAJECTORYEVALUATOR_H
+#define TGL_TRAJECTORYEVALUATOR_H
+
+// STL includes
+#include <chrono>
+#include <cstddef>
+
+// Eigen includes
+#include <Eigen/Dense>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/TrajectoryCore.hpp"
+#include "tgl/SampleRange.hpp"
+
+#ifndef TGL_USE_INTERNAL_CLOCK /*!< Tells the getDesired functions to use the internal trajectory clock. */
+#define TGL_USE_INTERNAL_CLOCK -1.0
+#endif
+
+#ifndef TGL_CACHE_LINE_SIZE /*!< The cache line size the evaluators are aligned to, so that evaluators used by different threads never share a line. */
+#define TGL_CACHE_LINE_SIZE 64
+#endif
+
+namespace tgl
+{
+
+/*! \class TrajectoryEvaluator
+ *  \brief A lightweight per-thread evaluator of a shared trajectory core.
+ *
+ *  The evaluator holds everything which changes while sampling a trajectory, its own internal clock and segment cursor, and a shared pointer to the immutable TrajectoryCore. Give each thread (controller, logger, visualizer, safety monitor...) its own evaluator on the same core: they sample it concurrently without locks, and since each evaluator is aligned to and padded out to its own cache line, the cursor updates of one thread do not invalidate the cache of the others.
+    ~~~~~~~~~~~~~~{.cpp}
+    tgl::CubicSplineTrajectory spline(wptSet);
+    tgl::TrajectoryCorePtr core = spline.getCore();
+    std::thread logger([core]() {
+        tgl::TrajectoryEvaluator evaluator(core);
+        Eigen::VectorXd pos, vel, acc;
+        while (evaluator.getDesired(pos, vel, acc) != tgl::TGL_FINISHED) { ... }
+    });
+    ~~~~~~~~~~~~~~
+ *  An evaluator must only be used by one thread at a time. The alignment holds for evaluators on the stack and allocated with `new`; in C++11 standard containers do not honour it, so keep evaluators in containers through pointers.
+ */
+class alignas(TGL_CACHE_LINE_SIZE) TrajectoryEvaluator {
+public:
+
+    /*! Basic constructor. The evaluator has no core until `setCore()`.
+     */
+    TrajectoryEvaluator();
+
+    /*! Initializing constructor.
+     *  \param newCore the core to evaluate
+     */
+    TrajectoryEvaluator(TrajectoryCorePtr newCore);
+
+    /*! Basic destructor. Does nothing.
+     */
+    ~TrajectoryEvaluator();
+
+    /*! Points the evaluator at a core, e.g. the one of a rebuilt trajectory, and resets its clock and cursor.
+     *  \param newCore the core to evaluate
+     *  \return TGL_OK on success, TGL_ERROR if the core is null.
+     */
+    TglMessage setCore(TrajectoryCorePtr newCore);
+
+    /*! Get the core being evaluated.
+     *  \return The shared core, null if none was set.
+     */
+    TrajectoryCorePtr getCore() const;
+
+    /*! Get the desired values from the core. Behaves like `Trajectory::getDesired()`, the internal clock is reset when the trajectory finishes.
+     *  \param desiredPos the position reference
+     *  \param desiredVel the velocity reference
+     *  \param desiredAcc the acceleration reference
+     *  \param time_step the time with which to calculate the desired values. If not given, will default to the internal clock.
+     *  \return A TglMessage indicating the status of the trajectory (see TglTypes.hpp)
+     */
+    TglMessage getDesired(  Eigen::VectorXd& desiredPos,
+                            Eigen::VectorXd& desiredVel,
+                            Eigen::VectorXd& desiredAcc,
+                            const double time_step=TGL_USE_INTERNAL_CLOCK);
+
+    /*! Get the desired values from the core at an explicit time. Unlike `getDesired()`, any time is a time: TGL_USE_INTERNAL_CLOCK (-1) is evaluated like the others, and the internal clock is neither read nor reset.
+     *  \param desiredPos the position reference
+     *  \param desiredVel the velocity reference
+     *  \param desiredAcc the acceleration reference
+     *  \param time the time with which to calculate the desired values
+     *  \return A TglMessage indicating the status of the trajectory (see TglTypes.hpp)
+     */
+    TglMessage getDesiredAt(Eigen::VectorXd& desiredPos,
+                            Eigen::VectorXd& desiredVel,
+                            Eigen::VectorXd& desiredAcc,
+                            const double time);
+
+    /*! Get a lazy range of samples for streaming the trajectory out. See SampleRange.
+     *  \param timeStep the time between samples (must be positive)
+     *  \param startTime the time of the first sample
+     *  \param endTime the time of the last sample
+     *  \return A single pass range evaluating the core through this evaluator as it is iterated.
+     */
+    SampleRange samples(const double timeStep, const double startTime, const double endTime);
+
+    /*! Resets the internal clock. The next call to `getDesired()` with the internal clock starts at time 0.
+     */
+    void resetInternalClock();
+
+    /*! Allocates evaluators on a cache line boundary.
+     */
+    static void* operator new(std::size_t size);
+
+    /*! Frees evaluators allocated with the aligned operator new.
+     */
+    static void operator delete(void* pointer);
+
+private:
+
+    TrajectoryCorePtr core;                                                     /*!< The core being evaluated. */
+    int segmentCursor;                                                          /*!< The last segment used, the starting point of the next segment search. */
+    bool internalClockResetTrigger;                                             /*!< Used to determine whether or not to reset the internal clock. */
+    std::chrono::time_point<std::chrono::system_clock> internalClockStartTime;  /*!< The time at which the internal clock was triggered. */
+};
+
+} // end of namespace tgl
+#endif // TGL_TRAJECTORYEVALUATOR_H
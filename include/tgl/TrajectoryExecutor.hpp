@@ -0,0 +1,94 @@
+/*! \file       TrajectoryExecutor.hpp
+ *  \brief      A small thread pool owned by the library which runs trajectory builds.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_TRAJECTORYEXECUTOR_H
+#define TGL_TRAJECTORYEXECUTOR_H
+
+// STL includes
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tgl
+{
+
+/*! \class TrajectoryExecutor
+ *  \brief A small thread pool owned by the library which runs trajectory builds.
+ *
+ *  Tasks are run in submission order by a fixed set of worker threads. The pool used by default is created on first use with one worker per hardware thread and lives until the program exits, so users never manage threads to build trajectories in the background. Own pools can be made to isolate builds, e.g. a single worker for a low priority planner.
+ *
+ *  The destructor lets the workers finish the queued tasks before joining them, so every submitted task runs exactly once.
+ */
+class TrajectoryExecutor {
+public:
+
+    /*! Initializing constructor. Starts the workers.
+     *  \param nThreads the number of worker threads, at least 1
+     */
+    TrajectoryExecutor(const int nThreads=1);
+
+    /*! Basic destructor. Runs the queued tasks and joins the workers.
+     */
+    ~TrajectoryExecutor();
+
+    /*! Queues a task.
+     *  \param task the function to run on a worker, it must not throw
+     */
+    void post(std::function<void()> task);
+
+    /*! Get the number of worker threads.
+     *  \return The number of workers.
+     */
+    int getNumberOfThreads() const;
+
+    /*! Get the pool used by default, created on first use.
+     *  \return The library-owned pool.
+     */
+    static TrajectoryExecutor& getDefault();
+
+private:
+
+    TrajectoryExecutor(const TrajectoryExecutor&);              /*!< Not copyable. */
+    TrajectoryExecutor& operator=(const TrajectoryExecutor&);   /*!< Not copyable. */
+
+    /*! The loop of the worker threads.
+     */
+    void work();
+
+    std::vector<std::thread> workers;               /*!< The worker threads. */
+    std::deque<std::function<void()>> tasks;        /*!< The queued tasks. */
+    std::mutex mutex;                               /*!< Protects the queue and the stop flag. */
+    std::condition_variable taskAvailable;          /*!< Signals the workers when a task is queued or the pool stops. */
+    bool stopping;                                  /*!< Set by the destructor. */
+};
+
+} // end of namespace tgl
+#endif // TGL_TRAJECTORYEXECUTOR_H
@@ -82,16 +82,31 @@ public:
      */
     Waypoint(const Eigen::Rotation3d& newWpt, double newWptTime = TGL_WAYPOINT_TIME_NOT_SPECIFIED);
 
-    //TODO: Fix this BUG.
+    /*! Initializing constructor. Creates a waypoint from a Wrenchd object which contains both torque and force.
+     *  \param newWpt a waypoint in torque and force
+     *  \param newWptTime the time at which the waypoint should occur. *If this is not specified then the waypoint time will not be set.*
+     */
+    Waypoint(const Eigen::Wrenchd& newWpt, double newWptTime = TGL_WAYPOINT_TIME_NOT_SPECIFIED);
 
-    // /* Initializing constructor. Creates a waypoint from a Wrenchd object which contains both torque and force.
-    //  *  \param newWpt a waypoint in torque and force
-    //  *  \param newWptTime the time at which the waypoint should occur. *If this is not specified then the waypoint time will not be set.*
-    //  */
-    // Waypoint(const Eigen::Wrenchd& newWpt, double newWptTime = TGL_WAYPOINT_TIME_NOT_SPECIFIED);
+    /*! Initializing constructor for Eigen expressions (e.g. `Waypoint(v * 2.0)`). The expression is evaluated into an Eigen::VectorXd waypoint.
+     *
+     *  Without this, an expression could be converted to either Eigen::VectorXd or Eigen::Wrenchd and the call would be ambiguous.
+     *  \param newWpt an Eigen expression of waypoint coordinates
+     *  \param newWptTime the time at which the waypoint should occur. *If this is not specified then the waypoint time will not be set.*
+     */
+    template<typename Derived>
+    Waypoint(const Eigen::MatrixBase<Derived>& newWpt, double newWptTime = TGL_WAYPOINT_TIME_NOT_SPECIFIED):
+    wptType(TGL_WPT_VECTOR_XD)
+    {
+        this->set(Eigen::VectorXd(newWpt), newWptTime);
+    }
 
     //TODO: Implement KDL versions of this.
 
+    /*! Copy constructor. Copies the same members as the assignment operator.
+     */
+    Waypoint(const Waypoint& other);
+
     /*! Assignment operator.
      */
     Waypoint& operator=(Waypoint other);
@@ -150,6 +165,16 @@ public:
      */
     TglMessage set(const Eigen::Wrenchd& newWpt, double newWptTime = TGL_WAYPOINT_TIME_NOT_SPECIFIED);
 
+    /*! Sets the waypoint from an Eigen expression, evaluated into an Eigen::VectorXd. See the matching constructor.
+     *  \param newWpt an Eigen expression of waypoint coordinates
+     *  \param newWptTime the time at which the waypoint should occur. *If this is not specified then the waypoint time will not be set.*
+     */
+    template<typename Derived>
+    TglMessage set(const Eigen::MatrixBase<Derived>& newWpt, double newWptTime = TGL_WAYPOINT_TIME_NOT_SPECIFIED)
+    {
+        return this->set(Eigen::VectorXd(newWpt), newWptTime);
+    }
+
     //TODO: Implement KDL versions of this.
 
     /*! Sets only the waypoint time. Note: This will erase the existing waypoint time.
@@ -184,6 +209,12 @@ public:
      */
     Eigen::Rotation3d getRotation();
 
+    /*! Get the waypoint as a wrench if it was built from one.
+     *  \return The waypoint wrench (torque then force).
+     *  \warning If the waypoint is not of type TGL_WPT_LGSM_WRENCH then a zero wrench will be returned.
+     */
+    Eigen::Wrenchd getWrench();
+
     /*! Get the waypoint time.
      *  \return The waypoint time.
      */
@@ -35,6 +35,7 @@
 #include <map>
 #include <cassert>
 #include <initializer_list>
+#include <limits>
 
 // Eigen includes
 #include <Eigen/Dense>
@@ -46,6 +47,11 @@
 #include "tgl/TglTools.hpp"
 #include "tgl/TglTypes.hpp"
 #include "tgl/Waypoint.hpp"
+#include "tgl/PerformanceCounters.hpp"
+
+#ifndef TGL_SIMPLIFY_PARALLEL_SIZE /*!< The number of waypoints from which a simplification range is split across threads. */
+#define TGL_SIMPLIFY_PARALLEL_SIZE 65536
+#endif
 
 
 namespace tgl
@@ -55,6 +61,10 @@ using StdWaypointVector = std::vector<Waypoint>;            /*!< A std vector of
 using WaypointMap = std::map<int, Waypoint>;                /*!< A map from a unique index to its corresponding Waypoint object. */
 using wptMapIterator = std::map<int, Waypoint>::iterator;   /*!< Waypoint map iterator. */
 using WaypointPair = std::pair<int, Waypoint>;              /*!< Key-value pair for inserting into a Waypoint map. */
+using RowMajorMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;   /*!< A dynamic matrix stored in row-major order. */
+using ConstMatrixMap = Eigen::Map<const Eigen::MatrixXd>;                   /*!< A read-only, column-major view onto waypoint data owned by a WaypointSet. */
+using ConstRowMajorMatrixMap = Eigen::Map<const RowMajorMatrixXd>;          /*!< A read-only, row-major view onto waypoint data owned by a WaypointSet. */
+using ConstVectorMap = Eigen::Map<const Eigen::VectorXd>;                   /*!< A read-only view onto a vector owned by a WaypointSet. */
 
 /*! \class WaypointSet
  *  \brief This class groups a set of waypoints into a manageable unit which allows us to handle tricky operations like adding/removing and inserting waypoints to an existing set.
@@ -77,6 +87,19 @@ public:
      */
     WaypointSet(std::initializer_list<Waypoint> il);
 
+    /*! Bulk constructor. Creates the set directly from a vector of times and a matrix of waypoint coordinates without building any intermediate Waypoint objects. See `assign()`.
+     *  \param times a vector of \f$ n \f$ strictly increasing waypoint times
+     *  \param coordinates a \f$ m \times n \f$ matrix with one waypoint per column
+     */
+    WaypointSet(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates);
+
+    /*! Bulk constructor for waypoints with orientations. See `assign()`.
+     *  \param times a vector of \f$ n \f$ strictly increasing waypoint times
+     *  \param coordinates a \f$ 3 \times n \f$ matrix of positions (TGL_WPT_LGSM_DISP) or a \f$ 0 \times n \f$ matrix for pure orientations (TGL_WPT_LGSM_QUAT)
+     *  \param quaternions a \f$ 4 \times n \f$ matrix of unit quaternions ordered \f$ [q_w, q_x, q_y, q_z]^T \f$
+     */
+    WaypointSet(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates, const Eigen::Ref<const Eigen::MatrixXd>& quaternions);
+
     /*! Destuctor. Currently does nothing.
      */
     ~WaypointSet();
@@ -86,6 +109,28 @@ public:
      */
     TglMessage setWaypoints(const StdWaypointVector& wptVec);
 
+    /*! Sets the waypoints directly from Eigen data. The coordinates are copied into the internal contiguous storage in a single block copy and all of the input is validated in one vectorized pass (finite values, non-negative times, matching sizes). Note: this is a clearing method and will erase any existing waypoints.
+     *  \param times a vector of \f$ n \f$ strictly increasing waypoint times
+     *  \param coordinates a \f$ m \times n \f$ matrix with one waypoint per column
+     *  \return TGL_OK on success, TGL_ERROR if the input is invalid (in which case the set is left untouched).
+     */
+    TglMessage assign(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates);
+
+    /*! Sets waypoints with orientations directly from Eigen data. Same as the coordinate-only version, plus the quaternions must have unit norm.
+     *  \param times a vector of \f$ n \f$ strictly increasing waypoint times
+     *  \param coordinates a \f$ 3 \times n \f$ matrix of positions (TGL_WPT_LGSM_DISP) or a \f$ 0 \times n \f$ matrix for pure orientations (TGL_WPT_LGSM_QUAT)
+     *  \param quaternions a \f$ 4 \times n \f$ matrix of unit quaternions ordered \f$ [q_w, q_x, q_y, q_z]^T \f$
+     *  \return TGL_OK on success, TGL_ERROR if the input is invalid (in which case the set is left untouched).
+     */
+    TglMessage assign(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates, const Eigen::Ref<const Eigen::MatrixXd>& quaternions);
+
+    /*! Sets wrench waypoints (TGL_WPT_LGSM_WRENCH) directly from Eigen data. Same as the coordinate-only `assign()` but the waypoints are typed as wrenches.
+     *  \param times a vector of \f$ n \f$ strictly increasing waypoint times
+     *  \param wrenches a \f$ 6 \times n \f$ matrix of wrenches ordered torque then force, like Eigen::Wrenchd
+     *  \return TGL_OK on success, TGL_ERROR if the input is invalid (in which case the set is left untouched).
+     */
+    TglMessage assignWrenches(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& wrenches);
+
     /*! Inserts a single waypoint to the WaypointSet. The waypoint will be inserted at the time specified.
      *  \param wpt a new Waypoint
      */
@@ -139,11 +184,44 @@ public:
      */
     Eigen::MatrixXd asMatrix(bool includeTimes = false, bool useRowFormat = false);
 
+    /*! Returns a read-only view of the waypoint coordinates as column vectors (same layout as `asMatrix(includeTimes, false)`) without copying anything.
+     *  \param includeTimes put the waypoint times at the top of each waypoint column vector
+     *  \return A map onto the internal contiguous storage of the set.
+     *  \warning The view points into memory owned by the WaypointSet. It is only valid as long as the set is alive and is invalidated by any modifying call (`setWaypoints()`, `insert()`, `push_back()`, `erase()` or assignment). Copy it into an Eigen::MatrixXd if you need to keep it longer.
+     */
+    ConstMatrixMap asMatrixView(bool includeTimes = false) const;
+
+    /*! Returns a read-only, row-major view of the waypoint coordinates with one waypoint per row (same values as `asMatrix(includeTimes, true)`) without copying anything.
+     *
+     *  The internal storage keeps each waypoint contiguous in memory, so reading it as a row-major \f$ n \times m \f$ matrix is exactly the transpose of the column view and needs no copy.
+     *  \param includeTimes put the waypoint time in the first column of each row
+     *  \return A row-major map onto the internal contiguous storage of the set.
+     *  \warning Same lifetime rules as `asMatrixView()`.
+     */
+    ConstRowMajorMatrixMap asRowMajorMatrixView(bool includeTimes = false) const;
+
     /*! Get the waypoint times as a vector.
      *  \return An Eigen::VectorXd containing the waypoint times
      */
     Eigen::VectorXd getWaypointTimes();
 
+    /*! Get a read-only view of the waypoint times without copying them.
+     *  \return A map onto the internal waypoint time vector.
+     *  \warning Same lifetime rules as `asMatrixView()`.
+     */
+    ConstVectorMap getWaypointTimesView() const;
+
+    /*! Get a read-only view of the waypoint quaternions, one per column and ordered \f$ [q_w, q_x, q_y, q_z]^T \f$.
+     *  \return A \f$ 4 \times n \f$ map, or a \f$ 4 \times 0 \f$ map if the waypoints have no rotation component.
+     *  \warning Same lifetime rules as `asMatrixView()`.
+     */
+    ConstMatrixMap rotationsAsMatrixView() const;
+
+    /*! Get the type of waypoints held by the set.
+     *  \return The TglWaypointType of the waypoints, TGL_WPT_NONE if the set is empty.
+     */
+    TglWaypointType getWaypointType() const;
+
     /*! Get the last waypoint time (equal to the total expected duration of the trajectory).
      *  \return The last waypoint vector time
      */
@@ -164,11 +242,30 @@ public:
      */
     Eigen::VectorXd getWaypointAtTime(const double time_step);
 
+    /*! Removes the waypoints which can be interpolated within a tolerance, with the Ramer-Douglas-Peucker algorithm. Between two kept waypoints, every removed waypoint lies within `tolerance` (Euclidean distance over all the coordinates) of the straight segment joining them and, if the waypoints have orientations, within `orientationTolerance` of the slerp between their quaternions at its time. The first and last waypoints are always kept, and kept waypoints keep their times.
+     *
+     *  Dense recordings often have millions of nearly collinear points, so the recursion is run as parallel tasks once ranges are large (see TGL_SIMPLIFY_PARALLEL_SIZE), and so is the farthest point search over the first, largest ranges. The result does not depend on the number of threads.
+     *  \param simplifiedSet the compact set of the kept waypoints
+     *  \param tolerance the maximum distance of a removed waypoint to the simplified path, in the units of the coordinates
+     *  \param orientationTolerance the maximum angle in radians between a removed orientation and the interpolated one, infinity to ignore orientations
+     *  \return TGL_OK on success, TGL_ERROR if the set is empty or the tolerances are negative.
+     */
+    TglMessage simplify(WaypointSet& simplifiedSet, const double tolerance, const double orientationTolerance=std::numeric_limits<double>::infinity()) const;
+
     /*! Check if the Waypoint Set is empty.
      *  \return An boolean which is true if empty, false otherwise.
      */
     bool empty();
 
+    /*! Get a snapshot of the performance counters of the set: its rebuilds (every successful assignment) with their timings and the bytes of the waypoint data, and its evaluations through `getWaypointAtTime()`. See PerformanceCounters.
+     *  \return The snapshot.
+     */
+    PerformanceCounters::Snapshot getPerformanceSnapshot() const;
+
+    /*! Sets the performance counters of the set to zero.
+     */
+    void resetPerformanceCounters();
+
 private:
 
     /*! Sets the waypoints in the WaypointMap. Note: this is a clearing method and will erase any existing waypoints.
@@ -180,11 +277,26 @@ private:
      */
     TglMessage fillFastWaypointVectors();
 
+    /*! Validates and copies bulk Eigen data into the fastVectors. Note: this is a clearing method and will erase the current waypoints.
+     *  \param times a vector of waypoint times
+     *  \param coordinates the waypoint coordinates, one waypoint per column
+     *  \param quaternions the waypoint quaternions, one per column, required for TGL_WPT_LGSM_DISP and TGL_WPT_LGSM_QUAT and ignored otherwise
+     *  \param newType the type of the waypoints described by the data
+     */
+    TglMessage setFastWaypointVectors(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates, const Eigen::Ref<const Eigen::MatrixXd>& quaternions, TglWaypointType newType);
+
+    /*! Get the memory held by the waypoint data, for the performance counters.
+     *  \return The size in bytes.
+     */
+    std::size_t getMemoryUsage() const;
 
-    WaypointMap wptMap;                         /*!< The waypoint map manipulared by this class. This is where we keep track of how the waypoints are arranged. */
+    WaypointMap wptMap;                         /*!< The waypoint map manipulared by this class. This is where we keep track of how the waypoints are arranged. Only filled when the set is built from Waypoint objects, bulk assignments go straight to the fastVectors. */
+    TglWaypointType wptType;                    /*!< The type of the waypoints in the set. */
     StdDoubleVector fastWptVector;              /*!< A contiguous vector of the waypoints flattened out. */
     StdDoubleVector fastWptTimesVector;         /*!< A contiguous vector of the waypoint times out. */
     StdDoubleVector fastWptVectorWithTimes;     /*!< A contiguous vector of the waypoint times and waypoints flattened out. */
+    StdDoubleVector fastWptRotationVector;      /*!< A contiguous vector of the waypoint quaternions (w, x, y, z) flattened out. Empty if the waypoints have no rotation. */
+    PerformanceCounters counters;               /*!< The performance counters, which are not copied with the waypoints. */
 };
 
 } // end of namespace tgl
@@ -0,0 +1,92 @@
+/*! \file       WrenchTrajectory.hpp
+ *  \brief      A force-profile trajectory interpolating wrench waypoints.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TGL_WRENCHTRAJECTORY_H
+#define TGL_WRENCHTRAJECTORY_H
+
+// Eigen includes
+#include <Eigen/Dense>
+#include <Eigen/Lgsm>
+
+// TGL includes
+#include "tgl/TglTools.hpp"
+#include "tgl/TglTypes.hpp"
+#include "tgl/CubicSplineTrajectory.hpp"
+
+namespace tgl
+{
+
+/*! \class WrenchTrajectory
+ *  \brief A force-profile trajectory which interpolates TGL_WPT_LGSM_WRENCH waypoints.
+ *
+ *  This is a CubicSplineTrajectory restricted to wrench waypoints, with a typed interface returning Eigen::Wrenchd objects (torque then force). It shares the allocation-free evaluation of the motion trajectories, so it can run in the same high-rate control loop as the motion reference.
+ */
+class WrenchTrajectory : public CubicSplineTrajectory {
+public:
+
+    /*! Basic constructor. Does nothing.
+     */
+    WrenchTrajectory();
+
+    /*! Initializing constructor. Sets waypoints and builds the spline.
+     *  \param newWptSet a Waypoint Set of TGL_WPT_LGSM_WRENCH waypoints with strictly increasing times.
+     */
+    WrenchTrajectory(const WaypointSet& newWptSet);
+
+    /*! Basic destructor. Does nothing.
+     */
+    virtual ~WrenchTrajectory();
+
+    using Trajectory::getDesired;
+
+    /*! Get the desired wrench and its first two time derivatives from the trajectory.
+     *  \param desiredWrench the wrench reference provided by the trajectory
+     *  \param desiredWrenchRate the first time derivative of the wrench reference
+     *  \param desiredWrenchRateDerivative the second time derivative of the wrench reference
+     *  \param time_step the time with which to calculate the desired values. If not given, will default to an interal clock.
+     *  \return A TglMessage indicating the status of the trajectory (see CubicSplineTrajectory::evaluate()).
+     */
+    TglMessage getDesired(  Eigen::Wrenchd& desiredWrench,
+                            Eigen::Wrenchd& desiredWrenchRate,
+                            Eigen::Wrenchd& desiredWrenchRateDerivative,
+                            const double time_step=TGL_USE_INTERNAL_CLOCK);
+
+protected:
+
+    /*! Only accepts TGL_WPT_LGSM_WRENCH waypoints.
+     */
+    virtual bool supportsWaypointType(TglWaypointType wptType) const;
+
+private:
+    Eigen::VectorXd wrenchBuffer;               /*!< Preallocated evaluation buffer for the wrench. */
+    Eigen::VectorXd wrenchRateBuffer;           /*!< Preallocated evaluation buffer for the wrench rate. */
+    Eigen::VectorXd wrenchRateDerivativeBuffer; /*!< Preallocated evaluation buffer for the wrench rate derivative. */
+};
+
+} // end of namespace tgl
+#endif // TGL_WRENCHTRAJECTORY_H
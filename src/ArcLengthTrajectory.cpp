@@ -0,0 +1,302 @@
+/*! \file       ArcLengthTrajectory.cpp
+ *  \brief      A constant speed trajectory along the arc-length parameterized spline through a Waypoint Set.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/ArcLengthTrajectory.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+#include <cmath>
+#include <memory>
+
+
+using namespace tgl;
+
+static const double gaussLegendreNodes[5] = {0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640};     /*!< The 5-point Gauss-Legendre nodes on [-1, 1]. */
+static const double gaussLegendreWeights[5] = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891}; /*!< The 5-point Gauss-Legendre weights. */
+
+/*! The quintic Hermite interpolant of the arc-length on a table interval, and its derivative with respect to the local coordinate.
+ *  \param u the local coordinate in [0, 1]
+ *  \param s0 the arc-length at the start of the interval
+ *  \param s1 the arc-length at the end of the interval
+ *  \param v0 the path speed at the start times the interval duration
+ *  \param v1 the path speed at the end times the interval duration
+ *  \param a0 the time derivative of the path speed at the start times the squared interval duration
+ *  \param a1 the time derivative of the path speed at the end times the squared interval duration
+ *  \param derivative the derivative of the interpolant with respect to u
+ *  \return The interpolated arc-length.
+ */
+static inline double interpolateArcLength(const double u, const double s0, const double s1, const double v0, const double v1, const double a0, const double a1, double& derivative)
+{
+    const double u2 = u * u, u3 = u2 * u, u4 = u3 * u, u5 = u4 * u;
+    derivative = (30.0 * u2 - 60.0 * u3 + 30.0 * u4) * (s1 - s0)
+               + (1.0 - 18.0 * u2 + 32.0 * u3 - 15.0 * u4) * v0 + (-12.0 * u2 + 28.0 * u3 - 15.0 * u4) * v1
+               + 0.5 * (2.0 * u - 9.0 * u2 + 12.0 * u3 - 5.0 * u4) * a0 + 0.5 * (3.0 * u2 - 8.0 * u3 + 5.0 * u4) * a1;
+    return s0 + (10.0 * u3 - 15.0 * u4 + 6.0 * u5) * (s1 - s0)
+         + (u - 6.0 * u3 + 8.0 * u4 - 3.0 * u5) * v0 + (-4.0 * u3 + 7.0 * u4 - 3.0 * u5) * v1
+         + 0.5 * (u2 - 3.0 * u3 + 3.0 * u4 - u5) * a0 + 0.5 * (u3 - 2.0 * u4 + u5) * a1;
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+ArcLengthTrajectory::ArcLengthTrajectory():
+pathCursor(0),
+speed(1.0),
+tableCursor(0)
+{
+}
+
+ArcLengthTrajectory::ArcLengthTrajectory(const WaypointSet& newWptSet, const double newSpeed):
+pathCursor(0),
+speed(1.0),
+tableCursor(0)
+{
+    if(!setSpeed(newSpeed) || !setWaypoints(newWptSet))
+        LOG(ERROR) << "Could not set the waypoints you passed to the trajectory.";
+}
+
+ArcLengthTrajectory::~ArcLengthTrajectory()
+{
+}
+
+TglMessage ArcLengthTrajectory::setWaypoints(const WaypointSet& newWptSet)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    tableTimes.clear();
+    tableLengths.clear();
+    tableSpeeds.clear();
+    tableSpeedRates.clear();
+    tableCursor = 0;
+
+    if (newWptSet.getWaypointType() != TGL_WPT_VECTOR_XD) {
+        LOG(ERROR) << "ArcLengthTrajectory needs waypoints of type TGL_WPT_VECTOR_XD, got " << newWptSet.getWaypointType() << ".";
+        return TGL_ERROR;
+    }
+    if (!path.setWaypoints(newWptSet)) {
+        return TGL_ERROR;
+    }
+    Trajectory::setWaypoints(newWptSet);
+    pathCore = std::static_pointer_cast<const PiecewisePolynomial>(path.getCore());
+    pathCursor = 0;
+
+    ConstVectorMap times = newWptSet.getWaypointTimesView();
+    double pathSpeed, pathSpeedRate;
+    getPathSpeed(times(0), pathSpeed, pathSpeedRate);
+    tableTimes.push_back(times(0));
+    tableLengths.push_back(0.0);
+    tableSpeeds.push_back(pathSpeed);
+    tableSpeedRates.push_back(pathSpeedRate);
+    for (int i = 0; i < times.size() - 1; ++i) {
+        // The tolerance is relative to the segment length, so it does not depend on the scale of the path or on the number of segments.
+        const double estimate = integratePathSpeed(times(i), times(i+1));
+        getPathSpeed(times(i+1), pathSpeed, pathSpeedRate);
+        buildTable(times(i), times(i+1), pathSpeed, pathSpeedRate, estimate, TGL_ARC_LENGTH_TOLERANCE * estimate, 0);
+    }
+    tableTimes.shrink_to_fit();
+    tableLengths.shrink_to_fit();
+    tableSpeeds.shrink_to_fit();
+    tableSpeedRates.shrink_to_fit();
+    countRebuild(buildStart);
+    return TGL_OK;
+}
+
+TglMessage ArcLengthTrajectory::setSpeed(const double newSpeed)
+{
+    if (newSpeed <= 0.0) {
+        LOG(ERROR) << "The speed must be positive, got " << newSpeed << ".";
+        return TGL_ERROR;
+    }
+    speed = newSpeed;
+    return TGL_OK;
+}
+
+double ArcLengthTrajectory::getSpeed() const
+{
+    return speed;
+}
+
+double ArcLengthTrajectory::getPathLength() const
+{
+    return tableLengths.empty() ? 0.0 : tableLengths.back();
+}
+
+double ArcLengthTrajectory::getDuration() const
+{
+    return getPathLength() / speed;
+}
+
+TglMessage ArcLengthTrajectory::getPathTime(const double arcLength, double& pathTime)
+{
+    if (tableTimes.empty()) {
+        LOG(ERROR) << "The trajectory has not been built. Set some waypoints first.";
+        return TGL_ERROR;
+    }
+    const double s = std::min(std::max(arcLength, 0.0), tableLengths.back());
+    const int k = findSegment(tableLengths, s, tableCursor);
+    const double h = tableTimes[k+1] - tableTimes[k];
+    const double s0 = tableLengths[k], s1 = tableLengths[k+1];
+    if (s1 <= s0) {
+        pathTime = tableTimes[k];
+        return TGL_OK;
+    }
+
+    // Newton on the interpolant inside the bracket [0, 1], from the linear guess.
+    const double v0 = h * tableSpeeds[k], v1 = h * tableSpeeds[k+1];
+    const double a0 = h * h * tableSpeedRates[k], a1 = h * h * tableSpeedRates[k+1];
+    double lower = 0.0, upper = 1.0;
+    double u = (s - s0) / (s1 - s0);
+    for (int iteration = 0; iteration < 20; ++iteration) {
+        double slope;
+        const double residual = interpolateArcLength(u, s0, s1, v0, v1, a0, a1, slope) - s;
+        if (std::abs(residual) <= 1e-15 * (1.0 + s1)) {
+            break;
+        }
+        if (residual > 0.0) {
+            upper = u;
+        } else {
+            lower = u;
+        }
+        double next = slope > 0.0 ? u - residual / slope : 0.5 * (lower + upper);
+        if (!(next > lower && next < upper)) {
+            next = 0.5 * (lower + upper);
+        }
+        u = next;
+    }
+    pathTime = tableTimes[k] + u * h;
+    return TGL_OK;
+}
+
+std::size_t ArcLengthTrajectory::getMemoryUsage() const
+{
+    return Trajectory::getMemoryUsage() + sizeof(ArcLengthTrajectory) - sizeof(Trajectory)
+         + path.getMemoryUsage() - sizeof(CubicSplineTrajectory)
+         + sizeof(double) * (tableTimes.capacity() + tableLengths.capacity() + tableSpeeds.capacity() + tableSpeedRates.capacity() + pathPos.size() + pathVel.size() + pathAcc.size());
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage ArcLengthTrajectory::getImplementationDesired(   Eigen::VectorXd& desiredPos,
+                                                            Eigen::VectorXd& desiredVel,
+                                                            Eigen::VectorXd& desiredAcc,
+                                                            const double time_step)
+{
+    if (tableTimes.empty()) {
+        TGL_REPORT_ERROR("The trajectory has not been built. Set some waypoints first.");
+        return TGL_ERROR;
+    }
+
+    TglMessage status = TGL_RUNNING;
+    double pathTime;
+    const double arcLength = speed * (time_step - tableTimes.front());
+    if (arcLength < 0.0) {
+        pathTime = tableTimes.front();
+        status = TGL_START;
+    } else if (arcLength >= tableLengths.back()) {
+        pathTime = tableTimes.back();
+        status = TGL_FINISHED;
+    } else {
+        getPathTime(arcLength, pathTime);
+    }
+
+    path.getDesired(pathPos, pathVel, pathAcc, pathTime);
+    desiredPos = pathPos;
+    desiredVel.resize(pathPos.size());
+    desiredAcc.resize(pathPos.size());
+    const double squaredPathSpeed = pathVel.squaredNorm();
+    if (status != TGL_RUNNING) {
+        desiredVel.setZero();
+        desiredAcc.setZero();
+    } else if (squaredPathSpeed < 1e-20) {
+        // The spline starts and ends at rest, the tangent is then along its acceleration.
+        desiredVel.noalias() = speed * pathAcc.normalized();
+        desiredAcc.setZero();
+    } else {
+        desiredVel.noalias() = (speed / std::sqrt(squaredPathSpeed)) * pathVel;
+        desiredAcc.noalias() = (speed * speed / squaredPathSpeed) * (pathAcc - (pathVel.dot(pathAcc) / squaredPathSpeed) * pathVel);
+    }
+    return status;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+double ArcLengthTrajectory::getPathSpeed(const double pathTime)
+{
+    pathCore->evaluate(pathPos, pathVel, pathAcc, pathTime, pathCursor);
+    return pathVel.norm();
+}
+
+void ArcLengthTrajectory::getPathSpeed(const double pathTime, double& pathSpeed, double& pathSpeedRate)
+{
+    pathSpeed = getPathSpeed(pathTime);
+    // At rest the speed grows like the norm of the acceleration.
+    pathSpeedRate = pathSpeed > 0.0 ? pathVel.dot(pathAcc) / pathSpeed : pathAcc.norm();
+}
+
+double ArcLengthTrajectory::integratePathSpeed(const double a, const double b)
+{
+    const double halfWidth = 0.5 * (b - a), center = 0.5 * (a + b);
+    double integral = 0.0;
+    for (int q = 0; q < 5; ++q) {
+        integral += gaussLegendreWeights[q] * getPathSpeed(center + halfWidth * gaussLegendreNodes[q]);
+    }
+    return halfWidth * integral;
+}
+
+void ArcLengthTrajectory::buildTable(const double a, const double b, const double speedB, const double speedRateB, const double estimate, const double tolerance, const int depth)
+{
+    const double middle = 0.5 * (a + b);
+    const double left = integratePathSpeed(a, middle);
+    const double right = integratePathSpeed(middle, b);
+    double speedMiddle, speedRateMiddle;
+    getPathSpeed(middle, speedMiddle, speedRateMiddle);
+
+    // Bisect until the quadrature has converged and the interpolant used by getPathTime() matches it at the middle.
+    const double h = b - a;
+    const double startLength = tableLengths.back();
+    double slope;
+    const double interpolated = interpolateArcLength(0.5, 0.0, estimate, h * tableSpeeds.back(), h * speedB, h * h * tableSpeedRates.back(), h * h * speedRateB, slope);
+    if (depth >= TGL_ARC_LENGTH_MAX_DEPTH || (std::abs(left + right - estimate) <= tolerance && std::abs(interpolated - left) <= tolerance)) {
+        tableTimes.push_back(middle);
+        tableLengths.push_back(startLength + left);
+        tableSpeeds.push_back(speedMiddle);
+        tableSpeedRates.push_back(speedRateMiddle);
+        tableTimes.push_back(b);
+        tableLengths.push_back(startLength + left + right);
+        tableSpeeds.push_back(speedB);
+        tableSpeedRates.push_back(speedRateB);
+        return;
+    }
+    buildTable(a, middle, speedMiddle, speedRateMiddle, left, 0.5 * tolerance, depth + 1);
+    buildTable(middle, b, speedB, speedRateB, right, 0.5 * tolerance, depth + 1);
+}
@@ -0,0 +1,166 @@
+/*! \file       AsyncTrajectoryBuilder.cpp
+ *  \brief      Builds trajectories in the background and hands out the latest one.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/AsyncTrajectoryBuilder.hpp"
+
+// STL includes
+#include <exception>
+
+
+using namespace tgl;
+
+/*! Makes the future of a request rejected before being queued.
+ */
+static std::shared_future<TrajectoryPtr> makeFailedFuture()
+{
+    std::promise<TrajectoryPtr> failed;
+    failed.set_value(TrajectoryPtr());
+    return failed.get_future().share();
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+AsyncTrajectoryBuilder::AsyncTrajectoryBuilder(TrajectoryExecutor& newExecutor):
+executor(newExecutor),
+state(std::make_shared<State>())
+{
+    state->generation = 0;
+    state->inFlight = 0;
+}
+
+AsyncTrajectoryBuilder::~AsyncTrajectoryBuilder()
+{
+    cancel();
+    wait();
+}
+
+std::shared_future<TrajectoryPtr> AsyncTrajectoryBuilder::submit(BuildFunction build, ReadyCallback onReady)
+{
+    std::shared_ptr<std::promise<TrajectoryPtr>> promise = std::make_shared<std::promise<TrajectoryPtr>>();
+    std::shared_future<TrajectoryPtr> future = promise->get_future().share();
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        ++state->inFlight;
+    }
+    const uint64_t id = ++state->generation;
+    std::shared_ptr<State> sharedState = state;
+    executor.post([sharedState, id, build, onReady, promise]() {
+        run(sharedState, id, build, onReady, *promise);
+    });
+    return future;
+}
+
+std::shared_future<TrajectoryPtr> AsyncTrajectoryBuilder::submit(TrajectoryPtr trajectory, const WaypointSet& wptSet, ReadyCallback onReady)
+{
+    if (!trajectory) {
+        LOG(ERROR) << "Can not build a null trajectory.";
+        return makeFailedFuture();
+    }
+    // Rebuilding the published trajectory in place would change it under the readers of getLatest(). The check is repeated when the build starts, in case an earlier request for the same object was published meanwhile.
+    if (trajectory == getLatest()) {
+        LOG(ERROR) << "Can not rebuild the latest trajectory in place, submit a new trajectory object.";
+        return makeFailedFuture();
+    }
+    std::shared_ptr<State> sharedState = state;
+    return submit([sharedState, trajectory, wptSet]() {
+        if (trajectory == std::atomic_load(&sharedState->latest)) {
+            LOG(ERROR) << "Can not rebuild the latest trajectory in place, submit a new trajectory object.";
+            return TrajectoryPtr();
+        }
+        return trajectory->setWaypoints(wptSet) ? trajectory : TrajectoryPtr();
+    }, onReady);
+}
+
+void AsyncTrajectoryBuilder::cancel()
+{
+    ++state->generation;
+}
+
+void AsyncTrajectoryBuilder::wait()
+{
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->idle.wait(lock, [this]() { return state->inFlight == 0; });
+}
+
+TrajectoryPtr AsyncTrajectoryBuilder::getLatest() const
+{
+    return std::atomic_load(&state->latest);
+}
+
+bool AsyncTrajectoryBuilder::isBuilding() const
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->inFlight > 0;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void AsyncTrajectoryBuilder::run(std::shared_ptr<State> state, const uint64_t id, const BuildFunction& build, const ReadyCallback& onReady, std::promise<TrajectoryPtr>& promise)
+{
+    TrajectoryPtr result;
+    if (state->generation == id) {
+        try {
+            result = build();
+        } catch (const std::exception& e) {
+            LOG(ERROR) << "The trajectory build threw: " << e.what();
+        } catch (...) {
+            LOG(ERROR) << "The trajectory build threw an unknown exception.";
+        }
+    }
+
+    // Publish unless a newer request came in meanwhile. The check and the store are atomic with respect to the other builds.
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (result && state->generation == id) {
+            std::atomic_store(&state->latest, result);
+        } else {
+            result.reset();
+        }
+    }
+    promise.set_value(result);
+    // A throwing callback must not escape into the executor nor skip the count below, or wait() would never return.
+    if (result && onReady) {
+        try {
+            onReady(result);
+        } catch (const std::exception& e) {
+            LOG(ERROR) << "The trajectory ready callback threw: " << e.what();
+        } catch (...) {
+            LOG(ERROR) << "The trajectory ready callback threw an unknown exception.";
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (--state->inFlight == 0) {
+        state->idle.notify_all();
+    }
+}
@@ -0,0 +1,196 @@
+/*! \file       BlendedTrajectory.cpp
+ *  \brief      A trajectory layer which blends online into new paths as goals stream in.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/BlendedTrajectory.hpp"
+#include "tgl/TglDiagnostics.hpp"
+#include "tgl/CubicSplineTrajectory.hpp"
+
+#include <algorithm>
+#include <limits>
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+BlendedTrajectory::BlendedTrajectory():
+segmentCursor(0)
+{
+}
+
+BlendedTrajectory::BlendedTrajectory(TrajectoryPtr initialPath):
+segmentCursor(0)
+{
+    if(!setPath(initialPath))
+        LOG(ERROR) << "Could not set the initial path of the trajectory.";
+}
+
+BlendedTrajectory::~BlendedTrajectory()
+{
+}
+
+TglMessage BlendedTrajectory::setPath(TrajectoryPtr newPath)
+{
+    if (!newPath) {
+        LOG(ERROR) << "The path is null.";
+        return TGL_ERROR;
+    }
+    pieces.clear();
+    pieceBounds.clear();
+    segmentCursor = 0;
+    appendPiece(0.0, newPath, Eigen::MatrixXd());
+    return resetInternalClock();
+}
+
+TglMessage BlendedTrajectory::setWaypoints(const WaypointSet& newWptSet)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    TrajectoryPtr newPath = std::make_shared<CubicSplineTrajectory>();
+    if (!newPath->setWaypoints(newWptSet)) {
+        return TGL_ERROR;
+    }
+    Trajectory::setWaypoints(newWptSet);
+    const TglMessage result = setPath(newPath);
+    if (result) {
+        countRebuild(buildStart);
+    }
+    return result;
+}
+
+TglMessage BlendedTrajectory::blendTo(TrajectoryPtr newPath, const double switchTime, const double blendDuration)
+{
+    if (pieces.empty()) {
+        LOG(ERROR) << "There is no current motion to blend from. Use setPath() first.";
+        return TGL_ERROR;
+    }
+    if (!newPath || blendDuration <= 0.0) {
+        LOG(ERROR) << "Blending needs a valid path and a positive blend duration.";
+        return TGL_ERROR;
+    }
+
+    // Boundary conditions of the blend: the current motion at the switch time and the new path at the end of the blend.
+    Eigen::VectorXd p0, v0, a0, p1, v1, a1;
+    if (!getImplementationDesired(p0, v0, a0, switchTime) || !newPath->getDesired(p1, v1, a1, switchTime + blendDuration)) {
+        LOG(ERROR) << "Could not evaluate the blend boundary conditions.";
+        return TGL_ERROR;
+    }
+    if (p0.size() != p1.size()) {
+        LOG(ERROR) << "The new path dimension (" << p1.size() << ") does not match the current one (" << p0.size() << ").";
+        return TGL_ERROR;
+    }
+
+    const double T = blendDuration;
+    Eigen::MatrixXd blendCoefficients(p0.size(), 6);
+    blendCoefficients.col(0) = p0;
+    blendCoefficients.col(1) = v0;
+    blendCoefficients.col(2) = a0 / 2.0;
+    blendCoefficients.col(3) = (20.0*(p1 - p0) - (8.0*v1 + 12.0*v0)*T - (3.0*a0 - a1)*T*T) / (2.0*T*T*T);
+    blendCoefficients.col(4) = (30.0*(p0 - p1) + (14.0*v1 + 16.0*v0)*T + (3.0*a0 - 2.0*a1)*T*T) / (2.0*T*T*T*T);
+    blendCoefficients.col(5) = (12.0*(p1 - p0) - 6.0*(v1 + v0)*T - (a0 - a1)*T*T) / (2.0*T*T*T*T*T);
+
+    // Everything after the switch and everything which ended before it goes, only the blend and the new path are added.
+    const int current = findSegment(pieceBounds, switchTime, segmentCursor);
+    Piece currentPiece = pieces[current];
+    double currentStart = pieceBounds[current];
+    pieces.clear();
+    pieceBounds.clear();
+    segmentCursor = 0;
+    if (switchTime > currentStart) {
+        appendPiece(currentStart, currentPiece.path, currentPiece.blendCoefficients);
+    }
+    appendPiece(switchTime, TrajectoryPtr(), blendCoefficients);
+    appendPiece(switchTime + blendDuration, newPath, Eigen::MatrixXd());
+    return TGL_OK;
+}
+
+TglMessage BlendedTrajectory::blendTo(const WaypointSet& newWptSet, const double switchTime, const double blendDuration)
+{
+    TrajectoryPtr newPath = std::make_shared<CubicSplineTrajectory>();
+    if (!newPath->setWaypoints(newWptSet)) {
+        return TGL_ERROR;
+    }
+    return blendTo(newPath, switchTime, blendDuration);
+}
+
+int BlendedTrajectory::getNumberOfPieces() const
+{
+    return pieces.size();
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage BlendedTrajectory::getImplementationDesired( Eigen::VectorXd& desiredPos,
+                                                        Eigen::VectorXd& desiredVel,
+                                                        Eigen::VectorXd& desiredAcc,
+                                                        const double time_step)
+{
+    if (pieces.empty()) {
+        TGL_REPORT_ERROR("The trajectory has no path. Use setPath() first.");
+        return TGL_ERROR;
+    }
+
+    const int p = findSegment(pieceBounds, time_step, segmentCursor);
+    const Piece& piece = pieces[p];
+    if (piece.path) {
+        return piece.path->getDesired(desiredPos, desiredVel, desiredAcc, time_step);
+    }
+
+    const Eigen::MatrixXd& c = piece.blendCoefficients;
+    const double dt = std::max(time_step - pieceBounds[p], 0.0);
+    desiredPos.resize(c.rows());
+    desiredVel.resize(c.rows());
+    desiredAcc.resize(c.rows());
+    desiredPos.noalias() = c.col(0) + dt * (c.col(1) + dt * (c.col(2) + dt * (c.col(3) + dt * (c.col(4) + dt * c.col(5)))));
+    desiredVel.noalias() = c.col(1) + dt * (2.0 * c.col(2) + dt * (3.0 * c.col(3) + dt * (4.0 * c.col(4) + dt * 5.0 * c.col(5))));
+    desiredAcc.noalias() = 2.0 * c.col(2) + dt * (6.0 * c.col(3) + dt * (12.0 * c.col(4) + dt * 20.0 * c.col(5)));
+    return TGL_RUNNING;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void BlendedTrajectory::appendPiece(const double startTime, TrajectoryPtr path, const Eigen::MatrixXd& blendCoefficients)
+{
+    Piece newPiece;
+    newPiece.path = path;
+    newPiece.blendCoefficients = blendCoefficients;
+    pieces.push_back(newPiece);
+    if (pieceBounds.empty()) {
+        pieceBounds.push_back(startTime);
+    } else {
+        pieceBounds.back() = startTime;
+    }
+    pieceBounds.push_back(std::numeric_limits<double>::infinity());
+}
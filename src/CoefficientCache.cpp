@@ -0,0 +1,277 @@
+/*! \file       CoefficientCache.cpp
+ *  \brief      A persistent on-disk cache of piecewise polynomial coefficients keyed by a waypoint content hash.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/CoefficientCache.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+
+// POSIX includes
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+/*! The header at the start of every cache file. All fields are 4 or 8 bytes wide so the layout has no padding.
+ */
+struct CacheFileHeader {
+    char magic[4];          /*!< Always "TGLC". */
+    uint32_t version;       /*!< TGL_COEFFICIENT_CACHE_VERSION when written. */
+    uint32_t byteOrder;     /*!< 0x01020304 in the byte order of the writer. */
+    uint32_t reserved;      /*!< Zero. */
+    uint64_t key;           /*!< The cache key. */
+    uint64_t nKnots;        /*!< The number of knot times. */
+    uint64_t rows;          /*!< The number of coefficient rows. */
+    uint64_t cols;          /*!< The number of coefficient columns. */
+    uint64_t checksum;      /*!< FNV-1a hash of the payload. */
+};
+
+static const uint32_t cacheByteOrder = 0x01020304;
+static const char cacheFileExtension[] = ".tglc";
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+CoefficientCache::CoefficientCache(const std::string& newDirectory, const std::size_t newMaxBytes):
+directory(newDirectory),
+maxBytes(newMaxBytes)
+{
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOG(ERROR) << "Could not create the coefficient cache directory " << directory << ": " << std::strerror(errno) << ".";
+    }
+}
+
+CoefficientCache::~CoefficientCache()
+{
+}
+
+uint64_t CoefficientCache::computeKey(const WaypointSet& wptSet, const std::string& generator, const Eigen::VectorXd& parameters)
+{
+    ConstVectorMap times = wptSet.getWaypointTimesView();
+    ConstMatrixMap coordinates = wptSet.asMatrixView();
+    ConstMatrixMap rotations = wptSet.rotationsAsMatrixView();
+    int64_t sizes[4] = {int64_t(wptSet.getWaypointType()), int64_t(times.size()), int64_t(coordinates.rows()), int64_t(rotations.cols())};
+
+    uint64_t hash = TglTools::hashBytes(sizes, sizeof(sizes));
+    hash = TglTools::hashBytes(times.data(), sizeof(double) * times.size(), hash);
+    hash = TglTools::hashBytes(coordinates.data(), sizeof(double) * coordinates.size(), hash);
+    hash = TglTools::hashBytes(rotations.data(), sizeof(double) * rotations.size(), hash);
+    hash = TglTools::hashBytes(generator.data(), generator.size(), hash);
+    hash = TglTools::hashBytes(parameters.data(), sizeof(double) * parameters.size(), hash);
+    return hash;
+}
+
+TglMessage CoefficientCache::load(const uint64_t key, StdDoubleVector& knotTimes, Eigen::MatrixXd& coefficients)
+{
+    const std::string path = getEntryPath(key);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return TGL_WARNING;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(CacheFileHeader)) {
+        close(fd);
+        LOG(WARNING) << "Coefficient cache entry " << path << " is truncated, deleting it.";
+        unlink(path.c_str());
+        return TGL_WARNING;
+    }
+    const std::size_t fileSize = fileStat.st_size;
+    void* mapped = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        LOG(WARNING) << "Could not map coefficient cache entry " << path << ": " << std::strerror(errno) << ".";
+        return TGL_WARNING;
+    }
+
+    CacheFileHeader header;
+    std::memcpy(&header, mapped, sizeof(header));
+    const double* payload = reinterpret_cast<const double*>(static_cast<const char*>(mapped) + sizeof(header));
+    // Bound each size by the doubles actually in the file before multiplying them, so a corrupted header can not overflow the payload size.
+    const uint64_t maxDoubles = (fileSize - sizeof(header)) / sizeof(double);
+    const bool sizesValid = header.nKnots <= maxDoubles && header.rows <= maxDoubles && header.cols <= maxDoubles
+                         && (header.rows == 0 || header.cols <= (maxDoubles - header.nKnots) / header.rows);
+    const uint64_t payloadSize = sizesValid ? sizeof(double) * (header.nKnots + header.rows * header.cols) : 0;
+    bool valid = sizesValid
+              && std::memcmp(header.magic, "TGLC", 4) == 0
+              && header.version == TGL_COEFFICIENT_CACHE_VERSION
+              && header.byteOrder == cacheByteOrder
+              && header.key == key
+              && fileSize == sizeof(header) + payloadSize
+              && TglTools::hashBytes(payload, payloadSize) == header.checksum;
+    if (valid) {
+        knotTimes.assign(payload, payload + header.nKnots);
+        coefficients = Eigen::Map<const Eigen::MatrixXd>(payload + header.nKnots, header.rows, header.cols);
+    }
+    munmap(mapped, fileSize);
+
+    if (!valid) {
+        LOG(WARNING) << "Coefficient cache entry " << path << " is corrupted or outdated, deleting it.";
+        unlink(path.c_str());
+        return TGL_WARNING;
+    }
+    // Refresh the modification time, which is the LRU order.
+    utimensat(AT_FDCWD, path.c_str(), NULL, 0);
+    return TGL_OK;
+}
+
+TglMessage CoefficientCache::store(const uint64_t key, const StdDoubleVector& knotTimes, const Eigen::MatrixXd& coefficients)
+{
+    CacheFileHeader header;
+    std::memcpy(header.magic, "TGLC", 4);
+    header.version = TGL_COEFFICIENT_CACHE_VERSION;
+    header.byteOrder = cacheByteOrder;
+    header.reserved = 0;
+    header.key = key;
+    header.nKnots = knotTimes.size();
+    header.rows = coefficients.rows();
+    header.cols = coefficients.cols();
+    header.checksum = TglTools::hashBytes(coefficients.data(), sizeof(double) * coefficients.size(), TglTools::hashBytes(knotTimes.data(), sizeof(double) * knotTimes.size()));
+
+    // Write a temporary file and rename it, readers never see a partial entry.
+    // The temporary name is unique, so threads or processes storing the same key never write the same file.
+    const std::string path = getEntryPath(key);
+    std::string temporaryPath = path + ".tmpXXXXXX";
+    const int fd = mkstemp(&temporaryPath[0]);
+    FILE* file = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    if (!file) {
+        LOG(ERROR) << "Could not write the coefficient cache entry " << temporaryPath << ": " << std::strerror(errno) << ".";
+        if (fd >= 0) {
+            close(fd);
+            unlink(temporaryPath.c_str());
+        }
+        return TGL_ERROR;
+    }
+    fchmod(fd, 0644);
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+                && std::fwrite(knotTimes.data(), sizeof(double), knotTimes.size(), file) == knotTimes.size()
+                && std::fwrite(coefficients.data(), sizeof(double), coefficients.size(), file) == (std::size_t)coefficients.size();
+    written &= std::fclose(file) == 0;
+    if (!written || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        LOG(ERROR) << "Could not write the coefficient cache entry " << path << ".";
+        unlink(temporaryPath.c_str());
+        return TGL_ERROR;
+    }
+
+    evict(path);
+    return TGL_OK;
+}
+
+void CoefficientCache::clear()
+{
+    for (const Entry& entry : listEntries()) {
+        unlink(entry.path.c_str());
+    }
+}
+
+std::size_t CoefficientCache::getSizeOnDisk() const
+{
+    std::size_t size = 0;
+    for (const Entry& entry : listEntries()) {
+        size += entry.size;
+    }
+    return size;
+}
+
+std::string CoefficientCache::getDirectory() const
+{
+    return directory;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+std::vector<CoefficientCache::Entry> CoefficientCache::listEntries() const
+{
+    std::vector<Entry> entries;
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) {
+        return entries;
+    }
+    const std::size_t extensionLength = std::strlen(cacheFileExtension);
+    while (struct dirent* dirEntry = readdir(dir)) {
+        std::string name(dirEntry->d_name);
+        if (name.size() <= extensionLength || name.compare(name.size() - extensionLength, extensionLength, cacheFileExtension) != 0) {
+            continue;
+        }
+        Entry entry;
+        entry.path = directory + "/" + name;
+        struct stat fileStat;
+        if (stat(entry.path.c_str(), &fileStat) != 0) {
+            continue;
+        }
+        entry.size = fileStat.st_size;
+        entry.lastUse = int64_t(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+        entries.push_back(entry);
+    }
+    closedir(dir);
+    return entries;
+}
+
+void CoefficientCache::evict(const std::string& keptPath)
+{
+    std::vector<Entry> entries = listEntries();
+    std::size_t size = 0;
+    for (const Entry& entry : entries) {
+        size += entry.size;
+    }
+    if (size <= maxBytes) {
+        return;
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b){ return a.lastUse < b.lastUse; });
+    for (const Entry& entry : entries) {
+        if (size <= maxBytes) {
+            break;
+        }
+        if (entry.path != keptPath && unlink(entry.path.c_str()) == 0) {
+            size -= entry.size;
+        }
+    }
+}
+
+std::string CoefficientCache::getEntryPath(const uint64_t key) const
+{
+    std::ostringstream path;
+    path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << cacheFileExtension;
+    return path.str();
+}
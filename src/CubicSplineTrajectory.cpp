@@ -0,0 +1,372 @@
+/*! \file       CubicSplineTrajectory.cpp
+ *  \brief      A clamped cubic spline trajectory through vector or wrench waypoints.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/CubicSplineTrajectory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+CubicSplineTrajectory::CubicSplineTrajectory():
+core(std::make_shared<PiecewisePolynomial>()),
+segmentCursor(0),
+projectionWindow(std::numeric_limits<double>::infinity()),
+lastProjectionTime(0.0)
+{
+}
+
+CubicSplineTrajectory::CubicSplineTrajectory(const WaypointSet& newWptSet):
+core(std::make_shared<PiecewisePolynomial>()),
+segmentCursor(0),
+projectionWindow(std::numeric_limits<double>::infinity()),
+lastProjectionTime(0.0)
+{
+    if(!setWaypoints(newWptSet))
+        LOG(ERROR) << "Could not set the waypoints you passed to the trajectory.";
+}
+
+CubicSplineTrajectory::~CubicSplineTrajectory()
+{
+}
+
+TglMessage CubicSplineTrajectory::setWaypoints(const WaypointSet& newWptSet)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    core = std::make_shared<PiecewisePolynomial>();
+    segmentCursor = 0;
+    segmentBvh.clear();
+
+    if (!supportsWaypointType(newWptSet.getWaypointType())) {
+        LOG(ERROR) << "This trajectory can not use waypoints of type " << newWptSet.getWaypointType() << ".";
+        return TGL_ERROR;
+    }
+
+    ConstVectorMap times = newWptSet.getWaypointTimesView();
+    ConstMatrixMap wpts = newWptSet.asMatrixView();
+    const int nWpts = times.size();
+    const int nDof = wpts.rows();
+
+    if (nWpts < 2) {
+        LOG(ERROR) << "A cubic spline needs at least 2 waypoints, got " << nWpts << ".";
+        return TGL_ERROR;
+    }
+    if ((times.tail(nWpts - 1) - times.head(nWpts - 1)).minCoeff() <= 0.0) {
+        LOG(ERROR) << "A cubic spline needs strictly increasing waypoint times.";
+        return TGL_ERROR;
+    }
+
+    Trajectory::setWaypoints(newWptSet);
+
+    // Clamped spline moments M (second derivatives), from the tridiagonal system
+    // h_{i-1} M_{i-1} + 2 (h_{i-1} + h_i) M_i + h_i M_{i+1} = 6 (s_i - s_{i-1}), with zero end slopes.
+    Eigen::VectorXd h = times.tail(nWpts - 1) - times.head(nWpts - 1);
+    Eigen::MatrixXd slopes(nDof, nWpts - 1);
+    for (int i = 0; i < nWpts - 1; ++i) {
+        slopes.col(i) = (wpts.col(i+1) - wpts.col(i)) / h(i);
+    }
+
+    Eigen::VectorXd lower(nWpts), diag(nWpts), upper(nWpts);
+    Eigen::MatrixXd rhs(nDof, nWpts);
+    lower(0) = 0.0;             diag(0) = 2.0 * h(0);                   upper(0) = h(0);
+    rhs.col(0) = 6.0 * slopes.col(0);
+    for (int i = 1; i < nWpts - 1; ++i) {
+        lower(i) = h(i-1);      diag(i) = 2.0 * (h(i-1) + h(i));        upper(i) = h(i);
+        rhs.col(i) = 6.0 * (slopes.col(i) - slopes.col(i-1));
+    }
+    lower(nWpts-1) = h(nWpts-2); diag(nWpts-1) = 2.0 * h(nWpts-2);       upper(nWpts-1) = 0.0;
+    rhs.col(nWpts-1) = -6.0 * slopes.col(nWpts-2);
+
+    // Thomas algorithm, all DoF at once.
+    for (int i = 1; i < nWpts; ++i) {
+        double w = lower(i) / diag(i-1);
+        diag(i) -= w * upper(i-1);
+        rhs.col(i) -= w * rhs.col(i-1);
+    }
+    Eigen::MatrixXd moments(nDof, nWpts);
+    moments.col(nWpts-1) = rhs.col(nWpts-1) / diag(nWpts-1);
+    for (int i = nWpts - 2; i >= 0; --i) {
+        moments.col(i) = (rhs.col(i) - upper(i) * moments.col(i+1)) / diag(i);
+    }
+
+    Eigen::MatrixXd coefficients(nDof, 4 * (nWpts - 1));
+    for (int i = 0; i < nWpts - 1; ++i) {
+        coefficients.col(4*i)   = wpts.col(i);
+        coefficients.col(4*i+1) = slopes.col(i) - h(i) * (2.0 * moments.col(i) + moments.col(i+1)) / 6.0;
+        coefficients.col(4*i+2) = moments.col(i) / 2.0;
+        coefficients.col(4*i+3) = (moments.col(i+1) - moments.col(i)) / (6.0 * h(i));
+    }
+    core = std::make_shared<PiecewisePolynomial>(StdDoubleVector(times.data(), times.data() + nWpts), std::move(coefficients), 4);
+
+    buildBoundingVolumes();
+
+    countRebuild(buildStart);
+    return TGL_OK;
+}
+
+TglMessage CubicSplineTrajectory::setWaypoints(const WaypointSet& newWptSet, CoefficientCache& cache)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    const uint64_t key = CoefficientCache::computeKey(newWptSet, "CubicSplineTrajectory/1");
+    StdDoubleVector cachedKnotTimes;
+    Eigen::MatrixXd cachedCoefficients;
+    const int nWpts = newWptSet.getWaypointTimesView().size();
+    if (supportsWaypointType(newWptSet.getWaypointType()) && nWpts >= 2
+        && cache.load(key, cachedKnotTimes, cachedCoefficients) == TGL_OK
+        && (int)cachedKnotTimes.size() == nWpts
+        && std::equal(cachedKnotTimes.begin(), cachedKnotTimes.end(), newWptSet.getWaypointTimesView().data())
+        && cachedCoefficients.rows() == newWptSet.asMatrixView().rows()
+        && cachedCoefficients.cols() == 4 * (nWpts - 1)) {
+        Trajectory::setWaypoints(newWptSet);
+        core = std::make_shared<PiecewisePolynomial>(std::move(cachedKnotTimes), std::move(cachedCoefficients), 4);
+        segmentCursor = 0;
+        buildBoundingVolumes();
+        countRebuild(buildStart);
+        return TGL_OK;
+    }
+
+    if (!setWaypoints(newWptSet)) {
+        return TGL_ERROR;
+    }
+    // Failing to store only costs a solve next time, the trajectory itself is fine.
+    cache.store(key, core->getKnotTimes(), core->getCoefficients());
+    return TGL_OK;
+}
+
+TglMessage CubicSplineTrajectory::setCore(std::shared_ptr<const PiecewisePolynomial> newCore)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    core = std::make_shared<PiecewisePolynomial>();
+    segmentCursor = 0;
+    segmentBvh.clear();
+
+    if (!newCore || newCore->empty() || newCore->getOrder() != 4) {
+        LOG(ERROR) << "A cubic spline needs a non-empty core of order 4.";
+        return TGL_ERROR;
+    }
+
+    const StdDoubleVector& knotTimes = newCore->getKnotTimes();
+    const Eigen::MatrixXd& coefficients = newCore->getCoefficients();
+    const int nSegments = knotTimes.size() - 1;
+    Eigen::MatrixXd positions(coefficients.rows(), nSegments + 1);
+    for (int i = 0; i < nSegments; ++i) {
+        positions.col(i) = coefficients.col(4*i);
+    }
+    const double h = knotTimes[nSegments] - knotTimes[nSegments - 1];
+    positions.col(nSegments) = ((coefficients.col(4*nSegments-1) * h + coefficients.col(4*nSegments-2)) * h + coefficients.col(4*nSegments-3)) * h + coefficients.col(4*nSegments-4);
+
+    WaypointSet knotWpts;
+    if (!knotWpts.assign(Eigen::Map<const Eigen::VectorXd>(knotTimes.data(), nSegments + 1), positions)) {
+        return TGL_ERROR;
+    }
+    Trajectory::setWaypoints(knotWpts);
+    core = std::move(newCore);
+    buildBoundingVolumes();
+    countRebuild(buildStart);
+    return TGL_OK;
+}
+
+std::size_t CubicSplineTrajectory::getMemoryUsage() const
+{
+    return Trajectory::getMemoryUsage() + sizeof(CubicSplineTrajectory) - sizeof(Trajectory)
+         + core->getMemoryUsage() + segmentBvh.getMemoryUsage();
+}
+
+TrajectoryCorePtr CubicSplineTrajectory::getCore() const
+{
+    return core;
+}
+
+int CubicSplineTrajectory::getDimension() const
+{
+    return core->getDimension();
+}
+
+TglMessage CubicSplineTrajectory::getClosestTime(const Eigen::VectorXd& point, double& closestTime, double& distance)
+{
+    return getClosestTimeNear(point, lastProjectionTime, std::numeric_limits<double>::infinity(), closestTime, distance);
+}
+
+TglMessage CubicSplineTrajectory::getClosestTimeNear(const Eigen::VectorXd& point, const double previousTime, const double timeWindow, double& closestTime, double& distance)
+{
+    const StdDoubleVector& knotTimes = core->getKnotTimes();
+    const Eigen::MatrixXd& coefficients = core->getCoefficients();
+    if (knotTimes.empty()) {
+        LOG(ERROR) << "The trajectory has not been built. Set some waypoints first.";
+        return TGL_ERROR;
+    }
+    if (point.size() != coefficients.rows()) {
+        LOG(ERROR) << "The point dimension (" << point.size() << ") does not match the spline dimension (" << coefficients.rows() << ").";
+        return TGL_ERROR;
+    }
+
+    int cursor = segmentCursor;
+    const int firstSegment = findSegment(knotTimes, previousTime - timeWindow, cursor);
+    const int lastSegment = findSegment(knotTimes, previousTime + timeWindow, cursor);
+    const int warmSegment = findSegment(knotTimes, previousTime, cursor);
+
+    // The segment of the previous answer gives a tight bound from the start, so most of the tree is pruned.
+    double localTime;
+    int bestSegment = warmSegment;
+    distance = getSegmentDistance(warmSegment, point, localTime);
+    segmentBvh.nearest(point, firstSegment, lastSegment,
+                       [&](int s, double){ double t; return getSegmentDistance(s, point, t); },
+                       bestSegment, distance);
+    if (bestSegment != warmSegment) {
+        getSegmentDistance(bestSegment, point, localTime);
+    }
+    closestTime = knotTimes[bestSegment] + localTime;
+    return TGL_OK;
+}
+
+void CubicSplineTrajectory::setProjectionWindow(const double newProjectionWindow)
+{
+    projectionWindow = newProjectionWindow;
+}
+
+
+TglMessage CubicSplineTrajectory::verifyLimits(const Eigen::VectorXd& maxVel,
+                                                const Eigen::VectorXd& maxAcc,
+                                                const Eigen::VectorXd& maxJerk,
+                                                std::vector<TglLimitViolation>& violations) const
+{
+    return core->verifyLimits(maxVel, maxAcc, maxJerk, violations);
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage CubicSplineTrajectory::getImplementationDesired(  Eigen::VectorXd& desiredPos,
+                                                            Eigen::VectorXd& desiredVel,
+                                                            Eigen::VectorXd& desiredAcc,
+                                                            const double time_step)
+{
+    return evaluate(time_step, desiredPos, desiredVel, desiredAcc);
+}
+
+TglMessage CubicSplineTrajectory::getImplementationDesired(  Eigen::VectorXd& desiredPos,
+                                                            Eigen::VectorXd& desiredVel,
+                                                            Eigen::VectorXd& desiredAcc,
+                                                            const Eigen::VectorXd& currentPos,
+                                                            const Eigen::VectorXd&,
+                                                            const Eigen::VectorXd&,
+                                                            const double)
+{
+    double closestTime, distance;
+    if (!getClosestTimeNear(currentPos, lastProjectionTime, projectionWindow, closestTime, distance)) {
+        return TGL_ERROR;
+    }
+    lastProjectionTime = closestTime;
+    return evaluate(closestTime, desiredPos, desiredVel, desiredAcc);
+}
+
+TglMessage CubicSplineTrajectory::evaluate(const double time, Eigen::VectorXd& pos, Eigen::VectorXd& vel, Eigen::VectorXd& acc)
+{
+    const int previousSegment = segmentCursor;
+    const TglMessage status = core->evaluate(pos, vel, acc, time, segmentCursor);
+    countSegmentLookup(previousSegment, segmentCursor);
+    return status;
+}
+
+bool CubicSplineTrajectory::supportsWaypointType(TglWaypointType wptType) const
+{
+    return wptType == TGL_WPT_VECTOR_XD || wptType == TGL_WPT_LGSM_WRENCH;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+double CubicSplineTrajectory::getSegmentDistance(const int segment, const Eigen::VectorXd& point, double& localTime) const
+{
+    const StdDoubleVector& knotTimes = core->getKnotTimes();
+    const Eigen::MatrixXd& coefficients = core->getCoefficients();
+    const double h = knotTimes[segment+1] - knotTimes[segment];
+    const auto c = coefficients.middleCols<4>(4*segment);
+
+    // The squared distance is a sextic, start Newton from the best of a few samples to land in the right basin.
+    double bestSquaredDistance = std::numeric_limits<double>::infinity();
+    for (int k = 0; k <= 4; ++k) {
+        const double dt = h * k / 4.0;
+        const double d2 = (c.col(0) + dt * (c.col(1) + dt * (c.col(2) + dt * c.col(3))) - point).squaredNorm();
+        if (d2 < bestSquaredDistance) {
+            bestSquaredDistance = d2;
+            localTime = dt;
+        }
+    }
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        const double dt = localTime;
+        const double gradient = (c.col(0) + dt * (c.col(1) + dt * (c.col(2) + dt * c.col(3))) - point).dot(c.col(1) + dt * (2.0 * c.col(2) + 3.0 * dt * c.col(3)));
+        const double curvature = (c.col(1) + dt * (2.0 * c.col(2) + 3.0 * dt * c.col(3))).squaredNorm()
+                               + (c.col(0) + dt * (c.col(1) + dt * (c.col(2) + dt * c.col(3))) - point).dot(2.0 * c.col(2) + 6.0 * dt * c.col(3));
+        if (curvature <= 0.0) {
+            break;
+        }
+        const double next = std::min(std::max(dt - gradient / curvature, 0.0), h);
+        const double d2 = (c.col(0) + next * (c.col(1) + next * (c.col(2) + next * c.col(3))) - point).squaredNorm();
+        if (d2 >= bestSquaredDistance) {
+            break;
+        }
+        bestSquaredDistance = d2;
+        localTime = next;
+    }
+    return std::sqrt(bestSquaredDistance);
+}
+
+void CubicSplineTrajectory::buildBoundingVolumes()
+{
+    const StdDoubleVector& knotTimes = core->getKnotTimes();
+    const Eigen::MatrixXd& coefficients = core->getCoefficients();
+    const int nDof = coefficients.rows();
+    const int nSegments = knotTimes.size() - 1;
+
+    // Each segment lies in the box of its Bernstein control points (convex hull property).
+    Eigen::MatrixXd boxMin(nDof, nSegments), boxMax(nDof, nSegments);
+    for (int i = 0; i < nSegments; ++i) {
+        const double h = knotTimes[i+1] - knotTimes[i];
+        const auto c = coefficients.middleCols<4>(4*i);
+        Eigen::MatrixXd bernstein(nDof, 4);
+        bernstein.col(0) = c.col(0);
+        bernstein.col(1) = c.col(0) + h * c.col(1) / 3.0;
+        bernstein.col(2) = c.col(0) + 2.0 * h * c.col(1) / 3.0 + h * h * c.col(2) / 3.0;
+        bernstein.col(3) = c.col(0) + h * (c.col(1) + h * (c.col(2) + h * c.col(3)));
+        boxMin.col(i) = bernstein.rowwise().minCoeff();
+        boxMax.col(i) = bernstein.rowwise().maxCoeff();
+    }
+    segmentBvh.build(boxMin, boxMax);
+    lastProjectionTime = knotTimes.front();
+}
@@ -0,0 +1,330 @@
+/*! \file       DmpTrajectory.cpp
+ *  \brief      A dynamic movement primitive learned from a demonstration.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/DmpTrajectory.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <cmath>
+
+
+using namespace tgl;
+
+static const double TGL_DMP_ALPHA_Z = 25.0;     /*!< The spring gain, critically damped with TGL_DMP_BETA_Z. */
+static const double TGL_DMP_BETA_Z = 6.25;      /*!< The spring stiffness ratio, alpha_z / 4. */
+static const double TGL_DMP_ALPHA_S = 4.6;      /*!< The phase decay, the phase is 0.01 after one duration. */
+static const double TGL_DMP_MAX_DURATIONS = 4.0; /*!< The state is held beyond this many durations after the start, when the primitive has converged. */
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+DmpTrajectory::DmpTrajectory(const int newNumberOfBasisFunctions):
+nBasis(std::max(newNumberOfBasisFunctions, 2)),
+startTime(0.0),
+duration(1.0),
+integrationStep(TGL_DMP_INTEGRATION_STEP)
+{
+    if (nBasis != newNumberOfBasisFunctions)
+        LOG(WARNING) << "A DMP needs at least 2 basis functions, got " << newNumberOfBasisFunctions << ". Using " << nBasis << ".";
+}
+
+DmpTrajectory::DmpTrajectory(const WaypointSet& newWptSet, const int newNumberOfBasisFunctions):
+nBasis(std::max(newNumberOfBasisFunctions, 2)),
+startTime(0.0),
+duration(1.0),
+integrationStep(TGL_DMP_INTEGRATION_STEP)
+{
+    if (nBasis != newNumberOfBasisFunctions)
+        LOG(WARNING) << "A DMP needs at least 2 basis functions, got " << newNumberOfBasisFunctions << ". Using " << nBasis << ".";
+    if(!setWaypoints(newWptSet))
+        LOG(ERROR) << "Could not set the waypoints you passed to the trajectory.";
+}
+
+DmpTrajectory::~DmpTrajectory()
+{
+}
+
+TglMessage DmpTrajectory::setWaypoints(const WaypointSet& newWptSet)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    weights.resize(0, 0);
+    start.resize(0);
+    goal.resize(0);
+
+    if (newWptSet.getWaypointType() != TGL_WPT_VECTOR_XD) {
+        LOG(ERROR) << "A DMP can only learn from waypoints of type TGL_WPT_VECTOR_XD, got " << newWptSet.getWaypointType() << ".";
+        return TGL_ERROR;
+    }
+    ConstVectorMap times = newWptSet.getWaypointTimesView();
+    ConstMatrixMap wpts = newWptSet.asMatrixView();
+    const int n = times.size();
+    const int nDof = wpts.rows();
+    if (n < 3) {
+        LOG(ERROR) << "A DMP needs at least 3 waypoints to learn from, got " << n << ".";
+        return TGL_ERROR;
+    }
+    if ((times.tail(n - 1) - times.head(n - 1)).minCoeff() <= 0.0) {
+        LOG(ERROR) << "A DMP needs strictly increasing waypoint times.";
+        return TGL_ERROR;
+    }
+
+    Trajectory::setWaypoints(newWptSet);
+    startTime = times(0);
+    duration = times(n - 1) - times(0);
+    start = wpts.col(0);
+    goal = wpts.col(n - 1);
+    demoAmplitude = goal - start;
+
+    // Demonstration derivatives by central differences, one-sided at the ends.
+    const Eigen::VectorXd inverseSpans = (times.tail(n - 2) - times.head(n - 2)).cwiseInverse();
+    Eigen::MatrixXd vel(nDof, n), acc(nDof, n);
+    vel.middleCols(1, n - 2) = (wpts.rightCols(n - 2) - wpts.leftCols(n - 2)) * inverseSpans.asDiagonal();
+    vel.col(0) = (wpts.col(1) - wpts.col(0)) / (times(1) - times(0));
+    vel.col(n - 1) = (wpts.col(n - 1) - wpts.col(n - 2)) / (times(n - 1) - times(n - 2));
+    acc.middleCols(1, n - 2) = (vel.rightCols(n - 2) - vel.leftCols(n - 2)) * inverseSpans.asDiagonal();
+    acc.col(0) = (vel.col(1) - vel.col(0)) / (times(1) - times(0));
+    acc.col(n - 1) = (vel.col(n - 1) - vel.col(n - 2)) / (times(n - 1) - times(n - 2));
+    startVelocity = vel.col(0);
+
+    // The forcing term the demonstration needs, one column per waypoint.
+    Eigen::MatrixXd targetForcing = duration * duration * acc + TGL_DMP_ALPHA_Z * duration * vel;
+    targetForcing -= TGL_DMP_ALPHA_Z * TGL_DMP_BETA_Z * (goal.replicate(1, n) - wpts);
+
+    // Basis functions evenly spread in time, overlapping their neighbours at exp(-1).
+    centers.resize(nBasis);
+    widths.resize(nBasis);
+    for (int i = 0; i < nBasis; ++i) {
+        centers(i) = std::exp(-TGL_DMP_ALPHA_S * i / (nBasis - 1.0));
+    }
+    for (int i = 0; i < nBasis - 1; ++i) {
+        widths(i) = 1.0 / ((centers(i+1) - centers(i)) * (centers(i+1) - centers(i)));
+    }
+    widths(nBasis - 1) = widths(nBasis - 2);
+
+    // Normalized and phase-scaled basis functions at each waypoint, then one regularized least-squares solve for all the DoF.
+    const Eigen::ArrayXd phases = (-TGL_DMP_ALPHA_S / duration * (times.array() - startTime)).exp();
+    Eigen::ArrayXXd psi = (phases.replicate(1, nBasis) - centers.transpose().array().replicate(n, 1)).square();
+    psi = (-(psi.rowwise() * widths.transpose().array())).exp();
+    const Eigen::MatrixXd features = (psi.colwise() * (phases / psi.rowwise().sum().max(1e-300))).matrix();
+    Eigen::MatrixXd gram = features.transpose() * features;
+    gram.diagonal().array() += 1e-10 * gram.trace() / nBasis + 1e-300;
+    weights = gram.ldlt().solve(features.transpose() * targetForcing.transpose()).transpose();
+
+    forcing.resize(nDof);
+    computeAmplitudeScale(goal, amplitudeScale);
+    startState(state);
+    outputState = state;
+    countRebuild(buildStart);
+    return TGL_OK;
+}
+
+TglMessage DmpTrajectory::setGoal(const Eigen::VectorXd& newGoal)
+{
+    if (newGoal.size() != goal.size() || goal.size() == 0) {
+        LOG(ERROR) << "The goal dimension (" << newGoal.size() << ") does not match the DMP dimension (" << goal.size() << ").";
+        return TGL_ERROR;
+    }
+    goal = newGoal;
+    computeAmplitudeScale(goal, amplitudeScale);
+    return TGL_OK;
+}
+
+const Eigen::VectorXd& DmpTrajectory::getGoal() const
+{
+    return goal;
+}
+
+TglMessage DmpTrajectory::setDuration(const double newDuration)
+{
+    if (!(newDuration > 0.0) || std::isinf(newDuration)) {
+        LOG(ERROR) << "The DMP duration must be positive and finite, got " << newDuration << ".";
+        return TGL_ERROR;
+    }
+    duration = newDuration;
+    return TGL_OK;
+}
+
+double DmpTrajectory::getDuration() const
+{
+    return duration;
+}
+
+TglMessage DmpTrajectory::setIntegrationStep(const double newIntegrationStep)
+{
+    if (!(newIntegrationStep > 0.0) || std::isinf(newIntegrationStep)) {
+        LOG(ERROR) << "The DMP integration step must be positive and finite, got " << newIntegrationStep << ".";
+        return TGL_ERROR;
+    }
+    integrationStep = newIntegrationStep;
+    startState(state);
+    return TGL_OK;
+}
+
+int DmpTrajectory::getDimension() const
+{
+    return weights.rows();
+}
+
+const Eigen::MatrixXd& DmpTrajectory::getWeights() const
+{
+    return weights;
+}
+
+TglMessage DmpTrajectory::rollout(const Eigen::MatrixXd& goals, const double timeStep, std::vector<Eigen::MatrixXd>& positions) const
+{
+    if (weights.size() == 0) {
+        LOG(ERROR) << "The DMP has not learned anything. Set some waypoints first.";
+        return TGL_ERROR;
+    }
+    if (goals.rows() != weights.rows()) {
+        LOG(ERROR) << "The goal dimension (" << goals.rows() << ") does not match the DMP dimension (" << weights.rows() << ").";
+        return TGL_ERROR;
+    }
+    if (!(timeStep > 0.0)) {
+        LOG(ERROR) << "The rollout time step must be positive, got " << timeStep << ".";
+        return TGL_ERROR;
+    }
+
+    const int nSamples = (int)std::floor(duration / timeStep + 1e-9) + 1;
+    positions.resize(goals.cols());
+    TglTools::parallelFor(goals.cols(), [&](int begin, int end) {
+        State rolloutState, sampleState;
+        Eigen::VectorXd rolloutGoal, scale, work(weights.rows());
+        for (int j = begin; j < end; ++j) {
+            rolloutGoal = goals.col(j);
+            computeAmplitudeScale(rolloutGoal, scale);
+            startState(rolloutState);
+            positions[j].resize(weights.rows(), nSamples);
+            for (int k = 0; k < nSamples; ++k) {
+                const double time = startTime + k * timeStep;
+                integrateTo(rolloutState, rolloutGoal, scale, time, work);
+                sampleState = rolloutState;
+                if (time > sampleState.time) {
+                    step(sampleState, rolloutGoal, scale, time - sampleState.time, work);
+                }
+                positions[j].col(k) = sampleState.pos;
+            }
+        }
+    }, 1);
+    return TGL_OK;
+}
+
+std::size_t DmpTrajectory::getMemoryUsage() const
+{
+    return Trajectory::getMemoryUsage() + sizeof(DmpTrajectory) - sizeof(Trajectory)
+         + sizeof(double) * (centers.size() + widths.size() + weights.size() + 5 * start.size() + 6 * forcing.size());
+}
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage DmpTrajectory::getImplementationDesired(  Eigen::VectorXd& desiredPos,
+                                                     Eigen::VectorXd& desiredVel,
+                                                     Eigen::VectorXd& desiredAcc,
+                                                     const double time_step)
+{
+    if (weights.size() == 0) {
+        TGL_REPORT_ERROR("The DMP has not learned anything. Set some waypoints first.");
+        return TGL_ERROR;
+    }
+    if (time_step < startTime) {
+        desiredPos = start;
+        desiredVel = startVelocity;
+        desiredAcc.setZero(start.size());
+        return TGL_START;
+    }
+
+    const double time = std::min(time_step, startTime + TGL_DMP_MAX_DURATIONS * duration);
+    if (time < state.time) {
+        startState(state);
+    }
+    integrateTo(state, goal, amplitudeScale, time, forcing);
+    outputState = state;
+    if (time > outputState.time) {
+        step(outputState, goal, amplitudeScale, time - outputState.time, forcing);
+    }
+
+    desiredPos = outputState.pos;
+    desiredVel = outputState.z / duration;
+    desiredAcc = outputState.acc;
+    return time_step >= startTime + duration ? TGL_FINISHED : TGL_RUNNING;
+}
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void DmpTrajectory::startState(State& newState) const
+{
+    newState.time = startTime;
+    newState.phase = 1.0;
+    newState.pos = start;
+    newState.z = duration * startVelocity;
+    newState.acc.setZero(start.size());
+}
+
+void DmpTrajectory::step(State& currentState, const Eigen::VectorXd& stepGoal, const Eigen::VectorXd& scale, const double dt, Eigen::VectorXd& work) const
+{
+    double psiSum = 0.0;
+    work.setZero();
+    for (int i = 0; i < nBasis; ++i) {
+        const double distance = currentState.phase - centers(i);
+        const double psi = std::exp(-widths(i) * distance * distance);
+        psiSum += psi;
+        work.noalias() += psi * weights.col(i);
+    }
+    work *= currentState.phase / std::max(psiSum, 1e-300);
+
+    currentState.acc = (TGL_DMP_ALPHA_Z * (TGL_DMP_BETA_Z * (stepGoal - currentState.pos) - currentState.z) + scale.cwiseProduct(work)) / (duration * duration);
+    currentState.z += (duration * dt) * currentState.acc;
+    currentState.pos += (dt / duration) * currentState.z;
+    currentState.phase *= std::exp(-TGL_DMP_ALPHA_S * dt / duration);
+    currentState.time += dt;
+}
+
+void DmpTrajectory::integrateTo(State& currentState, const Eigen::VectorXd& stepGoal, const Eigen::VectorXd& scale, const double time, Eigen::VectorXd& work) const
+{
+    // Steps are counted from the start so that the grid does not drift with rounding.
+    const long long lastStep = (long long)std::floor((time - startTime) / integrationStep + 1e-9);
+    long long currentStep = (long long)std::llround((currentState.time - startTime) / integrationStep);
+    while (currentStep < lastStep) {
+        step(currentState, stepGoal, scale, integrationStep, work);
+        ++currentStep;
+        currentState.time = startTime + currentStep * integrationStep;
+    }
+}
+
+void DmpTrajectory::computeAmplitudeScale(const Eigen::VectorXd& newGoal, Eigen::VectorXd& scale) const
+{
+    scale.resize(newGoal.size());
+    for (int i = 0; i < newGoal.size(); ++i) {
+        scale(i) = std::abs(demoAmplitude(i)) > 1e-9 ? (newGoal(i) - start(i)) / demoAmplitude(i) : 1.0;
+    }
+}
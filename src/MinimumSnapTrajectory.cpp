@@ -0,0 +1,351 @@
+/*! \file       MinimumSnapTrajectory.cpp
+ *  \brief      A minimum snap (or jerk) piecewise polynomial trajectory through a Waypoint Set.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/MinimumSnapTrajectory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <Eigen/SparseLU>
+
+
+using namespace tgl;
+
+/*! The falling factorial k! / (k - j)!, i.e. the factor brought by differentiating t^k j times.
+ */
+static double fallingFactorial(const int k, const int j)
+{
+    double result = 1.0;
+    for (int i = 0; i < j; ++i) {
+        result *= k - i;
+    }
+    return result;
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+MinimumSnapTrajectory::MinimumSnapTrajectory(const int newMinimizedDerivative):
+minimizedDerivative(std::min(std::max(newMinimizedDerivative, 2), 6)),
+core(std::make_shared<PiecewisePolynomial>()),
+cost(0.0),
+segmentCursor(0)
+{
+    if (minimizedDerivative != newMinimizedDerivative)
+        LOG(WARNING) << "The minimized derivative must be between 2 and 6, got " << newMinimizedDerivative << ". Using " << minimizedDerivative << ".";
+}
+
+MinimumSnapTrajectory::MinimumSnapTrajectory(const WaypointSet& newWptSet, const int newMinimizedDerivative):
+minimizedDerivative(std::min(std::max(newMinimizedDerivative, 2), 6)),
+core(std::make_shared<PiecewisePolynomial>()),
+cost(0.0),
+segmentCursor(0)
+{
+    if (minimizedDerivative != newMinimizedDerivative)
+        LOG(WARNING) << "The minimized derivative must be between 2 and 6, got " << newMinimizedDerivative << ". Using " << minimizedDerivative << ".";
+    if(!setWaypoints(newWptSet))
+        LOG(ERROR) << "Could not set the waypoints you passed to the trajectory.";
+}
+
+MinimumSnapTrajectory::~MinimumSnapTrajectory()
+{
+}
+
+TglMessage MinimumSnapTrajectory::setWaypoints(const WaypointSet& newWptSet)
+{
+    ConstVectorMap times = newWptSet.getWaypointTimesView();
+    if (times.size() < 2) {
+        LOG(ERROR) << "A minimum snap trajectory needs at least 2 waypoints, got " << times.size() << ".";
+        core = std::make_shared<PiecewisePolynomial>();
+        return TGL_ERROR;
+    }
+    return setWaypoints(newWptSet, times.tail(times.size() - 1) - times.head(times.size() - 1));
+}
+
+TglMessage MinimumSnapTrajectory::setWaypoints(const WaypointSet& newWptSet, const Eigen::VectorXd& segmentDurations)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    core = std::make_shared<PiecewisePolynomial>();
+    cost = 0.0;
+    segmentCursor = 0;
+
+    if (newWptSet.getWaypointType() != TGL_WPT_VECTOR_XD) {
+        LOG(ERROR) << "MinimumSnapTrajectory needs waypoints of type TGL_WPT_VECTOR_XD, got " << newWptSet.getWaypointType() << ".";
+        return TGL_ERROR;
+    }
+    ConstVectorMap times = newWptSet.getWaypointTimesView();
+    const int nWpts = times.size();
+    if (nWpts < 2) {
+        LOG(ERROR) << "A minimum snap trajectory needs at least 2 waypoints, got " << nWpts << ".";
+        return TGL_ERROR;
+    }
+    if (segmentDurations.size() != nWpts - 1 || segmentDurations.minCoeff() <= 0.0) {
+        LOG(ERROR) << "A minimum snap trajectory needs " << nWpts - 1 << " positive segment durations.";
+        return TGL_ERROR;
+    }
+
+    Trajectory::setWaypoints(newWptSet);
+    StdDoubleVector knotTimes(nWpts);
+    knotTimes[0] = times(0);
+    for (int i = 0; i < nWpts - 1; ++i) {
+        knotTimes[i+1] = knotTimes[i] + segmentDurations(i);
+    }
+    if (!solve(newWptSet.asMatrixView(), knotTimes)) {
+        return TGL_ERROR;
+    }
+    countRebuild(buildStart);
+    return TGL_OK;
+}
+
+TglMessage MinimumSnapTrajectory::setWaypoints(const WaypointSet& newWptSet, CoefficientCache& cache)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    Eigen::VectorXd parameters(1);
+    parameters << minimizedDerivative;
+    const uint64_t key = CoefficientCache::computeKey(newWptSet, "MinimumSnapTrajectory/1", parameters);
+    StdDoubleVector cachedKnotTimes;
+    Eigen::MatrixXd cachedCoefficients;
+    const int nWpts = newWptSet.getWaypointTimesView().size();
+    if (newWptSet.getWaypointType() == TGL_WPT_VECTOR_XD && nWpts >= 2
+        && cache.load(key, cachedKnotTimes, cachedCoefficients) == TGL_OK
+        && (int)cachedKnotTimes.size() == nWpts
+        && std::equal(cachedKnotTimes.begin(), cachedKnotTimes.end(), newWptSet.getWaypointTimesView().data())
+        && cachedCoefficients.rows() == newWptSet.asMatrixView().rows()
+        && cachedCoefficients.cols() == 2 * minimizedDerivative * (nWpts - 1)) {
+        Trajectory::setWaypoints(newWptSet);
+        core = std::make_shared<PiecewisePolynomial>(std::move(cachedKnotTimes), std::move(cachedCoefficients), 2 * minimizedDerivative);
+        segmentCursor = 0;
+        computeCost();
+        countRebuild(buildStart);
+        return TGL_OK;
+    }
+
+    if (!setWaypoints(newWptSet)) {
+        return TGL_ERROR;
+    }
+    // Failing to store only costs a solve next time, the trajectory itself is fine.
+    cache.store(key, core->getKnotTimes(), core->getCoefficients());
+    return TGL_OK;
+}
+
+int MinimumSnapTrajectory::getMinimizedDerivative() const
+{
+    return minimizedDerivative;
+}
+
+double MinimumSnapTrajectory::getCost() const
+{
+    return cost;
+}
+
+int MinimumSnapTrajectory::getDimension() const
+{
+    return core->getDimension();
+}
+
+std::size_t MinimumSnapTrajectory::getMemoryUsage() const
+{
+    return Trajectory::getMemoryUsage() + sizeof(MinimumSnapTrajectory) - sizeof(Trajectory)
+         + core->getMemoryUsage();
+}
+
+TrajectoryCorePtr MinimumSnapTrajectory::getCore() const
+{
+    return core;
+}
+
+TglMessage MinimumSnapTrajectory::verifyLimits(const Eigen::VectorXd& maxVel,
+                                               const Eigen::VectorXd& maxAcc,
+                                               const Eigen::VectorXd& maxJerk,
+                                               std::vector<TglLimitViolation>& violations) const
+{
+    return core->verifyLimits(maxVel, maxAcc, maxJerk, violations);
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage MinimumSnapTrajectory::getImplementationDesired( Eigen::VectorXd& desiredPos,
+                                                            Eigen::VectorXd& desiredVel,
+                                                            Eigen::VectorXd& desiredAcc,
+                                                            const double time_step)
+{
+    const int previousSegment = segmentCursor;
+    const TglMessage status = core->evaluate(desiredPos, desiredVel, desiredAcc, time_step, segmentCursor);
+    countSegmentLookup(previousSegment, segmentCursor);
+    return status;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+TglMessage MinimumSnapTrajectory::solve(const Eigen::MatrixXd& wpts, const StdDoubleVector& knotTimes)
+{
+    const int r = minimizedDerivative;
+    const int nCoefficients = 2 * r;
+    const int nSegments = knotTimes.size() - 1;
+    const int nDof = wpts.rows();
+
+    // Durations normalized by their mean, so the KKT entries stay O(1) whatever the time scale.
+    Eigen::VectorXd h(nSegments);
+    for (int i = 0; i < nSegments; ++i) {
+        h(i) = knotTimes[i+1] - knotTimes[i];
+    }
+    const double meanDuration = h.mean();
+    const Eigen::VectorXd hNormalized = h / meanDuration;
+
+    // Cost matrix of one segment in the normalized time tau in [0, 1], before the h^(1-2r) factor.
+    Eigen::MatrixXd costMatrix = Eigen::MatrixXd::Zero(nCoefficients, nCoefficients);
+    for (int k = r; k < nCoefficients; ++k) {
+        for (int l = r; l < nCoefficients; ++l) {
+            costMatrix(k, l) = fallingFactorial(k, r) * fallingFactorial(l, r) / (k + l - 2 * r + 1);
+        }
+    }
+
+    // Each segment block holds its coefficients followed by the multipliers of the constraints it owns: its start and end
+    // positions, the start (first segment) or end (last segment) rest conditions, and the continuity with the next segment.
+    std::vector<int> blockStart(nSegments + 1, 0);
+    for (int i = 0; i < nSegments; ++i) {
+        int nOwned = 2 + (r - 1) * ((i == 0) + (i < nSegments - 1) + (i == nSegments - 1));
+        blockStart[i+1] = blockStart[i] + nCoefficients + nOwned;
+    }
+    const int size = blockStart[nSegments];
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(nSegments * (nCoefficients * nCoefficients + 2 * nCoefficients * (2 + 3 * r)));
+    std::vector<std::pair<int, int>> positionRows;   // (KKT row, waypoint index)
+    positionRows.reserve(2 * nSegments);
+
+    for (int i = 0; i < nSegments; ++i) {
+        const int coefficientStart = blockStart[i];
+        int row = coefficientStart + nCoefficients;
+        auto addConstraint = [&](const int col, const double value) {
+            triplets.push_back(Eigen::Triplet<double>(row, col, value));
+            triplets.push_back(Eigen::Triplet<double>(col, row, value));
+        };
+
+        const double costScale = std::pow(hNormalized(i), 1 - 2 * r);
+        for (int k = r; k < nCoefficients; ++k) {
+            for (int l = r; l < nCoefficients; ++l) {
+                triplets.push_back(Eigen::Triplet<double>(coefficientStart + k, coefficientStart + l, costScale * costMatrix(k, l)));
+            }
+        }
+
+        // p_i(0) = w_i
+        addConstraint(coefficientStart, 1.0);
+        positionRows.push_back(std::make_pair(row++, i));
+        // p_i(1) = w_{i+1}
+        for (int k = 0; k < nCoefficients; ++k) {
+            addConstraint(coefficientStart + k, 1.0);
+        }
+        positionRows.push_back(std::make_pair(row++, i + 1));
+        // Rest at the start: p_0^(j)(0) = 0
+        if (i == 0) {
+            for (int j = 1; j < r; ++j, ++row) {
+                addConstraint(coefficientStart + j, fallingFactorial(j, j));
+            }
+        }
+        // Continuity: p_i^(j)(1) / h_i^j = p_{i+1}^(j)(0) / h_{i+1}^j
+        if (i < nSegments - 1) {
+            for (int j = 1; j < r; ++j, ++row) {
+                for (int k = j; k < nCoefficients; ++k) {
+                    addConstraint(coefficientStart + k, fallingFactorial(k, j) / std::pow(hNormalized(i), j));
+                }
+                addConstraint(blockStart[i+1] + j, -fallingFactorial(j, j) / std::pow(hNormalized(i+1), j));
+            }
+        }
+        // Rest at the end: p_n^(j)(1) = 0
+        if (i == nSegments - 1) {
+            for (int j = 1; j < r; ++j, ++row) {
+                for (int k = j; k < nCoefficients; ++k) {
+                    addConstraint(coefficientStart + k, fallingFactorial(k, j));
+                }
+            }
+        }
+    }
+
+    Eigen::SparseMatrix<double> kkt(size, size);
+    kkt.setFromTriplets(triplets.begin(), triplets.end());
+    Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> solver;
+    solver.analyzePattern(kkt);
+    solver.factorize(kkt);
+    if (solver.info() != Eigen::Success) {
+        LOG(ERROR) << "Could not factorize the minimum snap KKT system: " << solver.lastErrorMessage();
+        return TGL_ERROR;
+    }
+
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(size, nDof);
+    for (const auto& positionRow : positionRows) {
+        rhs.row(positionRow.first) = wpts.col(positionRow.second).transpose();
+    }
+
+    // The factorization is shared, only the right-hand sides differ. Threads only pay off on large problems.
+    Eigen::MatrixXd solution(size, nDof);
+    TglTools::parallelFor(nDof, [&](int begin, int end) {
+        for (int d = begin; d < end; ++d) {
+            solution.col(d) = solver.solve(rhs.col(d));
+        }
+    }, nSegments > 1000 ? 1 : nDof);
+
+    // Back to the local time delta = tau * h, and the cost in real time units.
+    Eigen::MatrixXd coefficients(nDof, nCoefficients * nSegments);
+    cost = 0.0;
+    for (int i = 0; i < nSegments; ++i) {
+        const Eigen::MatrixXd segmentCoefficients = solution.middleRows(blockStart[i], nCoefficients);
+        cost += std::pow(h(i), 1 - 2 * r) * (segmentCoefficients.transpose() * costMatrix * segmentCoefficients).trace();
+        for (int k = 0; k < nCoefficients; ++k) {
+            coefficients.col(nCoefficients * i + k) = segmentCoefficients.row(k).transpose() / std::pow(h(i), k);
+        }
+    }
+    core = std::make_shared<PiecewisePolynomial>(knotTimes, std::move(coefficients), nCoefficients);
+    return TGL_OK;
+}
+
+void MinimumSnapTrajectory::computeCost()
+{
+    // In the local time delta, the cost of a segment is c^T Q(h) c with Q_kl = k!/(k-r)! l!/(l-r)! h^(k+l-2r+1) / (k+l-2r+1).
+    const int r = minimizedDerivative;
+    const int nCoefficients = 2 * r;
+    const StdDoubleVector& knotTimes = core->getKnotTimes();
+    const Eigen::MatrixXd& coefficients = core->getCoefficients();
+    cost = 0.0;
+    for (int i = 0; i < (int)knotTimes.size() - 1; ++i) {
+        const double h = knotTimes[i+1] - knotTimes[i];
+        const auto c = coefficients.middleCols(nCoefficients * i, nCoefficients);
+        for (int k = r; k < nCoefficients; ++k) {
+            for (int l = r; l < nCoefficients; ++l) {
+                const int power = k + l - 2 * r + 1;
+                cost += fallingFactorial(k, r) * fallingFactorial(l, r) * std::pow(h, power) / power * c.col(k).dot(c.col(l));
+            }
+        }
+    }
+}
@@ -0,0 +1,182 @@
+/*! \file       PerformanceCounters.cpp
+ *  \brief      Cheap counters of the work done by trajectories and waypoint sets, and their export.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/PerformanceCounters.hpp"
+
+// STL includes
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// POSIX includes
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+/*! Escapes a Prometheus label value: backslashes, double quotes and line feeds.
+ */
+static std::string escapeLabel(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (const char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/*! Writes one metric family: its help and type lines, then one sample per snapshot.
+ */
+template<typename Value>
+static void writeMetric(std::ostream& stream, const PerformanceCounters::NamedSnapshots& snapshots, const char* name, const char* type, const char* help, Value PerformanceCounters::Snapshot::* field)
+{
+    stream << "# HELP " << name << " " << help << "\n";
+    stream << "# TYPE " << name << " " << type << "\n";
+    for (const auto& named : snapshots) {
+        stream << name << "{object=\"" << escapeLabel(named.first) << "\"} " << named.second.*field << "\n";
+    }
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+PerformanceCounters::PerformanceCounters():
+evaluations(0),
+segmentHits(0),
+segmentMisses(0),
+rebuilds(0),
+allocatedBytes(0),
+totalBuildNanoseconds(0),
+lastBuildNanoseconds(0),
+lastLatencyNanoseconds(0)
+{
+}
+
+PerformanceCounters::PerformanceCounters(const PerformanceCounters&):
+PerformanceCounters()
+{
+}
+
+PerformanceCounters& PerformanceCounters::operator=(const PerformanceCounters&)
+{
+    return *this;
+}
+
+void PerformanceCounters::countRebuild(const Clock::time_point& start, const std::size_t bytes)
+{
+    if (TGL_ENABLE_METRICS) {
+        const uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        rebuilds.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        totalBuildNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+        lastBuildNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+PerformanceCounters::Snapshot PerformanceCounters::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.evaluations = evaluations.load(std::memory_order_relaxed);
+    snapshot.segmentHits = segmentHits.load(std::memory_order_relaxed);
+    snapshot.segmentMisses = segmentMisses.load(std::memory_order_relaxed);
+    snapshot.rebuilds = rebuilds.load(std::memory_order_relaxed);
+    snapshot.allocatedBytes = allocatedBytes.load(std::memory_order_relaxed);
+    snapshot.totalBuildTime = 1e-9 * totalBuildNanoseconds.load(std::memory_order_relaxed);
+    snapshot.lastBuildTime = 1e-9 * lastBuildNanoseconds.load(std::memory_order_relaxed);
+    snapshot.lastEvaluationLatency = 1e-9 * lastLatencyNanoseconds.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void PerformanceCounters::reset()
+{
+    evaluations.store(0, std::memory_order_relaxed);
+    segmentHits.store(0, std::memory_order_relaxed);
+    segmentMisses.store(0, std::memory_order_relaxed);
+    rebuilds.store(0, std::memory_order_relaxed);
+    allocatedBytes.store(0, std::memory_order_relaxed);
+    totalBuildNanoseconds.store(0, std::memory_order_relaxed);
+    lastBuildNanoseconds.store(0, std::memory_order_relaxed);
+    lastLatencyNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+void PerformanceCounters::writePrometheus(std::ostream& stream, const NamedSnapshots& snapshots)
+{
+    writeMetric(stream, snapshots, "tgl_evaluations_total", "counter", "Number of trajectory evaluations.", &Snapshot::evaluations);
+    writeMetric(stream, snapshots, "tgl_segment_cache_hits_total", "counter", "Segment lookups answered by the current or next segment of the cursor.", &Snapshot::segmentHits);
+    writeMetric(stream, snapshots, "tgl_segment_cache_misses_total", "counter", "Segment lookups which needed a search.", &Snapshot::segmentMisses);
+    writeMetric(stream, snapshots, "tgl_rebuilds_total", "counter", "Number of successful rebuilds.", &Snapshot::rebuilds);
+    writeMetric(stream, snapshots, "tgl_allocated_bytes_total", "counter", "Bytes held after each rebuild, summed over the rebuilds.", &Snapshot::allocatedBytes);
+    writeMetric(stream, snapshots, "tgl_build_seconds_total", "counter", "Time spent in rebuilds.", &Snapshot::totalBuildTime);
+    writeMetric(stream, snapshots, "tgl_last_build_seconds", "gauge", "Time the last rebuild took.", &Snapshot::lastBuildTime);
+    writeMetric(stream, snapshots, "tgl_last_evaluation_latency_seconds", "gauge", "Time the last evaluation took.", &Snapshot::lastEvaluationLatency);
+}
+
+TglMessage PerformanceCounters::writePrometheusFile(const std::string& filename, const NamedSnapshots& snapshots)
+{
+    std::stringstream stream;
+    stream.precision(17);
+    writePrometheus(stream, snapshots);
+    const std::string text = stream.str();
+
+    // The temporary name is unique, so several exporters writing the same file never write the same temporary file.
+    std::string temporaryPath = filename + ".tmpXXXXXX";
+    const int fd = mkstemp(&temporaryPath[0]);
+    FILE* file = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!file) {
+        LOG(ERROR) << "Could not open " << temporaryPath << " to write the metrics: " << std::strerror(errno) << ".";
+        if (fd >= 0) {
+            close(fd);
+            unlink(temporaryPath.c_str());
+        }
+        return TGL_ERROR;
+    }
+    fchmod(fd, 0644);
+    bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    written &= std::fclose(file) == 0;
+    if (!written || std::rename(temporaryPath.c_str(), filename.c_str()) != 0) {
+        LOG(ERROR) << "Could not write the metrics to " << filename << ".";
+        unlink(temporaryPath.c_str());
+        return TGL_ERROR;
+    }
+    return TGL_OK;
+}
@@ -0,0 +1,768 @@
+/*! \file       PiecewisePolynomial.cpp
+ *  \brief      A piecewise polynomial container shared by the polynomial trajectories.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/PiecewisePolynomial.hpp"
+#include "tgl/TglDiagnostics.hpp"
+#include "tgl/PolySegment.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+/*! The header of a serialized polynomial. All fields are 4 or 8 bytes wide so the layout has no padding.
+ */
+struct PolynomialStreamHeader {
+    char magic[4];          /*!< Always "TGLP". */
+    uint32_t version;       /*!< polynomialStreamVersion when written. */
+    uint32_t byteOrder;     /*!< 0x01020304 in the byte order of the writer. */
+    uint32_t order;         /*!< The number of coefficients per segment. */
+    uint64_t nKnots;        /*!< The number of knot times. */
+    uint64_t rows;          /*!< The number of DoF. */
+    uint64_t checksum;      /*!< FNV-1a hash of the knot times then the coefficients. */
+};
+
+static const uint32_t polynomialStreamVersion = 1;
+static const uint32_t polynomialByteOrder = 0x01020304;
+
+/*! A segment kernel: evaluates the Dof x Order coefficients of a segment at n local times, writing Dof values per time to each output.
+ */
+typedef void (*SegmentKernel)(const double* coefficients, const double* localTimes, const int n, double* pos, double* vel, double* acc);
+
+/*! Picks the unrolled kernel of an order for a number of DoF.
+ */
+template<int Order>
+static SegmentKernel selectSegmentKernel(const int dof)
+{
+    switch (dof) {
+        case 1: return &PolySegment<Order, 1>::evaluateSamples;
+        case 2: return &PolySegment<Order, 2>::evaluateSamples;
+        case 3: return &PolySegment<Order, 3>::evaluateSamples;
+        case 4: return &PolySegment<Order, 4>::evaluateSamples;
+        case 5: return &PolySegment<Order, 5>::evaluateSamples;
+        case 6: return &PolySegment<Order, 6>::evaluateSamples;
+        case 7: return &PolySegment<Order, 7>::evaluateSamples;
+        default: return nullptr;
+    }
+}
+
+/*! Picks the unrolled kernel of the cubic (4), quintic (6) and degree 7 (8) orders, null for the others.
+ */
+static SegmentKernel selectSegmentKernel(const int order, const int dof)
+{
+    switch (order) {
+        case 4: return selectSegmentKernel<4>(dof);
+        case 6: return selectSegmentKernel<6>(dof);
+        case 8: return selectSegmentKernel<8>(dof);
+        default: return nullptr;
+    }
+}
+
+/*! The run-time sized fallback of the segment kernels.
+ */
+static void evaluateSegmentSamples(const double* coefficients, const int dof, const int order, const double* localTimes, const int n, double* pos, double* vel, double* acc)
+{
+    const Eigen::Map<const Eigen::MatrixXd> c(coefficients, dof, order);
+    for (int i = 0; i < n; ++i) {
+        const double dt = localTimes[i];
+        Eigen::Map<Eigen::VectorXd> p(pos + dof * i, dof), v(vel + dof * i, dof), a(acc + dof * i, dof);
+        p = c.col(order - 1);
+        v.setZero();
+        a.setZero();
+        for (int k = order - 1; k >= 1; --k) {
+            if (k >= 2) {
+                a = dt * a + k * (k - 1) * c.col(k);
+            }
+            v = dt * v + k * c.col(k);
+            p = dt * p + c.col(k - 1);
+        }
+    }
+}
+
+/*! Runs a kernel, or the fallback if there is none, over the samples of a segment.
+ */
+static void runSegmentKernel(const SegmentKernel kernel, const double* coefficients, const int dof, const int order, const double* localTimes, const int n, double* pos, double* vel, double* acc)
+{
+    if (kernel) {
+        kernel(coefficients, localTimes, n, pos, vel, acc);
+    } else {
+        evaluateSegmentSamples(coefficients, dof, order, localTimes, n, pos, vel, acc);
+    }
+}
+
+/*! Evaluates a polynomial with Horner's scheme.
+ *  \param c the n coefficients, of increasing powers
+ */
+static inline double evaluatePolynomial(const double* c, const int n, const double x)
+{
+    double value = 0.0;
+    for (int k = n - 1; k >= 0; --k) {
+        value = value * x + c[k];
+    }
+    return value;
+}
+
+/*! Finds the roots of a polynomial inside (0, h). Between two consecutive critical points (the roots of its derivative) the polynomial is monotonic, so each interval holds at most one root, which is bracketed and refined by Newton steps kept inside the bracket.
+ *  \param c the n coefficients, of increasing powers
+ *  \param dc the n - 1 coefficients of the derivative
+ *  \param criticalPoints the increasing roots of the derivative inside (0, h)
+ *  \param roots the increasing roots
+ */
+static void findRootsInSegment(const double* c, const int n, const double* dc, const std::vector<double>& criticalPoints, const double h, std::vector<double>& roots)
+{
+    roots.clear();
+    double a = 0.0;
+    double fa = evaluatePolynomial(c, n, a);
+    for (std::size_t i = 0; i <= criticalPoints.size(); ++i) {
+        const double b = i < criticalPoints.size() ? criticalPoints[i] : h;
+        const double fb = evaluatePolynomial(c, n, b);
+        if (fb == 0.0 && b < h) {
+            roots.push_back(b);
+        } else if (fa != 0.0 && (fa < 0.0) != (fb < 0.0)) {
+            double lo = a, hi = b, flo = fa;
+            double x = 0.5 * (lo + hi);
+            for (int iteration = 0; iteration < 100 && hi - lo > 1e-15 * h; ++iteration) {
+                const double fx = evaluatePolynomial(c, n, x);
+                if (fx == 0.0) {
+                    break;
+                }
+                if ((fx < 0.0) == (flo < 0.0)) {
+                    lo = x;
+                    flo = fx;
+                } else {
+                    hi = x;
+                }
+                const double slope = evaluatePolynomial(dc, n - 1, x);
+                const double newton = slope != 0.0 ? x - fx / slope : lo;
+                x = newton > lo && newton < hi ? newton : 0.5 * (lo + hi);
+            }
+            roots.push_back(x);
+        }
+        a = b;
+        fa = fb;
+    }
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+PiecewisePolynomial::PiecewisePolynomial():
+order(0),
+uniformStep(0.0),
+segmentKernel(nullptr)
+{
+}
+
+PiecewisePolynomial::PiecewisePolynomial(StdDoubleVector newKnotTimes, Eigen::MatrixXd newCoefficients, const int newOrder):
+knotTimes(std::move(newKnotTimes)),
+coefficients(std::move(newCoefficients)),
+order(newOrder),
+uniformStep(0.0),
+segmentKernel(nullptr)
+{
+    if (knotTimes.size() < 2 || order < 1 || coefficients.cols() != order * ((int)knotTimes.size() - 1)) {
+        LOG(ERROR) << "A piecewise polynomial needs at least 2 knot times and " << order << " coefficient columns per segment, got "
+                   << knotTimes.size() << " knot times and " << coefficients.cols() << " columns.";
+        knotTimes.clear();
+        coefficients.resize(0, 0);
+        order = 0;
+        return;
+    }
+    segmentKernel = selectSegmentKernel(order, coefficients.rows());
+
+    const int nSegments = knotTimes.size() - 1;
+    const double step = (knotTimes.back() - knotTimes.front()) / nSegments;
+    const double tolerance = 1e-9 * step;
+    bool uniform = step > 0.0;
+    for (int i = 1; i < nSegments && uniform; ++i) {
+        uniform = std::abs(knotTimes[i] - (knotTimes.front() + i * step)) <= tolerance;
+    }
+    uniformStep = uniform ? step : 0.0;
+}
+
+PiecewisePolynomial::~PiecewisePolynomial()
+{
+}
+
+TglMessage PiecewisePolynomial::evaluate(Eigen::VectorXd& desiredPos,
+                                    Eigen::VectorXd& desiredVel,
+                                    Eigen::VectorXd& desiredAcc,
+                                    const double time,
+                                    int& segmentCursor) const
+{
+    if (knotTimes.empty()) {
+        TGL_REPORT_ERROR("The trajectory has not been built. Set some waypoints first.");
+        return TGL_ERROR;
+    }
+
+    TglMessage status = TGL_RUNNING;
+    double t = time;
+    if (t < knotTimes.front()) {
+        t = knotTimes.front();
+        status = TGL_START;
+    } else if (t >= knotTimes.back()) {
+        t = knotTimes.back();
+        status = TGL_FINISHED;
+    }
+
+    const int s = findSegment(t, segmentCursor);
+    const double dt = t - knotTimes[s];
+
+    // resize() is a no-op when the size is already right, so this does not allocate in a control loop.
+    desiredPos.resize(coefficients.rows());
+    desiredVel.resize(coefficients.rows());
+    desiredAcc.resize(coefficients.rows());
+    if (segmentKernel) {
+        segmentKernel(coefficients.data() + coefficients.rows() * order * s, &dt, 1, desiredPos.data(), desiredVel.data(), desiredAcc.data());
+    } else if (order == 4) {
+        // The cubic spline case with more DoF than the kernels, unrolled.
+        const auto c = coefficients.middleCols<4>(4*s);
+        desiredPos.noalias() = c.col(0) + dt * (c.col(1) + dt * (c.col(2) + dt * c.col(3)));
+        desiredVel.noalias() = c.col(1) + dt * (2.0 * c.col(2) + 3.0 * dt * c.col(3));
+        desiredAcc.noalias() = 2.0 * c.col(2) + 6.0 * dt * c.col(3);
+    } else {
+        const auto c = coefficients.middleCols(order * s, order);
+        desiredPos = c.col(order - 1);
+        desiredVel.setZero();
+        desiredAcc.setZero();
+        for (int k = order - 1; k >= 1; --k) {
+            if (k >= 2) {
+                desiredAcc = dt * desiredAcc + k * (k - 1) * c.col(k);
+            }
+            desiredVel = dt * desiredVel + k * c.col(k);
+            desiredPos = dt * desiredPos + c.col(k - 1);
+        }
+    }
+
+    if (status != TGL_RUNNING) {
+        desiredVel.setZero();
+        desiredAcc.setZero();
+    }
+    return status;
+}
+
+TglMessage PiecewisePolynomial::evaluateBatch(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::MatrixXd& positions, Eigen::MatrixXd& velocities, Eigen::MatrixXd& accelerations) const
+{
+    if (knotTimes.empty()) {
+        TGL_REPORT_ERROR("The trajectory has not been built. Set some waypoints first.");
+        return TGL_ERROR;
+    }
+    if (times.hasNaN()) {
+        TGL_REPORT_ERROR("Cannot evaluate the trajectory at a NaN time.");
+        return TGL_ERROR;
+    }
+
+    const int n = times.size();
+    const int dof = coefficients.rows();
+    const int nSegments = knotTimes.size() - 1;
+    positions.resize(dof, n);
+    velocities.resize(dof, n);
+    accelerations.resize(dof, n);
+    const SegmentKernel kernel = segmentKernel;
+    const Eigen::VectorXd startPos = coefficients.col(0);
+    Eigen::VectorXd endPos(dof), endVel(dof), endAcc(dof);
+    const double endLocalTime = knotTimes.back() - knotTimes[nSegments - 1];
+    runSegmentKernel(kernel, coefficients.data() + dof * order * (nSegments - 1), dof, order, &endLocalTime, 1, endPos.data(), endVel.data(), endAcc.data());
+
+    // Without uniform knots, a large batch looks its segments up in a uniform grid over the knots: the segments which meet a cell and its neighbours bound a short binary search, instead of one over all the knots.
+    std::vector<int> cellSegment;
+    const double cellSize = (knotTimes.back() - knotTimes.front()) / nSegments;
+    if (uniformStep <= 0.0 && n >= nSegments) {
+        cellSegment.resize(nSegments + 1);
+        int s = 0;
+        for (int cell = 0; cell <= nSegments; ++cell) {
+            const double cellTime = knotTimes.front() + cell * cellSize;
+            while (s < nSegments - 1 && knotTimes[s+1] <= cellTime) {
+                ++s;
+            }
+            cellSegment[cell] = s;
+        }
+    }
+    auto locate = [&](const double t, int& cursor) {
+        if (cellSegment.empty()) {
+            return findSegment(t, cursor);
+        }
+        const int cell = std::min((int)((t - knotTimes.front()) / cellSize), nSegments - 1);
+        const int first = cellSegment[std::max(cell - 1, 0)];
+        const int last = cellSegment[std::min(cell + 2, nSegments)];
+        return (int)(std::upper_bound(knotTimes.begin() + first + 1, knotTimes.begin() + last + 1, t) - knotTimes.begin()) - 1;
+    };
+    auto hold = [&](const Eigen::VectorXd& heldPos, const int i) {
+        positions.col(i) = heldPos;
+        velocities.col(i).setZero();
+        accelerations.col(i).setZero();
+    };
+
+    if (coefficients.size() * sizeof(double) <= TGL_BATCH_SORT_BYTES) {
+        // The coefficients stay in cache, so reordering would cost more than it saves: evaluate in the caller's order, which writes the outputs sequentially, with one kernel call per run of times in the same segment.
+        TglTools::parallelFor(n, [&](const int begin, const int end) {
+            std::vector<double> localTimes;
+            int cursor = 0;
+            int k = begin;
+            while (k < end) {
+                if (times(k) < knotTimes.front() || times(k) >= knotTimes.back()) {
+                    hold(times(k) < knotTimes.front() ? startPos : endPos, k);
+                    ++k;
+                    continue;
+                }
+                const int s = locate(times(k), cursor);
+                int runEnd = k + 1;
+                while (runEnd < end && times(runEnd) >= knotTimes[s] && times(runEnd) < knotTimes[s+1]) {
+                    ++runEnd;
+                }
+                localTimes.resize(runEnd - k);
+                for (int j = k; j < runEnd; ++j) {
+                    localTimes[j - k] = times(j) - knotTimes[s];
+                }
+                runSegmentKernel(kernel, coefficients.data() + dof * order * s, dof, order, localTimes.data(), runEnd - k,
+                                 positions.col(k).data(), velocities.col(k).data(), accelerations.col(k).data());
+                k = runEnd;
+            }
+        }, TGL_BATCH_CHUNK_SIZE);
+        return TGL_OK;
+    }
+
+    // Counting sort of the times by bucket: 0 before the start, s + 1 for segment s and nSegments + 1 after the end.
+    std::vector<int> bucketOf(n);
+    std::vector<int> bucketStart(nSegments + 3, 0);
+    int cursor = 0;
+    for (int i = 0; i < n; ++i) {
+        const double t = times(i);
+        const int b = t < knotTimes.front() ? 0 : (t >= knotTimes.back() ? nSegments + 1 : locate(t, cursor) + 1);
+        bucketOf[i] = b;
+        ++bucketStart[b + 1];
+    }
+    for (int b = 1; b < nSegments + 3; ++b) {
+        bucketStart[b] += bucketStart[b - 1];
+    }
+    std::vector<int> sortedOrder(n), sortedBucket(n);
+    std::vector<int> next(bucketStart.begin(), bucketStart.end() - 1);
+    for (int i = 0; i < n; ++i) {
+        const int k = next[bucketOf[i]]++;
+        sortedOrder[k] = i;
+        sortedBucket[k] = bucketOf[i];
+    }
+
+    // Each thread takes a range of the sorted samples and runs the kernel once per bucket it contains, gathering the local times and scattering the results.
+    TglTools::parallelFor(n, [&](const int begin, const int end) {
+        std::vector<double> localTimes, pos, vel, acc;
+        int k = begin;
+        while (k < end) {
+            const int b = sortedBucket[k];
+            int runEnd = k + 1;
+            while (runEnd < end && sortedBucket[runEnd] == b) {
+                ++runEnd;
+            }
+            const int count = runEnd - k;
+            if (b == 0 || b == nSegments + 1) {
+                for (int j = k; j < runEnd; ++j) {
+                    hold(b == 0 ? startPos : endPos, sortedOrder[j]);
+                }
+            } else {
+                const int s = b - 1;
+                localTimes.resize(count);
+                pos.resize(dof * count);
+                vel.resize(dof * count);
+                acc.resize(dof * count);
+                for (int j = 0; j < count; ++j) {
+                    localTimes[j] = times(sortedOrder[k + j]) - knotTimes[s];
+                }
+                runSegmentKernel(kernel, coefficients.data() + dof * order * s, dof, order, localTimes.data(), count, pos.data(), vel.data(), acc.data());
+                for (int j = 0; j < count; ++j) {
+                    const int i = sortedOrder[k + j];
+                    positions.col(i) = Eigen::Map<const Eigen::VectorXd>(pos.data() + dof * j, dof);
+                    velocities.col(i) = Eigen::Map<const Eigen::VectorXd>(vel.data() + dof * j, dof);
+                    accelerations.col(i) = Eigen::Map<const Eigen::VectorXd>(acc.data() + dof * j, dof);
+                }
+            }
+            k = runEnd;
+        }
+    }, TGL_BATCH_CHUNK_SIZE);
+    return TGL_OK;
+}
+
+int PiecewisePolynomial::getDimension() const
+{
+    return coefficients.rows();
+}
+
+double PiecewisePolynomial::getStartTime() const
+{
+    return knotTimes.empty() ? 0.0 : knotTimes.front();
+}
+
+double PiecewisePolynomial::getEndTime() const
+{
+    return knotTimes.empty() ? 0.0 : knotTimes.back();
+}
+
+bool PiecewisePolynomial::empty() const
+{
+    return knotTimes.empty();
+}
+
+int PiecewisePolynomial::getNumberOfSegments() const
+{
+    return knotTimes.empty() ? 0 : knotTimes.size() - 1;
+}
+
+const StdDoubleVector& PiecewisePolynomial::getKnotTimes() const
+{
+    return knotTimes;
+}
+
+const Eigen::MatrixXd& PiecewisePolynomial::getCoefficients() const
+{
+    return coefficients;
+}
+
+int PiecewisePolynomial::getOrder() const
+{
+    return order;
+}
+
+TglMessage PiecewisePolynomial::evaluateSorted(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::MatrixXd& positions, Eigen::MatrixXd& velocities, Eigen::MatrixXd& accelerations) const
+{
+    if (knotTimes.empty()) {
+        TGL_REPORT_ERROR("The trajectory has not been built. Set some waypoints first.");
+        return TGL_ERROR;
+    }
+    const int n = times.size();
+    for (int i = 1; i < n; ++i) {
+        if (!(times(i) >= times(i-1))) {
+            TGL_REPORT_ERROR("The evaluation times must be sorted, time %.0f (%g) is before the previous one.", i, times(i));
+            return TGL_ERROR;
+        }
+    }
+
+    const int dof = coefficients.rows();
+    const int nSegments = knotTimes.size() - 1;
+    positions.resize(dof, n);
+    velocities.resize(dof, n);
+    accelerations.resize(dof, n);
+    const SegmentKernel kernel = segmentKernel;
+    auto runKernel = [&](const int segment, const double* localTimes, const int count, const int first) {
+        runSegmentKernel(kernel, coefficients.data() + dof * order * segment, dof, order, localTimes, count,
+                         positions.col(first).data(), velocities.col(first).data(), accelerations.col(first).data());
+    };
+
+    // Before the start: the start position at rest.
+    int i = 0;
+    while (i < n && times(i) < knotTimes.front()) {
+        positions.col(i) = coefficients.col(0);
+        velocities.col(i).setZero();
+        accelerations.col(i).setZero();
+        ++i;
+    }
+
+    // During the motion: one kernel call per segment over all its samples.
+    std::vector<double> localTimes;
+    int cursor = 0;
+    while (i < n && times(i) < knotTimes.back()) {
+        const int s = findSegment(times(i), cursor);
+        int end = i + 1;
+        while (end < n && times(end) < knotTimes[s+1]) {
+            ++end;
+        }
+        localTimes.resize(end - i);
+        for (int j = i; j < end; ++j) {
+            localTimes[j - i] = times(j) - knotTimes[s];
+        }
+        runKernel(s, localTimes.data(), end - i, i);
+        i = end;
+    }
+
+    // After the end: the end position at rest.
+    if (i < n) {
+        const double endLocalTime = knotTimes.back() - knotTimes[nSegments - 1];
+        runKernel(nSegments - 1, &endLocalTime, 1, i);
+        for (int j = i; j < n; ++j) {
+            positions.col(j) = positions.col(i);
+        }
+        velocities.rightCols(n - i).setZero();
+        accelerations.rightCols(n - i).setZero();
+    }
+    return TGL_OK;
+}
+
+int PiecewisePolynomial::findSegment(const double time, int& segmentCursor) const
+{
+    if (uniformStep <= 0.0) {
+        return TrajectoryCore::findSegment(knotTimes, time, segmentCursor);
+    }
+    const int nSegments = knotTimes.size() - 1;
+    const double position = (time - knotTimes.front()) / uniformStep;
+    int s = position <= 0.0 ? 0 : (position >= nSegments ? nSegments - 1 : (int)position);
+    // The knots are only uniform within rounding, so check the neighbours like the general search would.
+    if (s > 0 && time < knotTimes[s]) {
+        --s;
+    } else if (s < nSegments - 1 && time >= knotTimes[s+1]) {
+        ++s;
+    }
+    segmentCursor = s;
+    return s;
+}
+
+TglMessage PiecewisePolynomial::verifyLimits(const Eigen::VectorXd& maxVel,
+                                              const Eigen::VectorXd& maxAcc,
+                                              const Eigen::VectorXd& maxJerk,
+                                              std::vector<TglLimitViolation>& violations) const
+{
+    violations.clear();
+    if (knotTimes.empty()) {
+        LOG(ERROR) << "The trajectory has not been built. Set some waypoints first.";
+        return TGL_ERROR;
+    }
+    const int nDof = coefficients.rows();
+    const Eigen::VectorXd* limits[3] = {&maxVel, &maxAcc, &maxJerk};
+    for (int d = 0; d < 3; ++d) {
+        if (limits[d]->size() != 0 && limits[d]->size() != nDof) {
+            LOG(ERROR) << "The " << TglDerivative(d) << " limits have dimension " << limits[d]->size() << ", expected " << nDof << " or 0 to skip them.";
+            return TGL_ERROR;
+        }
+    }
+
+    // Worst |value| / limit ratio per derivative (rows) and DoF (columns), with the signed value and its time.
+    Eigen::ArrayXXd worstRatio = Eigen::ArrayXXd::Zero(3, nDof);
+    Eigen::ArrayXXd worstValue = Eigen::ArrayXXd::Zero(3, nDof);
+    Eigen::ArrayXXd worstTime = Eigen::ArrayXXd::Zero(3, nDof);
+    std::mutex worstMutex;
+
+    TglTools::parallelFor(knotTimes.size() - 1, [&](int begin, int end) {
+        Eigen::ArrayXXd ratio = Eigen::ArrayXXd::Zero(3, nDof), value = Eigen::ArrayXXd::Zero(3, nDof), time = Eigen::ArrayXXd::Zero(3, nDof);
+        Eigen::ArrayXXd inverseLimits = Eigen::ArrayXXd::Zero(3, nDof);
+        for (int d = 0; d < 3; ++d) {
+            if (limits[d]->size()) {
+                inverseLimits.row(d) = limits[d]->array().inverse().transpose();
+            }
+        }
+        // derivatives(k, m) is the coefficient of delta^k of the m-th derivative, roots[m] its roots inside the segment.
+        Eigen::MatrixXd derivatives = Eigen::MatrixXd::Zero(order, order);
+        std::vector<std::vector<double> > roots(order + 1);
+        std::vector<double> candidates;
+
+        for (int s = begin; s < end; ++s) {
+            const double t0 = knotTimes[s];
+            const double h = knotTimes[s+1] - t0;
+            for (int j = 0; j < nDof; ++j) {
+                for (int k = 0; k < order; ++k) {
+                    derivatives(k, 0) = coefficients(j, order * s + k);
+                }
+                for (int m = 1; m < order; ++m) {
+                    for (int k = 0; k < order - m; ++k) {
+                        derivatives(k, m) = (k + 1) * derivatives(k + 1, m - 1);
+                    }
+                }
+
+                // The extrema of a derivative are at the segment ends or at the roots of the next derivative. The roots are found from the highest derivative down, each one bracketed by those of the derivative above.
+                for (int m = order - 1; m >= 2; --m) {
+                    if (m >= order - 1) {
+                        roots[m].clear();
+                    } else {
+                        findRootsInSegment(derivatives.col(m).data(), order - m, derivatives.col(m + 1).data(), roots[m + 1], h, roots[m]);
+                    }
+                }
+                for (int d = 0; d < 3; ++d) {
+                    const int m = d + 1;
+                    if (inverseLimits(d, j) == 0.0 || m >= order) {
+                        continue;
+                    }
+                    candidates.assign(1, 0.0);
+                    if (m + 1 < order) {
+                        candidates.insert(candidates.end(), roots[m + 1].begin(), roots[m + 1].end());
+                    }
+                    candidates.push_back(h);
+                    for (const double localTime : candidates) {
+                        const double candidate = evaluatePolynomial(derivatives.col(m).data(), order - m, localTime);
+                        const double r = std::abs(candidate) * inverseLimits(d, j);
+                        if (r > ratio(d, j)) {
+                            ratio(d, j) = r;
+                            value(d, j) = candidate;
+                            time(d, j) = t0 + localTime;
+                        }
+                    }
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(worstMutex);
+        worstValue = (ratio > worstRatio).select(value, worstValue);
+        worstTime = (ratio > worstRatio).select(time, worstTime);
+        worstRatio = worstRatio.max(ratio);
+    });
+
+    for (int d = 0; d < 3; ++d) {
+        for (int j = 0; j < nDof; ++j) {
+            if (worstRatio(d, j) > 1.0) {
+                TglLimitViolation violation = {j, TglDerivative(d), worstTime(d, j), worstValue(d, j), (*limits[d])(j)};
+                violations.push_back(violation);
+            }
+        }
+    }
+    std::sort(violations.begin(), violations.end(), [](const TglLimitViolation& a, const TglLimitViolation& b) {
+        return std::abs(a.value) / a.limit > std::abs(b.value) / b.limit;
+    });
+    return violations.empty() ? TGL_OK : TGL_WARNING;
+}
+
+TglMessage PiecewisePolynomial::slice(const double sliceStartTime, const double sliceEndTime, std::shared_ptr<const PiecewisePolynomial>& sliced) const
+{
+    if (knotTimes.empty()) {
+        LOG(ERROR) << "Cannot slice an empty piecewise polynomial.";
+        return TGL_ERROR;
+    }
+    if (!(sliceStartTime >= knotTimes.front() && sliceStartTime < sliceEndTime && sliceEndTime <= knotTimes.back())) {
+        LOG(ERROR) << "The slice [" << sliceStartTime << ", " << sliceEndTime << "] is not an interval within [" << knotTimes.front() << ", " << knotTimes.back() << "].";
+        return TGL_ERROR;
+    }
+
+    int cursor = 0;
+    const int first = findSegment(sliceStartTime, cursor);
+    int last = findSegment(sliceEndTime, cursor);
+    if (last > first && knotTimes[last] >= sliceEndTime) {
+        --last;
+    }
+
+    StdDoubleVector sliceKnotTimes(knotTimes.begin() + first, knotTimes.begin() + last + 2);
+    sliceKnotTimes.front() = sliceStartTime;
+    sliceKnotTimes.back() = sliceEndTime;
+    Eigen::MatrixXd sliceCoefficients = coefficients.middleCols(order * first, order * (last - first + 1));
+
+    // Taylor shift of the first segment to the slice start, by repeated synthetic division.
+    const double shift = sliceStartTime - knotTimes[first];
+    for (int i = 0; i < order - 1; ++i) {
+        for (int j = order - 2; j >= i; --j) {
+            sliceCoefficients.col(j) += shift * sliceCoefficients.col(j + 1);
+        }
+    }
+
+    sliced = std::make_shared<PiecewisePolynomial>(std::move(sliceKnotTimes), std::move(sliceCoefficients), order);
+    return TGL_OK;
+}
+
+TglMessage PiecewisePolynomial::serialize(std::ostream& stream) const
+{
+    if (knotTimes.empty()) {
+        LOG(ERROR) << "Cannot serialize an empty piecewise polynomial.";
+        return TGL_ERROR;
+    }
+
+    PolynomialStreamHeader header;
+    std::memcpy(header.magic, "TGLP", 4);
+    header.version = polynomialStreamVersion;
+    header.byteOrder = polynomialByteOrder;
+    header.order = order;
+    header.nKnots = knotTimes.size();
+    header.rows = coefficients.rows();
+    header.checksum = TglTools::hashBytes(coefficients.data(), sizeof(double) * coefficients.size(), TglTools::hashBytes(knotTimes.data(), sizeof(double) * knotTimes.size()));
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(knotTimes.data()), sizeof(double) * knotTimes.size());
+    stream.write(reinterpret_cast<const char*>(coefficients.data()), sizeof(double) * coefficients.size());
+    if (!stream) {
+        LOG(ERROR) << "Could not write the piecewise polynomial to the stream.";
+        return TGL_ERROR;
+    }
+    return TGL_OK;
+}
+
+TglMessage PiecewisePolynomial::deserialize(std::istream& stream, std::shared_ptr<const PiecewisePolynomial>& polynomial)
+{
+    PolynomialStreamHeader header;
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        LOG(ERROR) << "Could not read a piecewise polynomial header from the stream.";
+        return TGL_ERROR;
+    }
+    if (std::memcmp(header.magic, "TGLP", 4) != 0 || header.version != polynomialStreamVersion || header.byteOrder != polynomialByteOrder) {
+        LOG(ERROR) << "The stream does not hold a piecewise polynomial of version " << polynomialStreamVersion << " in this byte order.";
+        return TGL_ERROR;
+    }
+    // Bound the sizes before allocating, a corrupt header must not ask for terabytes. Each factor is bounded first so the products can not overflow, and the columns must fit the int segment indices.
+    if (header.order < 1 || header.order > TGL_SERIALIZED_MAX_ORDER || header.nKnots < 2 || header.rows > (1ULL << 20)
+        || header.nKnots - 1 > uint64_t(std::numeric_limits<int>::max() / header.order)) {
+        LOG(ERROR) << "The piecewise polynomial header has invalid sizes.";
+        return TGL_ERROR;
+    }
+    const uint64_t nColumns = header.order * (header.nKnots - 1);
+    const uint64_t dataBytes = sizeof(double) * (header.nKnots + header.rows * nColumns);
+    if (dataBytes > TGL_SERIALIZED_MAX_BYTES) {
+        LOG(ERROR) << "The piecewise polynomial holds " << dataBytes << " bytes, more than the limit of " << TGL_SERIALIZED_MAX_BYTES << ".";
+        return TGL_ERROR;
+    }
+    // On a seekable stream the data must also be there, a truncated file is rejected before allocating.
+    const std::streampos dataStart = stream.tellg();
+    if (dataStart != std::streampos(-1)) {
+        stream.seekg(0, std::ios::end);
+        const std::streamoff bytesLeft = stream ? std::streamoff(stream.tellg() - dataStart) : -1;
+        stream.clear();
+        stream.seekg(dataStart);
+        if (bytesLeft >= 0 && uint64_t(bytesLeft) < dataBytes) {
+            LOG(ERROR) << "The piecewise polynomial needs " << dataBytes << " bytes but the stream only holds " << bytesLeft << ".";
+            return TGL_ERROR;
+        }
+    }
+
+    StdDoubleVector newKnotTimes;
+    Eigen::MatrixXd newCoefficients;
+    try {
+        newKnotTimes.resize(header.nKnots);
+        newCoefficients.resize(Eigen::Index(header.rows), Eigen::Index(nColumns));
+    } catch (const std::bad_alloc&) {
+        LOG(ERROR) << "Could not allocate the " << dataBytes << " bytes of the piecewise polynomial.";
+        return TGL_ERROR;
+    }
+    stream.read(reinterpret_cast<char*>(newKnotTimes.data()), std::streamsize(sizeof(double) * newKnotTimes.size()));
+    stream.read(reinterpret_cast<char*>(newCoefficients.data()), std::streamsize(sizeof(double) * newCoefficients.size()));
+    if (!stream) {
+        LOG(ERROR) << "The stream ended in the middle of a piecewise polynomial.";
+        return TGL_ERROR;
+    }
+    if (TglTools::hashBytes(newCoefficients.data(), sizeof(double) * newCoefficients.size(), TglTools::hashBytes(newKnotTimes.data(), sizeof(double) * newKnotTimes.size())) != header.checksum) {
+        LOG(ERROR) << "The piecewise polynomial checksum does not match, the data is corrupt.";
+        return TGL_ERROR;
+    }
+
+    polynomial = std::make_shared<PiecewisePolynomial>(std::move(newKnotTimes), std::move(newCoefficients), static_cast<int>(header.order));
+    return TGL_OK;
+}
+
+std::size_t PiecewisePolynomial::getMemoryUsage() const
+{
+    return sizeof(PiecewisePolynomial) + sizeof(double) * (knotTimes.capacity() + coefficients.size());
+}
@@ -0,0 +1,141 @@
+/*! \file       PolynomialKernel.cpp
+ *  \brief      Piecewise polynomial storage and evaluation templated on the scalar type.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/PolynomialKernel.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <algorithm>
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+template<typename Scalar>
+PolynomialKernel<Scalar>::PolynomialKernel():
+order(0)
+{
+}
+
+template<typename Scalar>
+PolynomialKernel<Scalar>::PolynomialKernel(const PiecewisePolynomial& core):
+knotTimes(core.getKnotTimes()),
+coefficients(core.getCoefficients().template cast<Scalar>()),
+order(core.getOrder())
+{
+}
+
+template<typename Scalar>
+TglMessage PolynomialKernel<Scalar>::evaluate(VectorType& desiredPos, VectorType& desiredVel, VectorType& desiredAcc, const double time, int& segmentCursor) const
+{
+    if (knotTimes.empty()) {
+        TGL_REPORT_ERROR("The polynomial kernel is empty.");
+        return TGL_ERROR;
+    }
+
+    TglMessage status = TGL_RUNNING;
+    double t = time;
+    if (t < knotTimes.front()) {
+        t = knotTimes.front();
+        status = TGL_START;
+    } else if (t >= knotTimes.back()) {
+        t = knotTimes.back();
+        status = TGL_FINISHED;
+    }
+
+    const int s = TrajectoryCore::findSegment(knotTimes, t, segmentCursor);
+    // The local time is computed in double, only the small offset is rounded.
+    const Scalar dt = static_cast<Scalar>(t - knotTimes[s]);
+    const auto c = coefficients.middleCols(order * s, order);
+
+    desiredPos.resize(coefficients.rows());
+    desiredVel.resize(coefficients.rows());
+    desiredAcc.resize(coefficients.rows());
+    desiredPos = c.col(order - 1);
+    desiredVel.setZero();
+    desiredAcc.setZero();
+    for (int k = order - 1; k >= 1; --k) {
+        if (k >= 2) {
+            desiredAcc = dt * desiredAcc + Scalar(k * (k - 1)) * c.col(k);
+        }
+        desiredVel = dt * desiredVel + Scalar(k) * c.col(k);
+        desiredPos = dt * desiredPos + c.col(k - 1);
+    }
+
+    if (status != TGL_RUNNING) {
+        desiredVel.setZero();
+        desiredAcc.setZero();
+    }
+    return status;
+}
+
+template<typename Scalar>
+void PolynomialKernel<Scalar>::samplePositions(const double startTime, const double timeStep, MatrixType& positions) const
+{
+    if (knotTimes.empty()) {
+        LOG(ERROR) << "The polynomial kernel is empty.";
+        return;
+    }
+    positions.conservativeResize(coefficients.rows(), positions.cols());
+    int segmentCursor = 0;
+    for (int k = 0; k < positions.cols(); ++k) {
+        const double t = std::min(std::max(startTime + k * timeStep, knotTimes.front()), knotTimes.back());
+        const int s = TrajectoryCore::findSegment(knotTimes, t, segmentCursor);
+        const Scalar dt = static_cast<Scalar>(t - knotTimes[s]);
+        const auto c = coefficients.middleCols(order * s, order);
+        positions.col(k) = c.col(order - 1);
+        for (int j = order - 2; j >= 0; --j) {
+            positions.col(k) = dt * positions.col(k) + c.col(j);
+        }
+    }
+}
+
+template<typename Scalar>
+int PolynomialKernel<Scalar>::getDimension() const
+{
+    return coefficients.rows();
+}
+
+template<typename Scalar>
+std::size_t PolynomialKernel<Scalar>::getMemoryUsage() const
+{
+    return sizeof(PolynomialKernel<Scalar>) + sizeof(double) * knotTimes.capacity() + sizeof(Scalar) * coefficients.size();
+}
+
+
+namespace tgl
+{
+template class PolynomialKernel<float>;
+template class PolynomialKernel<double>;
+}
@@ -0,0 +1,136 @@
+/*! \file       PolynomialTrajectory.cpp
+ *  \brief      A trajectory which evaluates a given piecewise polynomial.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/PolynomialTrajectory.hpp"
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+PolynomialTrajectory::PolynomialTrajectory():
+polynomial(std::make_shared<PiecewisePolynomial>()),
+segmentCursor(0)
+{
+}
+
+PolynomialTrajectory::PolynomialTrajectory(std::shared_ptr<const PiecewisePolynomial> newPolynomial):
+polynomial(std::make_shared<PiecewisePolynomial>()),
+segmentCursor(0)
+{
+    if(!setPolynomial(std::move(newPolynomial)))
+        LOG(ERROR) << "Could not set the polynomial you passed to the trajectory.";
+}
+
+PolynomialTrajectory::~PolynomialTrajectory()
+{
+}
+
+TglMessage PolynomialTrajectory::setWaypoints(const WaypointSet&)
+{
+    LOG(ERROR) << "A PolynomialTrajectory is defined by its polynomial, use setPolynomial() instead of setWaypoints().";
+    return TGL_ERROR;
+}
+
+TglMessage PolynomialTrajectory::setPolynomial(std::shared_ptr<const PiecewisePolynomial> newPolynomial)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    polynomial = std::make_shared<PiecewisePolynomial>();
+    segmentCursor = 0;
+
+    if (!newPolynomial || newPolynomial->empty()) {
+        LOG(ERROR) << "A PolynomialTrajectory needs a non-empty polynomial.";
+        return TGL_ERROR;
+    }
+
+    const StdDoubleVector& knotTimes = newPolynomial->getKnotTimes();
+    const int nSegments = newPolynomial->getNumberOfSegments();
+    const int order = newPolynomial->getOrder();
+    Eigen::MatrixXd positions(newPolynomial->getDimension(), nSegments + 1);
+    for (int i = 0; i < nSegments; ++i) {
+        positions.col(i) = newPolynomial->getCoefficients().col(order * i);
+    }
+    Eigen::VectorXd endPos, endVel, endAcc;
+    int cursor = nSegments - 1;
+    newPolynomial->evaluate(endPos, endVel, endAcc, newPolynomial->getEndTime(), cursor);
+    positions.col(nSegments) = endPos;
+
+    WaypointSet knotWpts;
+    if (!knotWpts.assign(Eigen::Map<const Eigen::VectorXd>(knotTimes.data(), nSegments + 1), positions)) {
+        return TGL_ERROR;
+    }
+    Trajectory::setWaypoints(knotWpts);
+    polynomial = std::move(newPolynomial);
+    countRebuild(buildStart);
+    return TGL_OK;
+}
+
+std::shared_ptr<const PiecewisePolynomial> PolynomialTrajectory::getPolynomial() const
+{
+    return polynomial;
+}
+
+int PolynomialTrajectory::getDimension() const
+{
+    return polynomial->getDimension();
+}
+
+std::size_t PolynomialTrajectory::getMemoryUsage() const
+{
+    return Trajectory::getMemoryUsage() + sizeof(PolynomialTrajectory) - sizeof(Trajectory) + polynomial->getMemoryUsage();
+}
+
+TrajectoryCorePtr PolynomialTrajectory::getCore() const
+{
+    return polynomial;
+}
+
+TglMessage PolynomialTrajectory::verifyLimits(const Eigen::VectorXd& maxVel,
+                                              const Eigen::VectorXd& maxAcc,
+                                              const Eigen::VectorXd& maxJerk,
+                                              std::vector<TglLimitViolation>& violations) const
+{
+    return polynomial->verifyLimits(maxVel, maxAcc, maxJerk, violations);
+}
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage PolynomialTrajectory::getImplementationDesired( Eigen::VectorXd& desiredPos,
+                                                           Eigen::VectorXd& desiredVel,
+                                                           Eigen::VectorXd& desiredAcc,
+                                                           const double time_step)
+{
+    const int previousSegment = segmentCursor;
+    const TglMessage status = polynomial->evaluate(desiredPos, desiredVel, desiredAcc, time_step, segmentCursor);
+    countSegmentLookup(previousSegment, segmentCursor);
+    return status;
+}
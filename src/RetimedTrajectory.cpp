@@ -0,0 +1,171 @@
+/*! \file       RetimedTrajectory.cpp
+ *  \brief      A retiming layer applying a live speed override to any trajectory.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/RetimedTrajectory.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <algorithm>
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+RetimedTrajectory::RetimedTrajectory():
+rampStartTime(0.0),
+rampStartPathTime(0.0),
+rampDuration(0.0),
+startSpeedScale(1.0),
+startSpeedScaleRate(0.0),
+targetSpeedScale(1.0)
+{
+}
+
+RetimedTrajectory::RetimedTrajectory(TrajectoryPtr newPath):
+rampStartTime(0.0),
+rampStartPathTime(0.0),
+rampDuration(0.0),
+startSpeedScale(1.0),
+startSpeedScaleRate(0.0),
+targetSpeedScale(1.0)
+{
+    if(!setPath(newPath))
+        LOG(ERROR) << "Could not set the path of the trajectory.";
+}
+
+RetimedTrajectory::~RetimedTrajectory()
+{
+}
+
+TglMessage RetimedTrajectory::setPath(TrajectoryPtr newPath)
+{
+    if (!newPath) {
+        LOG(ERROR) << "The path is null.";
+        return TGL_ERROR;
+    }
+    path = newPath;
+    rampStartTime = 0.0;
+    rampStartPathTime = 0.0;
+    rampDuration = 0.0;
+    startSpeedScale = 1.0;
+    startSpeedScaleRate = 0.0;
+    targetSpeedScale = 1.0;
+    return resetInternalClock();
+}
+
+TglMessage RetimedTrajectory::setSpeedOverride(const double newSpeedScale, const double newRampDuration, const double time)
+{
+    if (newSpeedScale < 0.0 || newRampDuration < 0.0) {
+        LOG(ERROR) << "The speed scale and the ramp duration must not be negative, got " << newSpeedScale << " and " << newRampDuration << ".";
+        return TGL_ERROR;
+    }
+    double tmp_time = time == TGL_USE_INTERNAL_CLOCK ? getInternalClockTime() : time;
+
+    // Restart the ramp from wherever the current one is, so the path time, the scale and its rate stay continuous.
+    double pathTime, speedScale, speedScaleRate;
+    evaluateRetiming(tmp_time, pathTime, speedScale, speedScaleRate);
+    rampStartTime = tmp_time;
+    rampStartPathTime = pathTime;
+    rampDuration = newRampDuration;
+    startSpeedScale = speedScale;
+    // The rate term D * rate * u * (1 - u)^2 cannot take the scale below zero when rate >= -s0 / D.
+    startSpeedScaleRate = newRampDuration > 0.0 ? std::max(speedScaleRate, -speedScale / newRampDuration) : 0.0;
+    targetSpeedScale = newSpeedScale;
+    return TGL_OK;
+}
+
+double RetimedTrajectory::getSpeedScale(const double time) const
+{
+    double pathTime, speedScale, speedScaleRate;
+    evaluateRetiming(time, pathTime, speedScale, speedScaleRate);
+    return speedScale;
+}
+
+double RetimedTrajectory::getPathTime(const double time) const
+{
+    double pathTime, speedScale, speedScaleRate;
+    evaluateRetiming(time, pathTime, speedScale, speedScaleRate);
+    return pathTime;
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage RetimedTrajectory::getImplementationDesired( Eigen::VectorXd& desiredPos,
+                                                        Eigen::VectorXd& desiredVel,
+                                                        Eigen::VectorXd& desiredAcc,
+                                                        const double time_step)
+{
+    if (!path) {
+        TGL_REPORT_ERROR("The trajectory has no path. Use setPath() first.");
+        return TGL_ERROR;
+    }
+
+    double pathTime, speedScale, speedScaleRate;
+    evaluateRetiming(time_step, pathTime, speedScale, speedScaleRate);
+    TglMessage pathMessage = path->getDesired(desiredPos, desiredVel, desiredAcc, pathTime);
+    if (pathMessage == TGL_ERROR) {
+        return TGL_ERROR;
+    }
+    desiredAcc *= speedScale * speedScale;
+    desiredAcc += speedScaleRate * desiredVel;
+    desiredVel *= speedScale;
+    return pathMessage;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void RetimedTrajectory::evaluateRetiming(const double time, double& pathTime, double& speedScale, double& speedScaleRate) const
+{
+    const double deltaScale = targetSpeedScale - startSpeedScale;
+    const double rateScale = rampDuration * startSpeedScaleRate;
+    const double elapsed = time - rampStartTime;
+    speedScaleRate = 0.0;
+    if (elapsed < 0.0) {
+        speedScale = startSpeedScale;
+        pathTime = rampStartPathTime + startSpeedScale * elapsed;
+    } else if (elapsed >= rampDuration) {
+        speedScale = targetSpeedScale;
+        pathTime = rampStartPathTime + rampDuration * (startSpeedScale + 0.5 * deltaScale + rateScale / 12.0) + targetSpeedScale * (elapsed - rampDuration);
+    } else {
+        // Cubic Hermite ramp of the scale from its starting value and rate, integrated in closed form for the path time.
+        const double u = elapsed / rampDuration;
+        const double v = 1.0 - u;
+        speedScale = startSpeedScale + deltaScale * u * u * (3.0 - 2.0 * u) + rateScale * u * v * v;
+        speedScaleRate = (deltaScale * 6.0 * u * v + rateScale * v * (1.0 - 3.0 * u)) / rampDuration;
+        pathTime = rampStartPathTime + rampDuration * (startSpeedScale * u + deltaScale * u * u * u * (1.0 - 0.5 * u) + rateScale * u * u * (0.5 - 2.0 * u / 3.0 + 0.25 * u * u));
+    }
+}
@@ -0,0 +1,163 @@
+/*! \file       SampleRange.cpp
+ *  \brief      A lazy range of trajectory samples for streaming output.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/SampleRange.hpp"
+#include "tgl/Trajectory.hpp"
+#include "tgl/TrajectoryEvaluator.hpp"
+
+// STL includes
+#include <cmath>
+
+
+using namespace tgl;
+
+/*! The number of samples from start to end, the end being included when it is within rounding of the grid.
+ */
+static long countSamples(const double timeStep, const double startTime, const double endTime)
+{
+    if (!(timeStep > 0.0)) {
+        LOG(ERROR) << "The sample time step must be positive, got " << timeStep << ".";
+        return 0;
+    }
+    if (!(endTime >= startTime)) {
+        return 0;
+    }
+    return static_cast<long>(std::floor((endTime - startTime) / timeStep + 1e-9)) + 1;
+}
+
+/****************************************************
+                   Iterator
+ ****************************************************/
+
+SampleRange::Iterator::Iterator(SampleRange* newRange, const long newIndex):
+range(newRange),
+index(newIndex)
+{
+}
+
+SampleRange::Iterator::reference SampleRange::Iterator::operator*() const
+{
+    return range->sample;
+}
+
+SampleRange::Iterator::pointer SampleRange::Iterator::operator->() const
+{
+    return &range->sample;
+}
+
+SampleRange::Iterator& SampleRange::Iterator::operator++()
+{
+    if (++index < range->nSamples) {
+        range->evaluate(index);
+    }
+    return *this;
+}
+
+SampleRange::Iterator::PostIncrement SampleRange::Iterator::operator++(int)
+{
+    PostIncrement previous(range->sample);
+    ++*this;
+    return previous;
+}
+
+SampleRange::Iterator::PostIncrement::PostIncrement(const TrajectorySample& newSample):
+sample(newSample)
+{
+}
+
+const TrajectorySample& SampleRange::Iterator::PostIncrement::operator*() const
+{
+    return sample;
+}
+
+bool SampleRange::Iterator::operator==(const Iterator& other) const
+{
+    return index == other.index;
+}
+
+bool SampleRange::Iterator::operator!=(const Iterator& other) const
+{
+    return index != other.index;
+}
+
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+SampleRange::SampleRange(Trajectory& newTrajectory, const double newTimeStep, const double newStartTime, const double newEndTime):
+trajectory(&newTrajectory),
+evaluator(NULL),
+timeStep(newTimeStep),
+startTime(newStartTime),
+nSamples(countSamples(newTimeStep, newStartTime, newEndTime))
+{
+}
+
+SampleRange::SampleRange(TrajectoryEvaluator& newEvaluator, const double newTimeStep, const double newStartTime, const double newEndTime):
+trajectory(NULL),
+evaluator(&newEvaluator),
+timeStep(newTimeStep),
+startTime(newStartTime),
+nSamples(countSamples(newTimeStep, newStartTime, newEndTime))
+{
+}
+
+SampleRange::Iterator SampleRange::begin()
+{
+    if (nSamples > 0) {
+        evaluate(0);
+    }
+    return Iterator(this, 0);
+}
+
+SampleRange::Iterator SampleRange::end()
+{
+    return Iterator(this, nSamples);
+}
+
+long SampleRange::size() const
+{
+    return nSamples;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void SampleRange::evaluate(const long index)
+{
+    // Multiplying rather than accumulating keeps long ranges on the grid. A grid time can be exactly -1, so the samples go through getDesiredAt() which does not read it as TGL_USE_INTERNAL_CLOCK.
+    sample.time = startTime + index * timeStep;
+    if (trajectory) {
+        sample.status = trajectory->getDesiredAt(sample.position, sample.velocity, sample.acceleration, sample.time);
+    } else {
+        sample.status = evaluator->getDesiredAt(sample.position, sample.velocity, sample.acceleration, sample.time);
+    }
+}
@@ -0,0 +1,283 @@
+/*! \file       Se3BSplineTrajectory.cpp
+ *  \brief      A cumulative cubic B-spline trajectory on SE(3) for Displacementd waypoints.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/Se3BSplineTrajectory.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+
+using namespace tgl;
+
+/*! Computes the 4 non-zero cubic B-spline basis functions of a knot span (The NURBS Book, algorithm A2.2).
+ *  \param span the knot span index i such that knots[i] <= u < knots[i+1]
+ *  \param u the parameter value
+ *  \param knots the knot vector
+ *  \param basis the values of the basis functions i-3 to i
+ */
+static void cubicBasisFunctions(const int span, const double u, const StdDoubleVector& knots, Eigen::Vector4d& basis)
+{
+    double left[4], right[4];
+    basis(0) = 1.0;
+    for (int j = 1; j <= 3; ++j) {
+        left[j] = u - knots[span + 1 - j];
+        right[j] = knots[span + j] - u;
+        double saved = 0.0;
+        for (int r = 0; r < j; ++r) {
+            double tmp = basis(r) / (right[r + 1] + left[j - r]);
+            basis(r) = saved + right[r + 1] * tmp;
+            saved = left[j - r] * tmp;
+        }
+        basis(j) = saved;
+    }
+}
+
+/*! The se(3) Lie bracket with twists ordered angular then linear.
+ */
+static Vector6d lieBracket(const Vector6d& a, const Vector6d& b)
+{
+    Vector6d res;
+    res.head<3>() = a.head<3>().cross(b.head<3>());
+    res.tail<3>() = a.head<3>().cross(b.tail<3>()) - b.head<3>().cross(a.tail<3>());
+    return res;
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+Se3BSplineTrajectory::Se3BSplineTrajectory():
+segmentCursor(0)
+{
+}
+
+Se3BSplineTrajectory::Se3BSplineTrajectory(const WaypointSet& newWptSet):
+segmentCursor(0)
+{
+    if(!setWaypoints(newWptSet))
+        LOG(ERROR) << "Could not set the waypoints you passed to the trajectory.";
+}
+
+Se3BSplineTrajectory::~Se3BSplineTrajectory()
+{
+}
+
+TglMessage Se3BSplineTrajectory::getDesired(Eigen::Displacementd& desiredPose,
+                                            Eigen::Twistd& desiredTwist,
+                                            Eigen::Twistd& desiredTwistDerivative,
+                                            const double time_step)
+{
+    double tmp_time_step = time_step == TGL_USE_INTERNAL_CLOCK ? getInternalClockTime() : time_step;
+    Vector6d twist, twistDerivative;
+    TglMessage evaluationMessage = evaluate(tmp_time_step, desiredPose, twist, twistDerivative);
+    desiredTwist = Eigen::Twistd(twist);
+    desiredTwistDerivative = Eigen::Twistd(twistDerivative);
+    if (evaluationMessage == TGL_FINISHED) {
+        resetInternalClock();
+    }
+    return evaluationMessage;
+}
+
+TglMessage Se3BSplineTrajectory::getDesiredBatch(   const Eigen::VectorXd& times,
+                                                    Eigen::MatrixXd& desiredPoses,
+                                                    Eigen::MatrixXd& desiredTwists,
+                                                    Eigen::MatrixXd& desiredTwistDerivatives)
+{
+    if (controlPoses.empty()) {
+        TGL_REPORT_ERROR("The trajectory has not been built. Set some waypoints first.");
+        return TGL_ERROR;
+    }
+    desiredPoses.resize(7, times.size());
+    desiredTwists.resize(6, times.size());
+    desiredTwistDerivatives.resize(6, times.size());
+
+    Eigen::Displacementd pose;
+    Vector6d twist, twistDerivative;
+    for (int i = 0; i < times.size(); ++i) {
+        evaluate(times(i), pose, twist, twistDerivative);
+        Eigen::Vector3d translation = pose.getTranslation();
+        Eigen::Rotation3d rotation = pose.getRotation();
+        desiredPoses.col(i) << translation, rotation.w(), rotation.x(), rotation.y(), rotation.z();
+        desiredTwists.col(i) << twist.tail<3>(), twist.head<3>();
+        desiredTwistDerivatives.col(i) << twistDerivative.tail<3>(), twistDerivative.head<3>();
+    }
+    return TGL_OK;
+}
+
+TglMessage Se3BSplineTrajectory::setWaypoints(const WaypointSet& newWptSet)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    knotTimes.clear();
+    controlPoses.clear();
+    controlLogs.clear();
+    cumulativeBasis.clear();
+    segmentCursor = 0;
+
+    if (newWptSet.getWaypointType() != TGL_WPT_LGSM_DISP) {
+        LOG(ERROR) << "Se3BSplineTrajectory needs waypoints of type TGL_WPT_LGSM_DISP, got " << newWptSet.getWaypointType() << ".";
+        return TGL_ERROR;
+    }
+
+    ConstVectorMap times = newWptSet.getWaypointTimesView();
+    ConstMatrixMap positions = newWptSet.asMatrixView();
+    ConstMatrixMap quaternions = newWptSet.rotationsAsMatrixView();
+    const int nWpts = times.size();
+
+    if (nWpts < 2) {
+        LOG(ERROR) << "Se3BSplineTrajectory needs at least 2 waypoints, got " << nWpts << ".";
+        return TGL_ERROR;
+    }
+    if ((times.tail(nWpts - 1) - times.head(nWpts - 1)).minCoeff() <= 0.0) {
+        LOG(ERROR) << "Se3BSplineTrajectory needs strictly increasing waypoint times.";
+        return TGL_ERROR;
+    }
+
+    Trajectory::setWaypoints(newWptSet);
+
+    // Control poses: the waypoints with the first and last doubled so the motion is clamped at rest on both ends.
+    controlPoses.reserve(nWpts + 2);
+    for (int i = 0; i < nWpts; ++i) {
+        Eigen::Displacementd wptPose(positions(0,i), positions(1,i), positions(2,i), quaternions(0,i), quaternions(1,i), quaternions(2,i), quaternions(3,i));
+        controlPoses.push_back(wptPose);
+        if (i == 0 || i == nWpts - 1) {
+            controlPoses.push_back(wptPose);
+        }
+    }
+
+    // Cache the log maps once, evaluations only need exponentials.
+    controlLogs.resize(controlPoses.size(), Vector6d::Zero());
+    for (std::size_t k = 1; k < controlPoses.size(); ++k) {
+        controlLogs[k] = (controlPoses[k-1].inverse() * controlPoses[k]).log();
+    }
+
+    // Clamped knot vector whose interior knots are the interior waypoint times.
+    StdDoubleVector knots(3, times(0));
+    knots.insert(knots.end(), times.data(), times.data() + nWpts);
+    knots.insert(knots.end(), 3, times(nWpts - 1));
+    knotTimes.assign(times.data(), times.data() + nWpts);
+
+    // On each segment the basis functions are cubics in the normalized time, recover their coefficients from 4 samples.
+    Eigen::Matrix4d vandermonde;
+    for (int q = 0; q < 4; ++q) {
+        double tau = q / 3.0;
+        vandermonde.row(q) << 1.0, tau, tau*tau, tau*tau*tau;
+    }
+    Eigen::FullPivLU<Eigen::Matrix4d> vandermondeLu(vandermonde);
+
+    cumulativeBasis.resize(nWpts - 1);
+    for (int s = 0; s < nWpts - 1; ++s) {
+        const int span = s + 3;
+        Eigen::Matrix4d basisSamples; // rows: samples, cols: basis functions
+        for (int q = 0; q < 4; ++q) {
+            Eigen::Vector4d basis;
+            cubicBasisFunctions(span, knotTimes[s] + (knotTimes[s+1] - knotTimes[s]) * q / 3.0, knots, basis);
+            basisSamples.row(q) = basis.transpose();
+        }
+        Eigen::Matrix4d basisCoefficients = vandermondeLu.solve(basisSamples).transpose(); // rows: basis functions, cols: powers
+        cumulativeBasis[s].row(0) = basisCoefficients.row(1) + basisCoefficients.row(2) + basisCoefficients.row(3);
+        cumulativeBasis[s].row(1) = basisCoefficients.row(2) + basisCoefficients.row(3);
+        cumulativeBasis[s].row(2) = basisCoefficients.row(3);
+    }
+
+    countRebuild(buildStart);
+    return TGL_OK;
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage Se3BSplineTrajectory::getImplementationDesired(  Eigen::VectorXd& desiredPos,
+                                                            Eigen::VectorXd& desiredVel,
+                                                            Eigen::VectorXd& desiredAcc,
+                                                            const double time_step)
+{
+    Eigen::Displacementd pose;
+    Vector6d twist, twistDerivative;
+    TglMessage evaluationMessage = evaluate(time_step, pose, twist, twistDerivative);
+    if (evaluationMessage == TGL_ERROR) {
+        return TGL_ERROR;
+    }
+    Eigen::Vector3d translation = pose.getTranslation();
+    Eigen::Rotation3d rotation = pose.getRotation();
+    desiredPos.resize(7);
+    desiredVel.resize(6);
+    desiredAcc.resize(6);
+    desiredPos << translation, rotation.w(), rotation.x(), rotation.y(), rotation.z();
+    desiredVel << twist.tail<3>(), twist.head<3>();
+    desiredAcc << twistDerivative.tail<3>(), twistDerivative.head<3>();
+    return evaluationMessage;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+TglMessage Se3BSplineTrajectory::evaluate(const double time, Eigen::Displacementd& pose, Vector6d& twist, Vector6d& twistDerivative)
+{
+    if (controlPoses.empty()) {
+        TGL_REPORT_ERROR("The trajectory has not been built. Set some waypoints first.");
+        return TGL_ERROR;
+    }
+
+    TglMessage status = TGL_RUNNING;
+    double clampedTime = time;
+    if (time < knotTimes.front()) {
+        clampedTime = knotTimes.front();
+        status = TGL_START;
+    } else if (time >= knotTimes.back()) {
+        clampedTime = knotTimes.back();
+        status = TGL_FINISHED;
+    }
+
+    const int s = findSegment(knotTimes, clampedTime, segmentCursor);
+    const double dt = knotTimes[s+1] - knotTimes[s];
+    const double tau = (clampedTime - knotTimes[s]) / dt;
+
+    Eigen::Vector3d b   = cumulativeBasis[s] * Eigen::Vector4d(1.0, tau, tau*tau, tau*tau*tau);
+    Eigen::Vector3d db  = cumulativeBasis[s] * Eigen::Vector4d(0.0, 1.0, 2.0*tau, 3.0*tau*tau) / dt;
+    Eigen::Vector3d ddb = cumulativeBasis[s] * Eigen::Vector4d(0.0, 0.0, 2.0, 6.0*tau) / (dt*dt);
+
+    pose = controlPoses[s];
+    twist.setZero();
+    twistDerivative.setZero();
+    for (int j = 0; j < 3; ++j) {
+        const Vector6d& omega = controlLogs[s+j+1];
+        Eigen::Displacementd increment = Eigen::Twistd(b(j) * omega).exp();
+        Eigen::Matrix<double, 6, 6> adjointInverse = increment.inverse().adjoint();
+        pose = pose * increment;
+        twist = adjointInverse * twist + db(j) * omega;
+        twistDerivative = adjointInverse * twistDerivative + db(j) * lieBracket(twist, omega) + ddb(j) * omega;
+    }
+
+    if (status != TGL_RUNNING) {
+        twist.setZero();
+        twistDerivative.setZero();
+    }
+    return status;
+}
@@ -0,0 +1,131 @@
+/*! \file       SegmentBvh.cpp
+ *  \brief      A bounding volume hierarchy over the segments of a piecewise trajectory.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/SegmentBvh.hpp"
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+#ifndef TGL_BVH_LEAF_SIZE /*!< The maximum number of segments in a leaf of a SegmentBvh. */
+#define TGL_BVH_LEAF_SIZE 4
+#endif
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+SegmentBvh::SegmentBvh()
+{
+}
+
+SegmentBvh::~SegmentBvh()
+{
+}
+
+TglMessage SegmentBvh::build(const Eigen::MatrixXd& boxMin, const Eigen::MatrixXd& boxMax)
+{
+    clear();
+    if (boxMin.rows() != boxMax.rows() || boxMin.cols() != boxMax.cols()) {
+        LOG(ERROR) << "The box corners do not have the same size: " << boxMin.rows() << "x" << boxMin.cols() << " and " << boxMax.rows() << "x" << boxMax.cols() << ".";
+        return TGL_ERROR;
+    }
+    const int nSegments = boxMin.cols();
+    if (nSegments == 0) {
+        return TGL_OK;
+    }
+
+    segmentOrder.resize(nSegments);
+    for (int s = 0; s < nSegments; ++s) {
+        segmentOrder[s] = s;
+    }
+    // A binary tree whose leaves hold at least one segment has less than 2n nodes.
+    nodes.reserve(2 * nSegments);
+    nodeMin.resize(boxMin.rows(), 2 * nSegments);
+    nodeMax.resize(boxMin.rows(), 2 * nSegments);
+    buildNode(boxMin, boxMax, 0, nSegments);
+    nodeMin.conservativeResize(Eigen::NoChange, nodes.size());
+    nodeMax.conservativeResize(Eigen::NoChange, nodes.size());
+    return TGL_OK;
+}
+
+void SegmentBvh::clear()
+{
+    nodes.clear();
+    segmentOrder.clear();
+    nodeMin.resize(0, 0);
+    nodeMax.resize(0, 0);
+}
+
+bool SegmentBvh::empty() const
+{
+    return nodes.empty();
+}
+
+std::size_t SegmentBvh::getMemoryUsage() const
+{
+    return sizeof(Node) * nodes.capacity() + sizeof(int) * segmentOrder.capacity() + sizeof(double) * (nodeMin.size() + nodeMax.size());
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+int SegmentBvh::buildNode(const Eigen::MatrixXd& boxMin, const Eigen::MatrixXd& boxMax, const int first, const int count)
+{
+    const int n = nodes.size();
+    Node node = {-1, -1, first, count, segmentOrder[first], segmentOrder[first]};
+    nodeMin.col(n) = boxMin.col(segmentOrder[first]);
+    nodeMax.col(n) = boxMax.col(segmentOrder[first]);
+    for (int i = first + 1; i < first + count; ++i) {
+        const int s = segmentOrder[i];
+        nodeMin.col(n) = nodeMin.col(n).cwiseMin(boxMin.col(s));
+        nodeMax.col(n) = nodeMax.col(n).cwiseMax(boxMax.col(s));
+        node.minSegment = std::min(node.minSegment, s);
+        node.maxSegment = std::max(node.maxSegment, s);
+    }
+    nodes.push_back(node);
+    if (count <= TGL_BVH_LEAF_SIZE) {
+        return n;
+    }
+
+    // Median split of the box centers along the widest axis.
+    int axis;
+    (nodeMax.col(n) - nodeMin.col(n)).maxCoeff(&axis);
+    const int half = count / 2;
+    std::nth_element(segmentOrder.begin() + first, segmentOrder.begin() + first + half, segmentOrder.begin() + first + count,
+                     [&](int a, int b){ return boxMin(axis, a) + boxMax(axis, a) < boxMin(axis, b) + boxMax(axis, b); });
+    const int left = buildNode(boxMin, boxMax, first, half);
+    const int right = buildNode(boxMin, boxMax, first + half, count - half);
+    nodes[n].left = left;
+    nodes[n].right = right;
+    return n;
+}
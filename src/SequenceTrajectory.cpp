@@ -0,0 +1,210 @@
+/*! \file       SequenceTrajectory.cpp
+ *  \brief      A trajectory which plays child trajectories one after the other, building them lazily.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/SequenceTrajectory.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+SequenceTrajectory::SequenceTrajectory():
+stepBounds(1, 0.0),
+startTime(0.0),
+builtSteps(0),
+segmentCursor(0)
+{
+}
+
+SequenceTrajectory::~SequenceTrajectory()
+{
+}
+
+TglMessage SequenceTrajectory::append(TrajectoryPtr child, const double duration, const double childStartTime)
+{
+    Step newStep = {STEP_FORWARD, child, TrajectoryFactory(), childStartTime, duration};
+    return appendStep(newStep);
+}
+
+TglMessage SequenceTrajectory::append(TrajectoryFactory childFactory, const double duration, const double childStartTime)
+{
+    Step newStep = {STEP_FORWARD, TrajectoryPtr(), childFactory, childStartTime, duration};
+    return appendStep(newStep);
+}
+
+TglMessage SequenceTrajectory::appendReversed(TrajectoryPtr child, const double duration, const double childStartTime)
+{
+    Step newStep = {STEP_REVERSED, child, TrajectoryFactory(), childStartTime, duration};
+    return appendStep(newStep);
+}
+
+TglMessage SequenceTrajectory::appendReversed(TrajectoryFactory childFactory, const double duration, const double childStartTime)
+{
+    Step newStep = {STEP_REVERSED, TrajectoryPtr(), childFactory, childStartTime, duration};
+    return appendStep(newStep);
+}
+
+TglMessage SequenceTrajectory::appendHold(const double duration)
+{
+    if (steps.empty()) {
+        LOG(ERROR) << "A hold needs a previous step to hold.";
+        return TGL_ERROR;
+    }
+    Step newStep = {STEP_HOLD, TrajectoryPtr(), TrajectoryFactory(), 0.0, duration};
+    return appendStep(newStep);
+}
+
+void SequenceTrajectory::clear()
+{
+    steps.clear();
+    stepBounds.assign(1, 0.0);
+    builtSteps = 0;
+    segmentCursor = 0;
+    resetInternalClock();
+}
+
+void SequenceTrajectory::setStartTime(const double newStartTime)
+{
+    startTime = newStartTime;
+}
+
+double SequenceTrajectory::getStartTime() const
+{
+    return startTime;
+}
+
+double SequenceTrajectory::getDuration() const
+{
+    return stepBounds.back();
+}
+
+int SequenceTrajectory::getNumberOfSteps() const
+{
+    return steps.size();
+}
+
+int SequenceTrajectory::getNumberOfBuiltSteps() const
+{
+    return builtSteps;
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+TglMessage SequenceTrajectory::getImplementationDesired(Eigen::VectorXd& desiredPos,
+                                                        Eigen::VectorXd& desiredVel,
+                                                        Eigen::VectorXd& desiredAcc,
+                                                        const double time_step)
+{
+    if (steps.empty()) {
+        TGL_REPORT_ERROR("The sequence has no steps. Append some first.");
+        return TGL_ERROR;
+    }
+
+    TglMessage status = TGL_RUNNING;
+    double sequenceTime = time_step - startTime;
+    if (sequenceTime < 0.0) {
+        sequenceTime = 0.0;
+        status = TGL_START;
+    } else if (sequenceTime >= stepBounds.back()) {
+        sequenceTime = stepBounds.back();
+        status = TGL_FINISHED;
+    }
+
+    const int s = findSegment(stepBounds, sequenceTime, segmentCursor);
+    if (!evaluateStep(s, sequenceTime - stepBounds[s], desiredPos, desiredVel, desiredAcc)) {
+        return TGL_ERROR;
+    }
+    return status;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+TglMessage SequenceTrajectory::appendStep(const Step& newStep)
+{
+    if (newStep.duration <= 0.0) {
+        LOG(ERROR) << "A step duration must be positive, got " << newStep.duration << ".";
+        return TGL_ERROR;
+    }
+    if (newStep.mode != STEP_HOLD && !newStep.child && !newStep.factory) {
+        LOG(ERROR) << "The child trajectory (or its factory) is null.";
+        return TGL_ERROR;
+    }
+    steps.push_back(newStep);
+    stepBounds.push_back(stepBounds.back() + newStep.duration);
+    if (newStep.child) {
+        ++builtSteps;
+    }
+    return TGL_OK;
+}
+
+TglMessage SequenceTrajectory::evaluateStep(const int stepIndex, const double localTime, Eigen::VectorXd& desiredPos, Eigen::VectorXd& desiredVel, Eigen::VectorXd& desiredAcc)
+{
+    // A hold evaluates the end of the last step which is not a hold.
+    if (steps[stepIndex].mode == STEP_HOLD) {
+        int heldIndex = stepIndex - 1;
+        while (steps[heldIndex].mode == STEP_HOLD) {
+            --heldIndex;
+        }
+        if (!evaluateStep(heldIndex, steps[heldIndex].duration, desiredPos, desiredVel, desiredAcc)) {
+            return TGL_ERROR;
+        }
+        desiredVel.setZero();
+        desiredAcc.setZero();
+        return TGL_OK;
+    }
+
+    Step& step = steps[stepIndex];
+    if (!step.child) {
+        step.child = step.factory();
+        if (!step.child) {
+            TGL_REPORT_ERROR("The factory of step %.0f did not build a trajectory.", stepIndex);
+            return TGL_ERROR;
+        }
+        step.factory = TrajectoryFactory();
+        ++builtSteps;
+    }
+
+    if (step.mode == STEP_REVERSED) {
+        if (!step.child->getDesired(desiredPos, desiredVel, desiredAcc, step.childStartTime + step.duration - localTime)) {
+            return TGL_ERROR;
+        }
+        desiredVel = -desiredVel;
+    } else if (!step.child->getDesired(desiredPos, desiredVel, desiredAcc, step.childStartTime + localTime)) {
+        return TGL_ERROR;
+    }
+    return TGL_OK;
+}
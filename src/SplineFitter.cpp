@@ -0,0 +1,393 @@
+/*! \file       SplineFitter.cpp
+ *  \brief      Streaming least-squares fitting of cubic splines to dense samples.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/SplineFitter.hpp"
+
+// STL includes
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+
+using namespace tgl;
+
+/*! The uniform cubic B-spline basis functions which are non-zero on a segment, at the local coordinate x in [0, 1].
+ */
+static inline void cubicBasis(const double x, double b[4])
+{
+    const double x2 = x * x;
+    const double x3 = x2 * x;
+    const double y = 1.0 - x;
+    b[0] = y * y * y / 6.0;
+    b[1] = (3.0 * x3 - 6.0 * x2 + 4.0) / 6.0;
+    b[2] = (-3.0 * x3 + 3.0 * x2 + 3.0 * x + 1.0) / 6.0;
+    b[3] = x3 / 6.0;
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+SplineFitter::SplineFitter():
+startTime(0.0),
+endTime(0.0),
+nSegments(0),
+smoothing(0.0),
+nSamples(0)
+{
+}
+
+SplineFitter::SplineFitter(const double newStartTime, const double newEndTime, const int newNumberOfSegments, const int newDimension, const double newSmoothing):
+startTime(0.0),
+endTime(0.0),
+nSegments(0),
+smoothing(0.0),
+nSamples(0)
+{
+    if(!reset(newStartTime, newEndTime, newNumberOfSegments, newDimension, newSmoothing))
+        LOG(ERROR) << "Could not set the spline you passed to the fitter.";
+}
+
+SplineFitter::~SplineFitter()
+{
+}
+
+TglMessage SplineFitter::reset(const double newStartTime, const double newEndTime, const int newNumberOfSegments, const int newDimension, const double newSmoothing)
+{
+    nSegments = 0;
+    nSamples = 0;
+    band.resize(4, 0);
+    rhs.resize(0, 0);
+
+    if (!std::isfinite(newStartTime) || !std::isfinite(newEndTime) || newEndTime <= newStartTime) {
+        LOG(ERROR) << "The spline times must be finite and increasing, got [" << newStartTime << ", " << newEndTime << "].";
+        return TGL_ERROR;
+    }
+    if (newNumberOfSegments < 1 || newDimension < 1) {
+        LOG(ERROR) << "The spline needs at least 1 segment and 1 DoF, got " << newNumberOfSegments << " and " << newDimension << ".";
+        return TGL_ERROR;
+    }
+    if (!(newSmoothing >= 0.0) || std::isinf(newSmoothing)) {
+        LOG(ERROR) << "The smoothing weight must be finite and non-negative, got " << newSmoothing << ".";
+        return TGL_ERROR;
+    }
+
+    startTime = newStartTime;
+    endTime = newEndTime;
+    nSegments = newNumberOfSegments;
+    smoothing = newSmoothing;
+    band = Eigen::MatrixXd::Zero(4, nSegments + 3);
+    rhs = Eigen::MatrixXd::Zero(newDimension, nSegments + 3);
+    return TGL_OK;
+}
+
+TglMessage SplineFitter::addSample(const double time, const Eigen::Ref<const Eigen::VectorXd>& position)
+{
+    if (nSegments == 0) {
+        LOG(ERROR) << "The fitter has not been reset.";
+        return TGL_ERROR;
+    }
+    if (position.size() != rhs.rows()) {
+        LOG(ERROR) << "The sample dimension (" << position.size() << ") does not match the fitter dimension (" << rhs.rows() << ").";
+        return TGL_ERROR;
+    }
+    Eigen::Map<const Eigen::VectorXd> times(&time, 1);
+    if (accumulate(times, position, 0, 1, band, rhs, 0) != 0) {
+        LOG(ERROR) << "The sample at time " << time << " is outside of [" << startTime << ", " << endTime << "] or not finite.";
+        return TGL_ERROR;
+    }
+    ++nSamples;
+    return TGL_OK;
+}
+
+TglMessage SplineFitter::addSamples(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& positions)
+{
+    if (nSegments == 0) {
+        LOG(ERROR) << "The fitter has not been reset.";
+        return TGL_ERROR;
+    }
+    if (positions.rows() != rhs.rows() || positions.cols() != times.size()) {
+        LOG(ERROR) << "The samples are " << positions.rows() << "x" << positions.cols() << " for " << times.size() << " times, expected " << rhs.rows() << " rows and one column per time.";
+        return TGL_ERROR;
+    }
+
+    const int n = times.size();
+    int skipped = 0;
+    if (n < 2 * TGL_FIT_CHUNK_SIZE) {
+        skipped = accumulate(times, positions, 0, n, band, rhs, 0);
+    }
+    else {
+        // Each chunk accumulates into the slice of basis functions its samples touch, which is small when the samples are sorted, then adds it in under the lock.
+        const double segmentsPerTime = nSegments / (endTime - startTime);
+        std::mutex accumulateMutex;
+        TglTools::parallelFor(n, [&](int begin, int end) {
+            int firstSegment = nSegments - 1;
+            int lastSegment = 0;
+            for (int s = begin; s < end; ++s) {
+                const double u = (times(s) - startTime) * segmentsPerTime;
+                if (u >= 0.0 && u <= nSegments) {
+                    const int segment = std::min((int)u, nSegments - 1);
+                    firstSegment = std::min(firstSegment, segment);
+                    lastSegment = std::max(lastSegment, segment);
+                }
+            }
+            if (lastSegment < firstSegment) {
+                std::lock_guard<std::mutex> lock(accumulateMutex);
+                skipped += end - begin;
+                return;
+            }
+            Eigen::MatrixXd chunkBand = Eigen::MatrixXd::Zero(4, lastSegment - firstSegment + 4);
+            Eigen::MatrixXd chunkRhs = Eigen::MatrixXd::Zero(rhs.rows(), lastSegment - firstSegment + 4);
+            const int chunkSkipped = accumulate(times, positions, begin, end, chunkBand, chunkRhs, firstSegment);
+            std::lock_guard<std::mutex> lock(accumulateMutex);
+            band.middleCols(firstSegment, chunkBand.cols()) += chunkBand;
+            rhs.middleCols(firstSegment, chunkRhs.cols()) += chunkRhs;
+            skipped += chunkSkipped;
+        }, TGL_FIT_CHUNK_SIZE);
+    }
+
+    nSamples += n - skipped;
+    if (skipped > 0) {
+        LOG(WARNING) << skipped << " of " << n << " samples are outside of [" << startTime << ", " << endTime << "] or not finite and were skipped.";
+        return TGL_WARNING;
+    }
+    return TGL_OK;
+}
+
+TglMessage SplineFitter::addSamples(const WaypointSet& wptSet)
+{
+    ConstVectorMap times = wptSet.getWaypointTimesView();
+    ConstMatrixMap positions = wptSet.asMatrixView();
+    TglMessage result = TGL_OK;
+    for (int begin = 0; begin < times.size(); begin += TGL_FIT_CHUNK_SIZE) {
+        const int size = std::min<int>(TGL_FIT_CHUNK_SIZE, times.size() - begin);
+        const TglMessage chunkResult = addSamples(times.segment(begin, size), positions.middleCols(begin, size));
+        if (chunkResult == TGL_ERROR) {
+            return TGL_ERROR;
+        }
+        if (chunkResult == TGL_WARNING) {
+            result = TGL_WARNING;
+        }
+    }
+    return result;
+}
+
+TglMessage SplineFitter::addSamples(std::istream& stream)
+{
+    if (nSegments == 0) {
+        LOG(ERROR) << "The fitter has not been reset.";
+        return TGL_ERROR;
+    }
+
+    const int nDof = rhs.rows();
+    Eigen::VectorXd times(TGL_FIT_CHUNK_SIZE);
+    Eigen::MatrixXd positions(nDof, TGL_FIT_CHUNK_SIZE);
+    TglMessage result = TGL_OK;
+    int size = 0;
+    long long lineNumber = 0;
+    std::string line;
+
+    auto flush = [&]() {
+        if (size > 0 && addSamples(times.head(size), positions.leftCols(size)) == TGL_WARNING) {
+            result = TGL_WARNING;
+        }
+        size = 0;
+    };
+
+    while (std::getline(stream, line)) {
+        ++lineNumber;
+        const char* cursor = line.c_str();
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r') {
+            ++cursor;
+        }
+        if (*cursor == '\0' || *cursor == '#') {
+            continue;
+        }
+
+        char* next;
+        bool parsed = true;
+        times(size) = std::strtod(cursor, &next);
+        parsed &= next != cursor;
+        for (int i = 0; i < nDof && parsed; ++i) {
+            cursor = next;
+            positions(i, size) = std::strtod(cursor, &next);
+            parsed &= next != cursor;
+        }
+        if (!parsed) {
+            flush();
+            LOG(ERROR) << "Line " << lineNumber << " does not hold a time and " << nDof << " coordinates.";
+            return TGL_ERROR;
+        }
+        if (++size == TGL_FIT_CHUNK_SIZE) {
+            flush();
+        }
+    }
+    flush();
+    return result;
+}
+
+TglMessage SplineFitter::solve(std::shared_ptr<const PiecewisePolynomial>& fittedCore) const
+{
+    if (nSegments == 0) {
+        LOG(ERROR) << "The fitter has not been reset.";
+        return TGL_ERROR;
+    }
+
+    const int nBasis = nSegments + 3;
+    const int nDof = rhs.rows();
+    const double h = (endTime - startTime) / nSegments;
+    Eigen::MatrixXd system = band;
+
+    if (smoothing > 0.0) {
+        // Gram matrix of the basis second derivatives on one segment, exact with a 2 point Gauss rule since they are linear.
+        Eigen::Matrix4d penalty = Eigen::Matrix4d::Zero();
+        const double gaussPoints[2] = {0.5 - 0.5 / std::sqrt(3.0), 0.5 + 0.5 / std::sqrt(3.0)};
+        for (int g = 0; g < 2; ++g) {
+            const double x = gaussPoints[g];
+            const Eigen::Vector4d secondDerivatives(1.0 - x, 3.0 * x - 2.0, 1.0 - 3.0 * x, x);
+            penalty += 0.5 * secondDerivatives * secondDerivatives.transpose();
+        }
+        penalty *= smoothing / (h * h * h);
+        for (int j = 0; j < nSegments; ++j) {
+            for (int a = 0; a < 4; ++a) {
+                for (int b = a; b < 4; ++b) {
+                    system(b - a, j + a) += penalty(a, b);
+                }
+            }
+        }
+    }
+
+    // Banded LDLT, the unit lower factor is stored over the upper band: system(k, i) becomes L(i + k, i).
+    Eigen::VectorXd pivots(nBasis);
+    const double pivotTolerance = 1e-12 * system.row(0).maxCoeff();
+    for (int j = 0; j < nBasis; ++j) {
+        double pivot = system(0, j);
+        for (int k = 1; k <= std::min(3, j); ++k) {
+            pivot -= system(k, j - k) * system(k, j - k) * pivots(j - k);
+        }
+        if (!(pivot > pivotTolerance)) {
+            LOG(ERROR) << "The fitting system is singular at basis function " << j << ", add samples around time " << startTime + std::max(0, j - 2) * h << " or some smoothing.";
+            return TGL_ERROR;
+        }
+        pivots(j) = pivot;
+        for (int i = j + 1; i <= std::min(j + 3, nBasis - 1); ++i) {
+            double value = system(i - j, j);
+            for (int m = std::max(0, i - 3); m < j; ++m) {
+                value -= system(i - m, m) * system(j - m, m) * pivots(m);
+            }
+            system(i - j, j) = value / pivot;
+        }
+    }
+
+    Eigen::MatrixXd controlPoints = rhs;
+    for (int i = 0; i < nBasis; ++i) {
+        for (int k = 1; k <= std::min(3, i); ++k) {
+            controlPoints.col(i) -= system(k, i - k) * controlPoints.col(i - k);
+        }
+    }
+    for (int i = 0; i < nBasis; ++i) {
+        controlPoints.col(i) /= pivots(i);
+    }
+    for (int i = nBasis - 1; i >= 0; --i) {
+        for (int k = 1; k <= std::min(3, nBasis - 1 - i); ++k) {
+            controlPoints.col(i) -= system(k, i) * controlPoints.col(i + k);
+        }
+    }
+
+    // Power basis of each segment in x = delta / h, then scaled to the local time delta.
+    StdDoubleVector knotTimes(nSegments + 1);
+    Eigen::MatrixXd coefficients(nDof, 4 * nSegments);
+    for (int j = 0; j < nSegments; ++j) {
+        knotTimes[j] = startTime + j * h;
+        const auto c0 = controlPoints.col(j);
+        const auto c1 = controlPoints.col(j + 1);
+        const auto c2 = controlPoints.col(j + 2);
+        const auto c3 = controlPoints.col(j + 3);
+        coefficients.col(4*j)   = (c0 + 4.0 * c1 + c2) / 6.0;
+        coefficients.col(4*j+1) = (c2 - c0) / (2.0 * h);
+        coefficients.col(4*j+2) = (c0 - 2.0 * c1 + c2) / (2.0 * h * h);
+        coefficients.col(4*j+3) = (-c0 + 3.0 * c1 - 3.0 * c2 + c3) / (6.0 * h * h * h);
+    }
+    knotTimes[nSegments] = endTime;
+
+    fittedCore = std::make_shared<PiecewisePolynomial>(std::move(knotTimes), std::move(coefficients), 4);
+    return TGL_OK;
+}
+
+TglMessage SplineFitter::solve(CubicSplineTrajectory& trajectory) const
+{
+    std::shared_ptr<const PiecewisePolynomial> fittedCore;
+    if (!solve(fittedCore)) {
+        return TGL_ERROR;
+    }
+    return trajectory.setCore(fittedCore);
+}
+
+long long SplineFitter::getNumberOfSamples() const
+{
+    return nSamples;
+}
+
+int SplineFitter::getDimension() const
+{
+    return rhs.rows();
+}
+
+std::size_t SplineFitter::getMemoryUsage() const
+{
+    return sizeof(SplineFitter) + sizeof(double) * (band.size() + rhs.size());
+}
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+int SplineFitter::accumulate(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& positions, const int begin, const int end, Eigen::MatrixXd& sliceBand, Eigen::MatrixXd& sliceRhs, const int firstBasis) const
+{
+    const double segmentsPerTime = nSegments / (endTime - startTime);
+    int skipped = 0;
+    double basis[4];
+    for (int s = begin; s < end; ++s) {
+        const double u = (times(s) - startTime) * segmentsPerTime;
+        if (!(u >= 0.0 && u <= nSegments) || !positions.col(s).allFinite()) {
+            ++skipped;
+            continue;
+        }
+        const int segment = std::min((int)u, nSegments - 1);
+        cubicBasis(u - segment, basis);
+        const int column = segment - firstBasis;
+        for (int a = 0; a < 4; ++a) {
+            for (int b = a; b < 4; ++b) {
+                sliceBand(b - a, column + a) += basis[a] * basis[b];
+            }
+            sliceRhs.col(column + a) += basis[a] * positions.col(s);
+        }
+    }
+    return skipped;
+}
@@ -0,0 +1,315 @@
+/*! \file       TglDiagnostics.cpp
+ *  \brief      Non-blocking, rate-limited error reporting for real-time threads.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+static_assert((TGL_DIAGNOSTICS_CAPACITY & (TGL_DIAGNOSTICS_CAPACITY - 1)) == 0, "TGL_DIAGNOSTICS_CAPACITY must be a power of 2.");
+
+/*! A diagnostic waiting in the ring to be logged.
+ */
+struct DiagnosticRecord {
+    const DiagnosticSite* site;                         /*!< The reporting site. */
+    const char* format;                                 /*!< The format string of the message. */
+    double values[TGL_DIAGNOSTICS_MAX_VALUES];          /*!< The values read by the format. */
+    uint64_t suppressed;                                /*!< The number of records of the site suppressed before this one. */
+};
+
+/*! A slot of the ring. Its sequence number tells producers and consumers whose turn it is (bounded MPMC queue of D. Vyukov).
+ */
+struct DiagnosticCell {
+    std::atomic<std::size_t> sequence;                  /*!< Equal to the enqueue position when free, to the position + 1 when it holds a record. */
+    DiagnosticRecord record;                            /*!< The record. */
+};
+
+/*! The ring, the counters and the drain thread. A single instance, made on first use.
+ */
+struct DiagnosticState {
+    DiagnosticState():
+    enqueuePosition(0),
+    dequeuePosition(0),
+    reported(0),
+    logged(0),
+    suppressed(0),
+    dropped(0),
+    running(false),
+    stopping(false)
+    {
+        for (std::size_t i = 0; i < TGL_DIAGNOSTICS_CAPACITY; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~DiagnosticState();
+
+    DiagnosticCell cells[TGL_DIAGNOSTICS_CAPACITY];     /*!< The ring. */
+    std::atomic<std::size_t> enqueuePosition;           /*!< The next position to write. */
+    std::atomic<std::size_t> dequeuePosition;           /*!< The next position to read. */
+    std::atomic<uint64_t> reported;                     /*!< The number of records reported. */
+    std::atomic<uint64_t> logged;                       /*!< The number of records logged. */
+    std::atomic<uint64_t> suppressed;                   /*!< The number of records suppressed by the rate limits. */
+    std::atomic<uint64_t> dropped;                      /*!< The number of records dropped on a full ring. */
+    std::atomic<bool> running;                          /*!< Whether the drain thread runs. */
+    bool stopping;                                      /*!< Asks the drain thread to stop, guarded by the mutex. */
+    std::mutex mutex;                                   /*!< Guards starting and stopping the drain thread. */
+    std::condition_variable wakeUp;                     /*!< Wakes the drain thread up to stop. */
+    std::thread drainThread;                            /*!< The drain thread. */
+};
+
+/*! Stops the drain thread after a last drain, if it runs.
+ */
+static void stopDrainThread(DiagnosticState& state)
+{
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.running.load(std::memory_order_relaxed) || state.stopping) {
+            return;
+        }
+        state.stopping = true;
+    }
+    state.wakeUp.notify_all();
+    state.drainThread.join();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.running.store(false, std::memory_order_release);
+}
+
+DiagnosticState::~DiagnosticState()
+{
+    stopDrainThread(*this);
+}
+
+/*! Get the diagnostics state.
+ */
+static DiagnosticState& getState()
+{
+    static DiagnosticState state;
+    return state;
+}
+
+/*! Get the steady clock time.
+ *  \return The time in nanoseconds.
+ */
+static int64_t getNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*! Pushes a record into the ring.
+ *  \return false if the ring is full.
+ */
+static bool enqueue(DiagnosticState& state, const DiagnosticRecord& record)
+{
+    std::size_t position = state.enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        DiagnosticCell& cell = state.cells[position & (TGL_DIAGNOSTICS_CAPACITY - 1)];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            if (state.enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.record = record;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = state.enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/*! Pops a record from the ring.
+ *  \return false if the ring is empty.
+ */
+static bool dequeue(DiagnosticState& state, DiagnosticRecord& record)
+{
+    std::size_t position = state.dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        DiagnosticCell& cell = state.cells[position & (TGL_DIAGNOSTICS_CAPACITY - 1)];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+        if (difference == 0) {
+            if (state.dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                record = cell.record;
+                cell.sequence.store(position + TGL_DIAGNOSTICS_CAPACITY, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = state.dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/*! Formats the pending records and logs them to glog.
+ *  \return The number of records logged.
+ */
+static int drain(DiagnosticState& state)
+{
+    int nLogged = 0;
+    DiagnosticRecord record;
+    char message[512];
+    while (dequeue(state, record)) {
+        // The values which the format does not read are ignored by snprintf.
+        static_assert(TGL_DIAGNOSTICS_MAX_VALUES == 4, "drain() passes 4 values to snprintf.");
+        std::snprintf(message, sizeof(message), record.format, record.values[0], record.values[1], record.values[2], record.values[3]);
+        const char* slash = std::strrchr(record.site->file, '/');
+        const char* file = slash ? slash + 1 : record.site->file;
+        if (record.site->severity == TGL_DIAGNOSTIC_ERROR) {
+            LOG(ERROR) << file << ":" << record.site->line << "] " << message;
+        } else {
+            LOG(WARNING) << file << ":" << record.site->line << "] " << message;
+        }
+        if (record.suppressed > 0) {
+            LOG(WARNING) << file << ":" << record.site->line << "] " << record.suppressed << " similar messages suppressed.";
+        }
+        ++nLogged;
+    }
+    state.logged.fetch_add(nLogged, std::memory_order_relaxed);
+    return nLogged;
+}
+
+/*! The loop of the drain thread.
+ */
+static void drainLoop(DiagnosticState& state)
+{
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.stopping) {
+        lock.unlock();
+        drain(state);
+        lock.lock();
+        state.wakeUp.wait_for(lock, std::chrono::milliseconds(TGL_DIAGNOSTICS_DRAIN_PERIOD), [&state]() { return state.stopping; });
+    }
+    lock.unlock();
+    drain(state);
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+DiagnosticSite::DiagnosticSite(const char* newFile, const int newLine, const TglDiagnosticSeverity newSeverity):
+file(newFile),
+line(newLine),
+severity(newSeverity),
+windowStart(getNanoseconds()),
+windowCount(0),
+suppressed(0)
+{
+}
+
+void TglDiagnostics::start()
+{
+    DiagnosticState& state = getState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.running.load(std::memory_order_relaxed)) {
+        return;
+    }
+    state.stopping = false;
+    state.drainThread = std::thread(drainLoop, std::ref(state));
+    state.running.store(true, std::memory_order_release);
+}
+
+void TglDiagnostics::stop()
+{
+    stopDrainThread(getState());
+}
+
+int TglDiagnostics::flush()
+{
+    return drain(getState());
+}
+
+TglDiagnostics::Statistics TglDiagnostics::getStatistics()
+{
+    const DiagnosticState& state = getState();
+    Statistics statistics;
+    statistics.reported = state.reported.load(std::memory_order_relaxed);
+    statistics.logged = state.logged.load(std::memory_order_relaxed);
+    statistics.suppressed = state.suppressed.load(std::memory_order_relaxed);
+    statistics.dropped = state.dropped.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void TglDiagnostics::submit(DiagnosticSite& site, const char* format, const double* values, const int nValues)
+{
+    DiagnosticState& state = getState();
+    state.reported.fetch_add(1, std::memory_order_relaxed);
+
+    // Rate limit: the first report after the window elapsed opens a new one, the others count against it.
+    const int64_t now = getNanoseconds();
+    int64_t windowStart = site.windowStart.load(std::memory_order_relaxed);
+    bool keep;
+    if (now - windowStart >= static_cast<int64_t>(TGL_DIAGNOSTICS_WINDOW * 1e9) && site.windowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        site.windowCount.store(1, std::memory_order_relaxed);
+        keep = true;
+    } else {
+        keep = site.windowCount.fetch_add(1, std::memory_order_relaxed) < TGL_DIAGNOSTICS_RATE;
+    }
+    if (!keep) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        state.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    DiagnosticRecord record;
+    record.site = &site;
+    record.format = format;
+    for (int i = 0; i < TGL_DIAGNOSTICS_MAX_VALUES; ++i) {
+        record.values[i] = i < nValues ? values[i] : 0.0;
+    }
+    record.suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    if (!enqueue(state, record)) {
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        site.suppressed.fetch_add(record.suppressed, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!state.running.load(std::memory_order_acquire)) {
+        start();
+    }
+}
@@ -28,9 +28,91 @@
 
 #include "tgl/TglTools.hpp"
 
+// STL includes
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Glog includes
+#include <glog/logging.h>
+
 using namespace tgl;
 
 Eigen::Displacementd TglTools::eigenVectorXdToDisplacementd(const Eigen::VectorXd& inputVector)
 {
-    return Eigen::Displacementd(0,0,0,0,0,0,0);
+    if (inputVector.size() != 7) {
+        LOG(ERROR) << "A Displacementd vector must be of dimension 7, got " << inputVector.size() << ". Returning Identity.";
+        return Eigen::Displacementd(0,0,0,1,0,0,0);
+    }
+    return Eigen::Displacementd(inputVector(0), inputVector(1), inputVector(2), inputVector(3), inputVector(4), inputVector(5), inputVector(6));
+}
+
+Eigen::Twistd TglTools::eigenVectorXdToTwistd(const Eigen::VectorXd& inputVector)
+{
+    if (inputVector.size() != 6) {
+        LOG(ERROR) << "A Twistd vector must be of dimension 6, got " << inputVector.size() << ". Returning Zero.";
+        return Eigen::Twistd(0,0,0,0,0,0);
+    }
+    // Lgsm twists store the angular part first.
+    return Eigen::Twistd(inputVector(3), inputVector(4), inputVector(5), inputVector(0), inputVector(1), inputVector(2));
+}
+
+Eigen::Rotation3d TglTools::eigenVectorXdToRotation3d(const Eigen::VectorXd& inputVector)
+{
+    if (inputVector.size() != 4) {
+        LOG(ERROR) << "A Rotation3d vector must be of dimension 4, got " << inputVector.size() << ". Returning Identity.";
+        return Eigen::Rotation3d::Identity();
+    }
+    return Eigen::Rotation3d(inputVector(0), inputVector(1), inputVector(2), inputVector(3));
+}
+
+Eigen::VectorXd TglTools::eigenDisplacementdToVectorXd(const Eigen::Displacementd& inputDisplacementd)
+{
+    Eigen::VectorXd outputVector(7);
+    Eigen::Vector3d translation = inputDisplacementd.getTranslation();
+    Eigen::Rotation3d rotation = inputDisplacementd.getRotation();
+    outputVector << translation, rotation.w(), rotation.x(), rotation.y(), rotation.z();
+    return outputVector;
+}
+
+Eigen::VectorXd TglTools::eigenTwistdToVectorXd(const Eigen::Twistd& inputTwistd)
+{
+    Eigen::VectorXd outputVector(6);
+    outputVector << inputTwistd(3), inputTwistd(4), inputTwistd(5), inputTwistd(0), inputTwistd(1), inputTwistd(2);
+    return outputVector;
+}
+
+Eigen::VectorXd TglTools::eigenRotation3dToVectorXd(const Eigen::Rotation3d& inputRotation3d)
+{
+    Eigen::VectorXd outputVector(4);
+    outputVector << inputRotation3d.w(), inputRotation3d.x(), inputRotation3d.y(), inputRotation3d.z();
+    return outputVector;
+}
+
+void TglTools::parallelFor(const int n, const std::function<void(int, int)>& body, const int minChunkSize)
+{
+    if (n <= 0) {
+        return;
+    }
+    const int nThreads = std::max(1, std::min<int>(std::thread::hardware_concurrency(), n / std::max(minChunkSize, 1)));
+    const int chunkSize = (n + nThreads - 1) / nThreads;
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads - 1);
+    for (int begin = chunkSize; begin < n; begin += chunkSize) {
+        workers.push_back(std::thread(body, begin, std::min(begin + chunkSize, n)));
+    }
+    body(0, std::min(chunkSize, n));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+uint64_t TglTools::hashBytes(const void* data, const std::size_t size, uint64_t hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
 }
@@ -27,6 +27,10 @@
 */
 
 #include "tgl/Trajectory.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <algorithm>
 
 
 using namespace tgl;
@@ -53,14 +57,25 @@ TglMessage Trajectory::getDesired(  Eigen::VectorXd& desiredPos,
                                     const double time_step)
 {
     double tmp_time_step = time_step == TGL_USE_INTERNAL_CLOCK ? getInternalClockTime() : time_step;
-    TglMessage implementationMessage = getImplementationDesired(desiredPos, desiredVel, desiredAcc, tmp_time_step);
+    TglMessage implementationMessage = getDesiredAt(desiredPos, desiredVel, desiredAcc, tmp_time_step);
+    if (implementationMessage == TGL_FINISHED) {
+        resetInternalClock();
+    }
+    return implementationMessage;
+}
+
+TglMessage Trajectory::getDesiredAt(Eigen::VectorXd& desiredPos,
+                                    Eigen::VectorXd& desiredVel,
+                                    Eigen::VectorXd& desiredAcc,
+                                    const double time)
+{
+    const PerformanceCounters::Clock::time_point start = counters.startEvaluation();
+    TglMessage implementationMessage = getImplementationDesired(desiredPos, desiredVel, desiredAcc, time);
+    counters.countEvaluation(start);
     /*TODO:
      *  Implement Quaternion SLERP and derivation for angular velocity and acceleration.
      *  Concatenate results to desiredPos/Vel/Acc
      */
-    if (implementationMessage == TGL_FINISHED) {
-        resetInternalClock();
-    }
     return implementationMessage;
 }
 
@@ -72,11 +87,13 @@ TglMessage Trajectory::getDesired(  Eigen::VectorXd& desiredPos,
                                     const Eigen::VectorXd& currentAcc,
                                     const double time_step)
 {
+    const PerformanceCounters::Clock::time_point start = counters.startEvaluation();
     double tmp_time_step = time_step == TGL_USE_INTERNAL_CLOCK ? getInternalClockTime() : time_step;
     /* TODO:
      * Separate the rotation compenents from the linear components and pass those to the implementations.
      */
     TglMessage implementationMessage = getImplementationDesired(desiredPos, desiredVel, desiredAcc, currentPos, currentVel, currentAcc, tmp_time_step);
+    counters.countEvaluation(start);
     /*TODO:
      *  Implement Quaternion SLERP and derivation for angular velocity and acceleration.
      *  Concatenate results to desiredPos/Vel/Acc
@@ -87,13 +104,59 @@ TglMessage Trajectory::getDesired(  Eigen::VectorXd& desiredPos,
      return implementationMessage;
 }
 
+TglMessage Trajectory::getDesiredBatch( const Eigen::Ref<const Eigen::VectorXd>& times,
+                                        Eigen::MatrixXd& positions,
+                                        Eigen::MatrixXd& velocities,
+                                        Eigen::MatrixXd& accelerations)
+{
+    const PerformanceCounters::Clock::time_point start = PerformanceCounters::now();
+    TrajectoryCorePtr core = getCore();
+    if (core) {
+        const TglMessage result = core->evaluateBatch(times, positions, velocities, accelerations);
+        counters.countEvaluation(start, times.size());
+        return result;
+    }
+    if (times.hasNaN()) {
+        TGL_REPORT_ERROR("Cannot evaluate the trajectory at a NaN time.");
+        return TGL_ERROR;
+    }
+    const int n = times.size();
+    std::vector<int> sortedOrder(n);
+    for (int i = 0; i < n; ++i) {
+        sortedOrder[i] = i;
+    }
+    std::sort(sortedOrder.begin(), sortedOrder.end(), [&times](const int a, const int b) { return times(a) < times(b); });
+
+    Eigen::VectorXd pos, vel, acc;
+    for (int k = 0; k < n; ++k) {
+        const int i = sortedOrder[k];
+        if (getImplementationDesired(pos, vel, acc, times(i)) == TGL_ERROR) {
+            return TGL_ERROR;
+        }
+        if (k == 0) {
+            positions.resize(pos.size(), n);
+            velocities.resize(vel.size(), n);
+            accelerations.resize(acc.size(), n);
+        }
+        positions.col(i) = pos;
+        velocities.col(i) = vel;
+        accelerations.col(i) = acc;
+    }
+    if (n == 0) {
+        positions.resize(0, 0);
+        velocities.resize(0, 0);
+        accelerations.resize(0, 0);
+    }
+    counters.countEvaluation(start, n);
+    return TGL_OK;
+}
 
 TglMessage Trajectory::getImplementationDesired(Eigen::VectorXd& desiredPos,
                                                 Eigen::VectorXd& desiredVel,
                                                 Eigen::VectorXd& desiredAcc,
                                                 const double time_step)
 {
-    LOG(ERROR) << "The trajectory you are using has not implemented an open-loop generator!";
+    TGL_REPORT_ERROR("The trajectory you are using has not implemented an open-loop generator!");
     return TGL_ERROR;
 }
 
@@ -105,14 +168,44 @@ TglMessage Trajectory::getImplementationDesired(Eigen::VectorXd& desiredPos,
                                                 const Eigen::VectorXd& currentAcc,
                                                 const double time_step)
 {
-    LOG(ERROR) << "The trajectory you are using has not implemented a closed-loop generator!";
+    TGL_REPORT_ERROR("The trajectory you are using has not implemented a closed-loop generator!");
     return TGL_ERROR;
 }
 
 TglMessage Trajectory::setWaypoints(const WaypointSet& newWptSet)
 {
     wptSet = newWptSet;
-    resetInternalClock();
+    return resetInternalClock();
+}
+
+SampleRange Trajectory::samples(const double timeStep, const double startTime, const double endTime)
+{
+    return SampleRange(*this, timeStep, startTime, endTime);
+}
+
+std::size_t Trajectory::getMemoryUsage() const
+{
+    return sizeof(Trajectory) + sizeof(double) * (wptSet.getWaypointTimesView().size() + wptSet.asMatrixView().size() + wptSet.rotationsAsMatrixView().size());
+}
+
+TrajectoryCorePtr Trajectory::getCore() const
+{
+    return TrajectoryCorePtr();
+}
+
+const WaypointSet& Trajectory::getWaypointSet() const
+{
+    return wptSet;
+}
+
+PerformanceCounters::Snapshot Trajectory::getPerformanceSnapshot() const
+{
+    return counters.getSnapshot();
+}
+
+void Trajectory::resetPerformanceCounters()
+{
+    counters.reset();
 }
 
 TglMessage Trajectory::getWaypoints(WaypointSet& newWptSet)
@@ -139,3 +232,21 @@ double Trajectory::getInternalClockTime()
 
     return std::chrono::duration<double>(std::chrono::system_clock::now() - internalClockStartTime).count();
 }
+
+int Trajectory::findSegment(const StdDoubleVector& knotTimes, const double time, int& segmentCursor) const
+{
+    const int previousSegment = segmentCursor;
+    const int segment = TrajectoryCore::findSegment(knotTimes, time, segmentCursor);
+    counters.countSegmentLookup(previousSegment, segment);
+    return segment;
+}
+
+void Trajectory::countSegmentLookup(const int previousSegment, const int segment) const
+{
+    counters.countSegmentLookup(previousSegment, segment);
+}
+
+void Trajectory::countRebuild(const PerformanceCounters::Clock::time_point& buildStart)
+{
+    counters.countRebuild(buildStart, getMemoryUsage());
+}
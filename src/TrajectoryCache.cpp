@@ -0,0 +1,224 @@
+/*! \file       TrajectoryCache.cpp
+ *  \brief      A thread-safe in-memory LRU cache of built trajectories.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/TrajectoryCache.hpp"
+
+// STL includes
+#include <cmath>
+
+
+using namespace tgl;
+
+/*! Hashes values rounded to a quantum. Non-finite values (infinite limits) are hashed as they are.
+ */
+static uint64_t hashQuantized(const double* data, const int size, const double quantum, uint64_t hash)
+{
+    for (int i = 0; i < size; ++i) {
+        if (std::isfinite(data[i])) {
+            const int64_t quantized = std::llround(data[i] / quantum);
+            hash = TglTools::hashBytes(&quantized, sizeof(quantized), hash);
+        } else {
+            hash = TglTools::hashBytes(&data[i], sizeof(double), hash);
+        }
+    }
+    return hash;
+}
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+TrajectoryCache::TrajectoryCache(const std::size_t newMaxBytes, const double newQuantum):
+maxBytes(newMaxBytes),
+quantum(newQuantum > 0.0 ? newQuantum : 1e-6),
+bytes(0),
+hits(0),
+misses(0),
+evictions(0)
+{
+    if (newQuantum <= 0.0)
+        LOG(WARNING) << "The key quantum must be positive, got " << newQuantum << ". Using " << quantum << ".";
+}
+
+TrajectoryCache::~TrajectoryCache()
+{
+}
+
+uint64_t TrajectoryCache::computeKey(const WaypointSet& wptSet, const std::string& generator, const Eigen::VectorXd& limits) const
+{
+    ConstVectorMap times = wptSet.getWaypointTimesView();
+    ConstMatrixMap coordinates = wptSet.asMatrixView();
+    ConstMatrixMap rotations = wptSet.rotationsAsMatrixView();
+    int64_t sizes[5] = {int64_t(wptSet.getWaypointType()), int64_t(times.size()), int64_t(coordinates.rows()), int64_t(rotations.cols()), int64_t(limits.size())};
+
+    uint64_t hash = TglTools::hashBytes(sizes, sizeof(sizes));
+    hash = TglTools::hashBytes(generator.data(), generator.size(), hash);
+    hash = hashQuantized(times.data(), times.size(), quantum, hash);
+    hash = hashQuantized(coordinates.data(), coordinates.size(), quantum, hash);
+    hash = hashQuantized(rotations.data(), rotations.size(), quantum, hash);
+    hash = hashQuantized(limits.data(), limits.size(), quantum, hash);
+    return hash;
+}
+
+TrajectoryCache::CachedTrajectory TrajectoryCache::getOrBuild(const uint64_t key, const TrajectoryBuilder& builder)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EntryIndex::iterator found = index.find(key);
+        if (found != index.end()) {
+            ++hits;
+            return makeResult(touch(found));
+        }
+        ++misses;
+    }
+
+    TrajectoryPtr built = builder();
+    if (!built) {
+        LOG(ERROR) << "The trajectory builder failed, nothing was cached.";
+        return CachedTrajectory();
+    }
+    Entry entry;
+    makeEntry(key, built, entry);
+    if (!entry.core) {
+        LOG(ERROR) << "The built trajectory has no core, nothing was cached.";
+        return CachedTrajectory();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EntryIndex::iterator found = index.find(key);
+    if (found != index.end()) {
+        return makeResult(touch(found));
+    }
+    if (entry.bytes <= maxBytes) {
+        entries.push_front(entry);
+        index[key] = entries.begin();
+        bytes += entry.bytes;
+        evict();
+    }
+    return makeResult(entry);
+}
+
+TrajectoryCache::CachedTrajectory TrajectoryCache::find(const uint64_t key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    EntryIndex::iterator found = index.find(key);
+    if (found == index.end()) {
+        ++misses;
+        return CachedTrajectory();
+    }
+    ++hits;
+    return makeResult(touch(found));
+}
+
+TglMessage TrajectoryCache::insert(const uint64_t key, TrajectoryPtr trajectory)
+{
+    if (!trajectory) {
+        LOG(ERROR) << "Can not cache a null trajectory.";
+        return TGL_ERROR;
+    }
+    Entry entry;
+    makeEntry(key, trajectory, entry);
+    if (!entry.core) {
+        LOG(ERROR) << "Can not cache a trajectory which has no core.";
+        return TGL_ERROR;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EntryIndex::iterator found = index.find(key);
+    if (found != index.end()) {
+        bytes -= found->second->bytes;
+        entries.erase(found->second);
+        index.erase(found);
+    }
+    if (entry.bytes > maxBytes) {
+        return TGL_WARNING;
+    }
+    entries.push_front(entry);
+    index[key] = entries.begin();
+    bytes += entry.bytes;
+    evict();
+    return TGL_OK;
+}
+
+void TrajectoryCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+TrajectoryCache::Statistics TrajectoryCache::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Statistics statistics;
+    statistics.hits = hits;
+    statistics.misses = misses;
+    statistics.evictions = evictions;
+    statistics.entries = entries.size();
+    statistics.bytes = bytes;
+    return statistics;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void TrajectoryCache::makeEntry(const uint64_t key, const TrajectoryPtr& trajectory, Entry& entry)
+{
+    entry.key = key;
+    entry.core = trajectory->getCore();
+    entry.waypoints = std::make_shared<const WaypointSet>(trajectory->getWaypointSet());
+    entry.bytes = trajectory->getMemoryUsage();
+}
+
+TrajectoryCache::CachedTrajectory TrajectoryCache::makeResult(const Entry& entry)
+{
+    CachedTrajectory result;
+    result.core = entry.core;
+    result.waypoints = entry.waypoints;
+    result.evaluator.setCore(entry.core);
+    return result;
+}
+
+const TrajectoryCache::Entry& TrajectoryCache::touch(EntryIndex::iterator found)
+{
+    entries.splice(entries.begin(), entries, found->second);
+    return *found->second;
+}
+
+void TrajectoryCache::evict()
+{
+    while (bytes > maxBytes && !entries.empty()) {
+        bytes -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+        ++evictions;
+    }
+}
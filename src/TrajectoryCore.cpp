@@ -0,0 +1,92 @@
+/*! \file       TrajectoryCore.cpp
+ *  \brief      The immutable, shareable part of a computed trajectory.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/TrajectoryCore.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <algorithm>
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+/****************************************************
+                   TrajectoryCore
+ ****************************************************/
+
+TrajectoryCore::~TrajectoryCore()
+{
+}
+
+TglMessage TrajectoryCore::evaluateBatch(const Eigen::Ref<const Eigen::VectorXd>& times, Eigen::MatrixXd& positions, Eigen::MatrixXd& velocities, Eigen::MatrixXd& accelerations) const
+{
+    if (times.hasNaN()) {
+        TGL_REPORT_ERROR("Cannot evaluate the trajectory at a NaN time.");
+        return TGL_ERROR;
+    }
+    const int n = times.size();
+    std::vector<int> sortedOrder(n);
+    for (int i = 0; i < n; ++i) {
+        sortedOrder[i] = i;
+    }
+    std::sort(sortedOrder.begin(), sortedOrder.end(), [&times](const int a, const int b) { return times(a) < times(b); });
+
+    const int dof = getDimension();
+    positions.resize(dof, n);
+    velocities.resize(dof, n);
+    accelerations.resize(dof, n);
+    Eigen::VectorXd pos(dof), vel(dof), acc(dof);
+    int cursor = 0;
+    for (const int i : sortedOrder) {
+        if (evaluate(pos, vel, acc, times(i), cursor) == TGL_ERROR) {
+            return TGL_ERROR;
+        }
+        positions.col(i) = pos;
+        velocities.col(i) = vel;
+        accelerations.col(i) = acc;
+    }
+    return TGL_OK;
+}
+
+int TrajectoryCore::findSegment(const StdDoubleVector& knotTimes, const double time, int& segmentCursor)
+{
+    const int nSegments = knotTimes.size() - 1;
+    // Most calls come from a clock moving forward, so check the current and next segments first.
+    for (int s = std::max(segmentCursor, 0); s < std::min(segmentCursor + 2, nSegments); ++s) {
+        if (knotTimes[s] <= time && time < knotTimes[s+1]) {
+            segmentCursor = s;
+            return s;
+        }
+    }
+    int s = std::upper_bound(knotTimes.begin(), knotTimes.end(), time) - knotTimes.begin() - 1;
+    segmentCursor = std::max(0, std::min(s, nSegments - 1));
+    return segmentCursor;
+}
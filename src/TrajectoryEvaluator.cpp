@@ -0,0 +1,135 @@
+/*! \file       TrajectoryEvaluator.cpp
+ *  \brief      A lightweight per-thread evaluator of a shared trajectory core.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/TrajectoryEvaluator.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <cstdlib>
+#include <new>
+
+// Glog includes
+#include <glog/logging.h>
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+TrajectoryEvaluator::TrajectoryEvaluator():
+segmentCursor(0),
+internalClockResetTrigger(true)
+{
+}
+
+TrajectoryEvaluator::TrajectoryEvaluator(TrajectoryCorePtr newCore):
+segmentCursor(0),
+internalClockResetTrigger(true)
+{
+    if(!setCore(newCore))
+        LOG(ERROR) << "Could not set the core you passed to the evaluator.";
+}
+
+TrajectoryEvaluator::~TrajectoryEvaluator()
+{
+}
+
+TglMessage TrajectoryEvaluator::setCore(TrajectoryCorePtr newCore)
+{
+    if (!newCore) {
+        LOG(ERROR) << "The trajectory core is null.";
+        return TGL_ERROR;
+    }
+    core = newCore;
+    segmentCursor = 0;
+    resetInternalClock();
+    return TGL_OK;
+}
+
+TrajectoryCorePtr TrajectoryEvaluator::getCore() const
+{
+    return core;
+}
+
+TglMessage TrajectoryEvaluator::getDesired( Eigen::VectorXd& desiredPos,
+                                            Eigen::VectorXd& desiredVel,
+                                            Eigen::VectorXd& desiredAcc,
+                                            const double time_step)
+{
+    double time = time_step;
+    if (time_step == TGL_USE_INTERNAL_CLOCK) {
+        if (internalClockResetTrigger) {
+            internalClockStartTime = std::chrono::system_clock::now();
+            internalClockResetTrigger = false;
+        }
+        time = std::chrono::duration<double>(std::chrono::system_clock::now() - internalClockStartTime).count();
+    }
+    TglMessage status = getDesiredAt(desiredPos, desiredVel, desiredAcc, time);
+    if (status == TGL_FINISHED) {
+        resetInternalClock();
+    }
+    return status;
+}
+
+TglMessage TrajectoryEvaluator::getDesiredAt(   Eigen::VectorXd& desiredPos,
+                                                Eigen::VectorXd& desiredVel,
+                                                Eigen::VectorXd& desiredAcc,
+                                                const double time)
+{
+    if (!core) {
+        TGL_REPORT_ERROR("The evaluator has no trajectory core. Use setCore() first.");
+        return TGL_ERROR;
+    }
+    return core->evaluate(desiredPos, desiredVel, desiredAcc, time, segmentCursor);
+}
+
+SampleRange TrajectoryEvaluator::samples(const double timeStep, const double startTime, const double endTime)
+{
+    return SampleRange(*this, timeStep, startTime, endTime);
+}
+
+void TrajectoryEvaluator::resetInternalClock()
+{
+    internalClockResetTrigger = true;
+}
+
+void* TrajectoryEvaluator::operator new(std::size_t size)
+{
+    void* pointer = NULL;
+    if (posix_memalign(&pointer, TGL_CACHE_LINE_SIZE, size) != 0) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void TrajectoryEvaluator::operator delete(void* pointer)
+{
+    std::free(pointer);
+}
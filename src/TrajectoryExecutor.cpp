@@ -0,0 +1,101 @@
+/*! \file       TrajectoryExecutor.cpp
+ *  \brief      A small thread pool owned by the library which runs trajectory builds.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/TrajectoryExecutor.hpp"
+
+// STL includes
+#include <algorithm>
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+TrajectoryExecutor::TrajectoryExecutor(const int nThreads):
+stopping(false)
+{
+    for (int i = 0; i < std::max(nThreads, 1); ++i) {
+        workers.push_back(std::thread(&TrajectoryExecutor::work, this));
+    }
+}
+
+TrajectoryExecutor::~TrajectoryExecutor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void TrajectoryExecutor::post(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+int TrajectoryExecutor::getNumberOfThreads() const
+{
+    return workers.size();
+}
+
+TrajectoryExecutor& TrajectoryExecutor::getDefault()
+{
+    static TrajectoryExecutor defaultExecutor(std::max<int>(std::thread::hardware_concurrency(), 1));
+    return defaultExecutor;
+}
+
+
+/****************************************************
+                   Private Functions
+ ****************************************************/
+
+void TrajectoryExecutor::work()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
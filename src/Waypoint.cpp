@@ -27,6 +27,7 @@
 */
 
 #include "tgl/Waypoint.hpp"
+#include "tgl/TglDiagnostics.hpp"
 
 
 using namespace tgl;
@@ -59,15 +60,26 @@ wptType(TGL_WPT_LGSM_QUAT)
 }
 
 
-// TODO: Bug here.
-// Waypoint::Waypoint(const Eigen::Wrenchd& newWpt, double newWptTime)
-// {
-//     set(newWpt, newWptTime);
-// }
+Waypoint::Waypoint(const Eigen::Wrenchd& newWpt, double newWptTime):
+wptType(TGL_WPT_LGSM_WRENCH)
+{
+    this->set(newWpt, newWptTime);
+}
+
+Waypoint::Waypoint(const Waypoint& other):
+wpt(other.wpt),
+wptRotation(other.wptRotation),
+wptTime(other.wptTime),
+wptType(other.wptType)
+{
+}
 
 Waypoint& Waypoint::operator=(Waypoint other)
 {
-    other.set(this->get(), this->getTime());
+    wpt = other.wpt;
+    wptRotation = other.wptRotation;
+    wptTime = other.wptTime;
+    wptType = other.wptType;
     return *this;
 }
 
@@ -84,7 +96,7 @@ Waypoint Waypoint::operator+(Waypoint& other)
         return  Waypoint((this->get() + other.get()));
     }
     else {
-        LOG(ERROR) << "Waypoint dimensions do not match: "<<this->getDimension()<<" ~= "<<other.getDimension()<<".";
+        TGL_REPORT_ERROR("Waypoint dimensions do not match: %.0f ~= %.0f.", this->getDimension(), other.getDimension());
         return Waypoint();
     }
 }
@@ -95,7 +107,7 @@ Waypoint Waypoint::operator-(Waypoint& other)
         return  Waypoint((this->get() - other.get()));
     }
     else {
-        LOG(ERROR) << "Waypoint dimensions do not match: "<<this->getDimension()<<" ~= "<<other.getDimension()<<".";
+        TGL_REPORT_ERROR("Waypoint dimensions do not match: %.0f ~= %.0f.", this->getDimension(), other.getDimension());
         return Waypoint();
     }
 }
@@ -111,7 +123,7 @@ Waypoint Waypoint::operator/(double scalar)
         return  Waypoint(this->get() / scalar);
     }
     else {
-        LOG(ERROR) << "Divide by zero.";
+        TGL_REPORT_ERROR("Divide by zero.");
         return Waypoint();
     }
 }
@@ -160,6 +172,7 @@ TglMessage Waypoint::set(const Eigen::Displacementd& newWpt, double newWptTime)
         if (this->setInternalRotation(newWpt.getRotation())) {
             return this->setInternalVariables(newVectorXdWpt, newWptTime);
         }
+        return TGL_ERROR;
     }
     else {
         LOG(ERROR) << "You can not set a waypoint of type: " << this->type() << " with an Eigen::VectorXd.";
@@ -190,7 +203,7 @@ TglMessage Waypoint::set(const Eigen::Wrenchd& newWpt, double newWptTime)
         return this->setInternalVariables(newVectorXdWpt, newWptTime);
     }
     else {
-        LOG(ERROR) << "You can not set a waypoint of type: " << this->type() << " with an Eigen::VectorXd.";
+        LOG(ERROR) << "You can not set a waypoint of type: " << this->type() << " with an Eigen::Wrenchd.";
         return TGL_ERROR;
     }
 }
@@ -217,6 +230,17 @@ Eigen::VectorXd Waypoint::get(bool includeTimes)
     }
 }
 
+Eigen::Wrenchd Waypoint::getWrench()
+{
+    if (this->type() == TGL_WPT_LGSM_WRENCH) {
+        return Eigen::Wrenchd(wpt);
+    }
+    else {
+        TGL_REPORT_ERROR("Waypoints of type: %.0f are not wrenches.", this->type());
+        return Eigen::Wrenchd(0,0,0,0,0,0);
+    }
+}
+
 double Waypoint::getTime()
 {
     return wptTime;
@@ -228,7 +252,7 @@ Eigen::Rotation3d Waypoint::getRotation()
         return wptRotation;
     }
     else {
-        LOG(ERROR) << "Waypoints of type: " << this->type() << " do not have a quaternion component.";
+        TGL_REPORT_ERROR("Waypoints of type: %.0f do not have a quaternion component.", this->type());
         return Eigen::Rotation3d::Identity();
     }
 }
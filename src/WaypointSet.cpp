@@ -27,26 +27,160 @@
  */
 
 #include "tgl/WaypointSet.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
 
 
 using namespace tgl;
 
+/*! The waypoints being simplified. Read only, so it is shared by all the tasks.
+ */
+struct SimplifyProblem {
+    const double* times;                /*!< The waypoint times. */
+    const double* coordinates;          /*!< The waypoint coordinates, nDof per waypoint. */
+    const double* quaternions;          /*!< The waypoint quaternions (w, x, y, z), null if the orientations are ignored. */
+    int nDof;                           /*!< The number of coordinates per waypoint. */
+    double tolerance;                   /*!< The distance tolerance. */
+    double orientationTolerance;        /*!< The angle tolerance. */
+};
+
+/*! A deviation relative to its tolerance, above 1 when it is outside. A zero tolerance is not inverted: an exact match gives 0 and any other deviation gives infinity, never NaN.
+ */
+static inline double relativeDeviation(const double deviation, const double tolerance)
+{
+    if (tolerance > 0.0) {
+        return deviation / tolerance;
+    }
+    return deviation > 0.0 ? std::numeric_limits<double>::infinity() : 0.0;
+}
+
+/*! The deviation of waypoint i from the simplified path between waypoints a and b, relative to the tolerances, so that a value above 1 means that the waypoint must be kept.
+ */
+static inline double simplifyDeviation(const SimplifyProblem& problem, const int a, const int b, const int i)
+{
+    double deviation = 0.0;
+    if (problem.nDof > 0) {
+        Eigen::Map<const Eigen::VectorXd> pa(problem.coordinates + a * problem.nDof, problem.nDof);
+        Eigen::Map<const Eigen::VectorXd> pb(problem.coordinates + b * problem.nDof, problem.nDof);
+        Eigen::Map<const Eigen::VectorXd> pi(problem.coordinates + i * problem.nDof, problem.nDof);
+        const double segmentSquaredNorm = (pb - pa).squaredNorm();
+        double u = 0.0;
+        if (segmentSquaredNorm > 0.0) {
+            u = std::min(1.0, std::max(0.0, (pi - pa).dot(pb - pa) / segmentSquaredNorm));
+        }
+        deviation = relativeDeviation((pi - pa - u * (pb - pa)).norm(), problem.tolerance);
+    }
+    if (problem.quaternions) {
+        const double* qa = problem.quaternions + 4 * a;
+        const double* qb = problem.quaternions + 4 * b;
+        const double* qi = problem.quaternions + 4 * i;
+        const double duration = problem.times[b] - problem.times[a];
+        const double s = duration > 0.0 ? (problem.times[i] - problem.times[a]) / duration : 0.0;
+        const Eigen::Quaterniond interpolated = Eigen::Quaterniond(qa[0], qa[1], qa[2], qa[3]).slerp(s, Eigen::Quaterniond(qb[0], qb[1], qb[2], qb[3]));
+        const double angle = interpolated.angularDistance(Eigen::Quaterniond(qi[0], qi[1], qi[2], qi[3]));
+        deviation = std::max(deviation, relativeDeviation(angle, problem.orientationTolerance));
+    }
+    return deviation;
+}
+
+/*! Finds the waypoint strictly between a and b which deviates the most, the first one on ties. Large ranges are searched in parallel chunks.
+ */
+static int findWorstWaypoint(const SimplifyProblem& problem, const int a, const int b, double& worstDeviation)
+{
+    const int n = b - a - 1;
+    int worst = a + 1;
+    worstDeviation = -1.0;
+    if (n < 2 * TGL_SIMPLIFY_PARALLEL_SIZE) {
+        for (int i = a + 1; i < b; ++i) {
+            const double deviation = simplifyDeviation(problem, a, b, i);
+            if (deviation > worstDeviation) {
+                worstDeviation = deviation;
+                worst = i;
+            }
+        }
+        return worst;
+    }
+
+    std::mutex worstMutex;
+    TglTools::parallelFor(n, [&](int begin, int end) {
+        int chunkWorst = a + 1 + begin;
+        double chunkDeviation = -1.0;
+        for (int i = a + 1 + begin; i < a + 1 + end; ++i) {
+            const double deviation = simplifyDeviation(problem, a, b, i);
+            if (deviation > chunkDeviation) {
+                chunkDeviation = deviation;
+                chunkWorst = i;
+            }
+        }
+        std::lock_guard<std::mutex> lock(worstMutex);
+        if (chunkDeviation > worstDeviation || (chunkDeviation == worstDeviation && chunkWorst < worst)) {
+            worstDeviation = chunkDeviation;
+            worst = chunkWorst;
+        }
+    }, TGL_SIMPLIFY_PARALLEL_SIZE);
+    return worst;
+}
+
+/*! Ramer-Douglas-Peucker on the range [a, b], whose ends are kept. Sub-ranges are processed with an explicit stack, and large ones are handed to new tasks while taskDepth allows it. Every waypoint is written by a single task, so `keep` needs no lock.
+ */
+static void simplifyRange(const SimplifyProblem& problem, const int first, const int last, std::vector<char>& keep, const int taskDepth)
+{
+    std::vector<std::pair<int, int> > ranges(1, std::make_pair(first, last));
+    std::vector<std::future<void> > tasks;
+    while (!ranges.empty()) {
+        const int a = ranges.back().first;
+        const int b = ranges.back().second;
+        ranges.pop_back();
+        if (b - a < 2) {
+            continue;
+        }
+
+        double worstDeviation;
+        const int worst = findWorstWaypoint(problem, a, b, worstDeviation);
+        if (worstDeviation <= 1.0) {
+            continue;
+        }
+        keep[worst] = 1;
+
+        if (taskDepth > 0 && b - worst > TGL_SIMPLIFY_PARALLEL_SIZE && worst - a > TGL_SIMPLIFY_PARALLEL_SIZE) {
+            tasks.push_back(std::async(std::launch::async, simplifyRange, std::cref(problem), worst, b, std::ref(keep), taskDepth - 1));
+        }
+        else {
+            ranges.push_back(std::make_pair(worst, b));
+        }
+        ranges.push_back(std::make_pair(a, worst));
+    }
+    for (auto& task : tasks) {
+        task.get();
+    }
+}
+
 /****************************************************
                    Public Functions
  ****************************************************/
 
-WaypointSet::WaypointSet()
+WaypointSet::WaypointSet():
+wptType(TGL_WPT_NONE)
 {
 }
 
-WaypointSet::WaypointSet(const StdWaypointVector& wptVec)
+WaypointSet::WaypointSet(const StdWaypointVector& wptVec):
+wptType(TGL_WPT_NONE)
 {
     if(!setWaypointMap(wptVec)){
         LOG(ERROR) << "Unable to properly set waypoints.";
     }
 }
 
-WaypointSet::WaypointSet(std::initializer_list<Waypoint> il)
+WaypointSet::WaypointSet(std::initializer_list<Waypoint> il):
+wptType(TGL_WPT_NONE)
 {
     StdWaypointVector wptVec;
     for(auto&& i : il)
@@ -57,6 +191,22 @@ WaypointSet::WaypointSet(std::initializer_list<Waypoint> il)
     }
 }
 
+WaypointSet::WaypointSet(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates):
+wptType(TGL_WPT_NONE)
+{
+    if(!assign(times, coordinates)){
+        LOG(ERROR) << "Unable to properly set waypoints.";
+    }
+}
+
+WaypointSet::WaypointSet(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates, const Eigen::Ref<const Eigen::MatrixXd>& quaternions):
+wptType(TGL_WPT_NONE)
+{
+    if(!assign(times, coordinates, quaternions)){
+        LOG(ERROR) << "Unable to properly set waypoints.";
+    }
+}
+
 WaypointSet::~WaypointSet()
 {
 }
@@ -66,6 +216,25 @@ TglMessage WaypointSet::setWaypoints(const StdWaypointVector& wptVec)
     return setWaypointMap(wptVec);
 }
 
+TglMessage WaypointSet::assign(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates)
+{
+    return setFastWaypointVectors(times, coordinates, Eigen::MatrixXd(4, 0), TGL_WPT_VECTOR_XD);
+}
+
+TglMessage WaypointSet::assign(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates, const Eigen::Ref<const Eigen::MatrixXd>& quaternions)
+{
+    if (coordinates.rows() == 3) {
+        return setFastWaypointVectors(times, coordinates, quaternions, TGL_WPT_LGSM_DISP);
+    }
+    else if (coordinates.rows() == 0) {
+        return setFastWaypointVectors(times, coordinates, quaternions, TGL_WPT_LGSM_QUAT);
+    }
+    else {
+        LOG(ERROR) << "Waypoints with quaternions must have 3 (TGL_WPT_LGSM_DISP) or 0 (TGL_WPT_LGSM_QUAT) coordinate rows, got " << coordinates.rows() << ".";
+        return TGL_ERROR;
+    }
+}
+
 TglMessage WaypointSet::insert(const Waypoint& wpt)
 {
     //TODO: implement
@@ -86,22 +255,22 @@ TglMessage WaypointSet::push_back(const StdWaypointVector& wptVec)
     //TODO: implement
 }
 
+TglMessage WaypointSet::assignWrenches(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& wrenches)
+{
+    if (wrenches.rows() != 6) {
+        LOG(ERROR) << "Wrench waypoints must have 6 rows (torque then force), got " << wrenches.rows() << ".";
+        return TGL_ERROR;
+    }
+    return setFastWaypointVectors(times, wrenches, Eigen::MatrixXd(4, 0), TGL_WPT_LGSM_WRENCH);
+}
+
 Eigen::MatrixXd WaypointSet::asMatrix(bool includeTimes, bool useRowFormat)
 {
-    if(!wptMap.empty()){
-        if (includeTimes) {
-            Eigen::Map<Eigen::MatrixXd> mat(fastWptVectorWithTimes.data(), getWaypointDimension()+1, getNumberOfWaypoints());
-            if (useRowFormat) {
-                return mat.transpose();
-            }
-            return mat;
-        } else {
-            Eigen::Map<Eigen::MatrixXd> mat(fastWptVector.data(), getWaypointDimension(), getNumberOfWaypoints());
-            if (useRowFormat) {
-                return mat.transpose();
-            }
-            return mat;
+    if(!empty()){
+        if (useRowFormat) {
+            return asRowMajorMatrixView(includeTimes);
         }
+        return asMatrixView(includeTimes);
     }else{
         // Map is empty so just return a Zero mat
         LOG(WARNING) << "Waypoint set is empty.";
@@ -109,20 +278,54 @@ Eigen::MatrixXd WaypointSet::asMatrix(bool includeTimes, bool useRowFormat)
     }
 }
 
+ConstMatrixMap WaypointSet::asMatrixView(bool includeTimes) const
+{
+    int nWpts = fastWptTimesVector.size();
+    if (includeTimes) {
+        return ConstMatrixMap(fastWptVectorWithTimes.data(), nWpts ? fastWptVectorWithTimes.size()/nWpts : 0, nWpts);
+    }
+    return ConstMatrixMap(fastWptVector.data(), nWpts ? fastWptVector.size()/nWpts : 0, nWpts);
+}
+
+ConstRowMajorMatrixMap WaypointSet::asRowMajorMatrixView(bool includeTimes) const
+{
+    // Each waypoint is stored contiguously, so the row-major reading of the buffer is its transpose.
+    int nWpts = fastWptTimesVector.size();
+    if (includeTimes) {
+        return ConstRowMajorMatrixMap(fastWptVectorWithTimes.data(), nWpts, nWpts ? fastWptVectorWithTimes.size()/nWpts : 0);
+    }
+    return ConstRowMajorMatrixMap(fastWptVector.data(), nWpts, nWpts ? fastWptVector.size()/nWpts : 0);
+}
+
 Eigen::VectorXd WaypointSet::getWaypointTimes()
 {
-    return Eigen::Map<Eigen::VectorXd>(fastWptTimesVector.data(), getNumberOfWaypoints());
+    return getWaypointTimesView();
+}
+
+ConstVectorMap WaypointSet::getWaypointTimesView() const
+{
+    return ConstVectorMap(fastWptTimesVector.data(), fastWptTimesVector.size());
+}
+
+ConstMatrixMap WaypointSet::rotationsAsMatrixView() const
+{
+    return ConstMatrixMap(fastWptRotationVector.data(), 4, fastWptRotationVector.size()/4);
+}
+
+TglWaypointType WaypointSet::getWaypointType() const
+{
+    return wptType;
 }
 
 int WaypointSet::getNumberOfWaypoints()
 {
-    return wptMap.size();
+    return fastWptTimesVector.size();
 }
 
 int WaypointSet::getWaypointDimension()
 {
-    if(!wptMap.empty())
-        return wptMap.begin()->second.getDimension();
+    if(!empty())
+        return fastWptVector.size() / fastWptTimesVector.size();
 
     else
         return 0;
@@ -130,30 +333,104 @@ int WaypointSet::getWaypointDimension()
 
 Eigen::VectorXd WaypointSet::getWaypointAtTime(const double time_step)
 {
-    if(!wptMap.empty()){
-        // Iterate through the map and compare the wpt times to the desired time.
-        for(auto&& wpt : wptMap){
-            if (time_step == wpt.second.getTime()) {
-                return wpt.second.get();
+    if(!empty()){
+        const PerformanceCounters::Clock::time_point start = counters.startEvaluation();
+        // Iterate through the times and compare the wpt times to the desired time.
+        for(int i = 0; i < getNumberOfWaypoints(); ++i){
+            if (time_step == fastWptTimesVector[i]) {
+                counters.countEvaluation(start);
+                return asMatrixView().col(i);
             }
         }
+        counters.countEvaluation(start);
         // If none of the times match return a vector of zeros.
         return Eigen::VectorXd::Zero(getWaypointDimension());
     }else{
-        //If the map is empty then throw a warning and return a vector of zeros.
-        LOG(ERROR) << "The WaypointSet is empty.";
+        //If the set is empty then throw a warning and return a vector of zeros.
+        TGL_REPORT_ERROR("The WaypointSet is empty.");
         return Eigen::VectorXd::Zero(getWaypointDimension());
     }
 }
 
 bool WaypointSet::empty()
 {
-    return wptMap.empty();
+    return fastWptTimesVector.empty();
+}
+
+PerformanceCounters::Snapshot WaypointSet::getPerformanceSnapshot() const
+{
+    return counters.getSnapshot();
+}
+
+void WaypointSet::resetPerformanceCounters()
+{
+    counters.reset();
+}
+
+TglMessage WaypointSet::simplify(WaypointSet& simplifiedSet, const double tolerance, const double orientationTolerance) const
+{
+    if (fastWptTimesVector.empty()) {
+        LOG(ERROR) << "Cannot simplify an empty WaypointSet.";
+        return TGL_ERROR;
+    }
+    if (!(tolerance >= 0.0) || !(orientationTolerance >= 0.0)) {
+        LOG(ERROR) << "The simplification tolerances must be non-negative, got " << tolerance << " and " << orientationTolerance << ".";
+        return TGL_ERROR;
+    }
+
+    const int nWpts = fastWptTimesVector.size();
+    const ConstMatrixMap coordinates = asMatrixView();
+    const ConstMatrixMap quaternions = rotationsAsMatrixView();
+
+    SimplifyProblem problem;
+    problem.times = fastWptTimesVector.data();
+    problem.coordinates = coordinates.data();
+    problem.nDof = coordinates.rows();
+    problem.tolerance = tolerance;
+    problem.quaternions = (quaternions.cols() > 0 && !std::isinf(orientationTolerance)) ? quaternions.data() : nullptr;
+    problem.orientationTolerance = orientationTolerance;
+
+    std::vector<char> keep(nWpts, 0);
+    keep.front() = 1;
+    keep.back() = 1;
+    if (nWpts > 2) {
+        // Enough task levels for a few tasks per thread, each split halves the waypoints in the best case.
+        const int nThreads = std::max(1u, std::thread::hardware_concurrency());
+        int taskDepth = 2;
+        while ((1 << (taskDepth - 2)) < nThreads) {
+            ++taskDepth;
+        }
+        simplifyRange(problem, 0, nWpts - 1, keep, taskDepth);
+    }
+
+    std::vector<int> kept;
+    for (int i = 0; i < nWpts; ++i) {
+        if (keep[i]) {
+            kept.push_back(i);
+        }
+    }
+    const int nKept = kept.size();
+    Eigen::VectorXd keptTimes(nKept);
+    Eigen::MatrixXd keptCoordinates(coordinates.rows(), nKept);
+    Eigen::MatrixXd keptQuaternions(4, quaternions.cols() > 0 ? nKept : 0);
+    for (int k = 0; k < nKept; ++k) {
+        keptTimes(k) = fastWptTimesVector[kept[k]];
+        keptCoordinates.col(k) = coordinates.col(kept[k]);
+        if (quaternions.cols() > 0) {
+            keptQuaternions.col(k) = quaternions.col(kept[k]);
+        }
+    }
+    return simplifiedSet.setFastWaypointVectors(keptTimes, keptCoordinates, keptQuaternions, wptType);
 }
 
 TglMessage WaypointSet::erase()
 {
     wptMap.clear();
+    wptType = TGL_WPT_NONE;
+    fastWptVector.clear();
+    fastWptTimesVector.clear();
+    fastWptVectorWithTimes.clear();
+    fastWptRotationVector.clear();
     return empty() ? TGL_OK : TGL_ERROR;
 }
 
@@ -164,6 +441,8 @@ TglMessage WaypointSet::erase()
 
 TglMessage WaypointSet::setWaypointMap(const StdWaypointVector& wptVec)
 {
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    wptMap.clear();
     int wptID = 0;
     bool insertOk=true;
     for(auto wpt : wptVec){
@@ -171,7 +450,17 @@ TglMessage WaypointSet::setWaypointMap(const StdWaypointVector& wptVec)
         wptID++;
     }
     if (insertOk) {
-        fillFastWaypointVectors();
+        if (wptMap.empty()) {
+            // An empty input empties the set, fillFastWaypointVectors() would keep the previous waypoints.
+            wptType = TGL_WPT_NONE;
+            fastWptVector.clear();
+            fastWptTimesVector.clear();
+            fastWptVectorWithTimes.clear();
+            fastWptRotationVector.clear();
+        } else {
+            fillFastWaypointVectors();
+        }
+        counters.countRebuild(buildStart, getMemoryUsage());
     }
 
 
@@ -182,15 +471,24 @@ TglMessage WaypointSet::fillFastWaypointVectors()
 {
     if(!wptMap.empty())
     {
+        wptType = wptMap.begin()->second.type();
         fastWptVector.clear();
+        fastWptTimesVector.clear();
         fastWptVectorWithTimes.clear();
+        fastWptRotationVector.clear();
         for(wptMapIterator it = wptMap.begin(); it != wptMap.end(); ++it)
         {
+            Eigen::VectorXd wptCoordinates = it->second.get();
             fastWptTimesVector.push_back(it->second.getTime());
             fastWptVectorWithTimes.push_back(it->second.getTime());
-            for(auto dof = 0; dof < it->second.get().size(); ++dof){
-                fastWptVector.push_back( it->second.get()(dof) );
-                fastWptVectorWithTimes.push_back( it->second.get()(dof) );
+            fastWptVector.insert(fastWptVector.end(), wptCoordinates.data(), wptCoordinates.data() + wptCoordinates.size());
+            fastWptVectorWithTimes.insert(fastWptVectorWithTimes.end(), wptCoordinates.data(), wptCoordinates.data() + wptCoordinates.size());
+            if (it->second.hasRotation()) {
+                Eigen::Rotation3d wptRotation = it->second.getRotation();
+                fastWptRotationVector.push_back(wptRotation.w());
+                fastWptRotationVector.push_back(wptRotation.x());
+                fastWptRotationVector.push_back(wptRotation.y());
+                fastWptRotationVector.push_back(wptRotation.z());
             }
         }
         return TGL_OK;
@@ -199,3 +497,73 @@ TglMessage WaypointSet::fillFastWaypointVectors()
         return TGL_ERROR;
     }
 }
+
+TglMessage WaypointSet::setFastWaypointVectors(const Eigen::Ref<const Eigen::VectorXd>& times, const Eigen::Ref<const Eigen::MatrixXd>& coordinates, const Eigen::Ref<const Eigen::MatrixXd>& quaternions, TglWaypointType newType)
+{
+    const PerformanceCounters::Clock::time_point buildStart = PerformanceCounters::now();
+    const int nWpts = times.size();
+    const int nDof = coordinates.rows();
+    const bool hasQuaternions = newType == TGL_WPT_LGSM_DISP || newType == TGL_WPT_LGSM_QUAT;
+
+    // Validate everything up front so that a bad input never leaves the set half written.
+    if (nWpts == 0 || coordinates.cols() != nWpts) {
+        LOG(ERROR) << "Number of waypoint times (" << nWpts << ") does not match the number of waypoint columns (" << coordinates.cols() << ").";
+        return TGL_ERROR;
+    }
+    if (nDof == 0 && !hasQuaternions) {
+        LOG(ERROR) << "Waypoint coordinates are empty.";
+        return TGL_ERROR;
+    }
+    if (!times.allFinite() || times.minCoeff() < 0.0) {
+        LOG(ERROR) << "Waypoint times must be finite and non-negative.";
+        return TGL_ERROR;
+    }
+    if (nWpts > 1 && (times.tail(nWpts - 1) - times.head(nWpts - 1)).minCoeff() <= 0.0) {
+        LOG(ERROR) << "Waypoint times must be strictly increasing.";
+        return TGL_ERROR;
+    }
+    if (!coordinates.allFinite()) {
+        LOG(ERROR) << "Waypoint coordinates must be finite.";
+        return TGL_ERROR;
+    }
+    if (hasQuaternions) {
+        if (quaternions.rows() != 4 || quaternions.cols() != nWpts) {
+            LOG(ERROR) << "Waypoint quaternions must be a 4x" << nWpts << " matrix, got " << quaternions.rows() << "x" << quaternions.cols() << ".";
+            return TGL_ERROR;
+        }
+        if (!quaternions.allFinite() || (quaternions.colwise().squaredNorm().array() - 1.0).abs().maxCoeff() > 1e-6) {
+            LOG(ERROR) << "Waypoint quaternions must be finite and of unit norm.";
+            return TGL_ERROR;
+        }
+    }
+
+    wptMap.clear();
+    wptType = newType;
+
+    fastWptTimesVector.resize(nWpts);
+    Eigen::Map<Eigen::VectorXd>(fastWptTimesVector.data(), nWpts) = times;
+
+    fastWptVector.resize(nDof * nWpts);
+    Eigen::Map<Eigen::MatrixXd>(fastWptVector.data(), nDof, nWpts) = coordinates;
+
+    fastWptVectorWithTimes.resize((nDof + 1) * nWpts);
+    Eigen::Map<Eigen::MatrixXd> withTimes(fastWptVectorWithTimes.data(), nDof + 1, nWpts);
+    withTimes.row(0) = times.transpose();
+    withTimes.bottomRows(nDof) = coordinates;
+
+    if (hasQuaternions) {
+        fastWptRotationVector.resize(4 * nWpts);
+        Eigen::Map<Eigen::MatrixXd>(fastWptRotationVector.data(), 4, nWpts) = quaternions;
+    } else {
+        fastWptRotationVector.clear();
+    }
+
+    counters.countRebuild(buildStart, getMemoryUsage());
+    return TGL_OK;
+}
+
+std::size_t WaypointSet::getMemoryUsage() const
+{
+    return sizeof(WaypointSet) + wptMap.size() * sizeof(WaypointPair)
+           + sizeof(double) * (fastWptVector.capacity() + fastWptTimesVector.capacity() + fastWptVectorWithTimes.capacity() + fastWptRotationVector.capacity());
+}
@@ -0,0 +1,85 @@
+/*! \file       WrenchTrajectory.cpp
+ *  \brief      A force-profile trajectory interpolating wrench waypoints.
+ *  \details
+ *  \author     Ryan Lober
+ *  \version
+ *  \date       Oct 2026
+ *  \bug
+ *  \warning
+ *  \copyright  GNU General Public License.
+ */
+/*
+ *  This file is part of TGL (Trajectory Generation Library).
+ *  Copyright (C) 2016 Institut des Systèmes Intelligents et de Robotique (ISIR)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tgl/WrenchTrajectory.hpp"
+
+
+using namespace tgl;
+
+/****************************************************
+                   Public Functions
+ ****************************************************/
+
+WrenchTrajectory::WrenchTrajectory():
+wrenchBuffer(Eigen::VectorXd::Zero(6)),
+wrenchRateBuffer(Eigen::VectorXd::Zero(6)),
+wrenchRateDerivativeBuffer(Eigen::VectorXd::Zero(6))
+{
+}
+
+WrenchTrajectory::WrenchTrajectory(const WaypointSet& newWptSet):
+wrenchBuffer(Eigen::VectorXd::Zero(6)),
+wrenchRateBuffer(Eigen::VectorXd::Zero(6)),
+wrenchRateDerivativeBuffer(Eigen::VectorXd::Zero(6))
+{
+    if(!setWaypoints(newWptSet))
+        LOG(ERROR) << "Could not set the waypoints you passed to the trajectory.";
+}
+
+WrenchTrajectory::~WrenchTrajectory()
+{
+}
+
+TglMessage WrenchTrajectory::getDesired(Eigen::Wrenchd& desiredWrench,
+                                        Eigen::Wrenchd& desiredWrenchRate,
+                                        Eigen::Wrenchd& desiredWrenchRateDerivative,
+                                        const double time_step)
+{
+    double tmp_time_step = time_step == TGL_USE_INTERNAL_CLOCK ? getInternalClockTime() : time_step;
+    TglMessage evaluationMessage = evaluate(tmp_time_step, wrenchBuffer, wrenchRateBuffer, wrenchRateDerivativeBuffer);
+    if (evaluationMessage == TGL_ERROR) {
+        return TGL_ERROR;
+    }
+    desiredWrench = Eigen::Wrenchd(wrenchBuffer);
+    desiredWrenchRate = Eigen::Wrenchd(wrenchRateBuffer);
+    desiredWrenchRateDerivative = Eigen::Wrenchd(wrenchRateDerivativeBuffer);
+    if (evaluationMessage == TGL_FINISHED) {
+        resetInternalClock();
+    }
+    return evaluationMessage;
+}
+
+
+/****************************************************
+                   Protected Functions
+ ****************************************************/
+
+bool WrenchTrajectory::supportsWaypointType(TglWaypointType wptType) const
+{
+    return wptType == TGL_WPT_LGSM_WRENCH;
+}
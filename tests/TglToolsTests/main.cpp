@@ -28,6 +28,10 @@
 
 #include "../TglTestTools.hpp"
 #include "tgl/TglTools.hpp"
+#include "tgl/TglDiagnostics.hpp"
+
+#include <memory>
+#include <thread>
 using namespace tgl;
 
 /*************************************************
@@ -71,6 +75,59 @@ protected:
     }
 };
 
+class DiagnosticsTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        // One site reporting in a loop keeps TGL_DIAGNOSTICS_RATE records and suppresses the others.
+        TglDiagnostics::Statistics before = TglDiagnostics::getStatistics();
+        for (int i = 0; i < 100; ++i) {
+            TGL_REPORT_WARNING("Diagnostics test report %.0f of %.0f.", i, 100);
+        }
+        TglDiagnostics::stop();
+        TglDiagnostics::Statistics after = TglDiagnostics::getStatistics();
+        if (after.reported - before.reported != 100
+            || after.suppressed - before.suppressed != 100 - TGL_DIAGNOSTICS_RATE
+            || after.logged - before.logged != TGL_DIAGNOSTICS_RATE
+            || after.dropped != before.dropped) {
+            std::cout << "Rate limiting failed: " << after.reported - before.reported << " reported, " << after.suppressed - before.suppressed << " suppressed, " << after.logged - before.logged << " logged." << std::endl;
+            return TGL_TEST_FAILURE;
+        }
+
+        // Many threads sharing many sites never block, and every record is logged, suppressed or dropped.
+        const int nSites = 256;
+        const int nThreads = 4;
+        const int nReports = 4;
+        std::vector<std::unique_ptr<DiagnosticSite>> sites;
+        for (int i = 0; i < nSites; ++i) {
+            sites.push_back(std::unique_ptr<DiagnosticSite>(new DiagnosticSite(__FILE__, i, TGL_DIAGNOSTIC_WARNING)));
+        }
+        before = TglDiagnostics::getStatistics();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nThreads; ++t) {
+            threads.push_back(std::thread([&sites, t]() {
+                for (int r = 0; r < nReports; ++r) {
+                    for (auto& site : sites) {
+                        TglDiagnostics::report(*site, "Thread %.0f report %.0f.", t, r);
+                    }
+                }
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        TglDiagnostics::stop();
+        TglDiagnostics::flush();
+        after = TglDiagnostics::getStatistics();
+        const uint64_t reported = after.reported - before.reported;
+        const uint64_t accounted = (after.logged - before.logged) + (after.suppressed - before.suppressed) + (after.dropped - before.dropped);
+        std::cout << "Concurrent reports: " << reported << " reported, " << after.logged - before.logged << " logged, " << after.suppressed - before.suppressed << " suppressed, " << after.dropped - before.dropped << " dropped." << std::endl;
+        if (reported != nSites * nThreads * nReports || accounted != reported) {
+            return TGL_TEST_FAILURE;
+        }
+        return TGL_TEST_SUCCESS;
+    }
+};
+
 /*************************************************
 *
 *   main
@@ -87,6 +144,7 @@ int main(int argc, char const *argv[])
     */
 
     testVector.push_back(new ChronoTest);
+    testVector.push_back(new DiagnosticsTest);
 
     /*****************************************/
     return runAllTests(testVector);
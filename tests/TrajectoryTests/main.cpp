@@ -28,7 +28,36 @@
 
 #include "../TglTestTools.hpp"
 #include "tgl/Trajectory.hpp"
+#include "tgl/Se3BSplineTrajectory.hpp"
+#include "tgl/CubicSplineTrajectory.hpp"
+#include "tgl/WrenchTrajectory.hpp"
+#include "tgl/BlendedTrajectory.hpp"
+#include "tgl/SequenceTrajectory.hpp"
+#include "tgl/RetimedTrajectory.hpp"
+#include "tgl/ArcLengthTrajectory.hpp"
+#include "tgl/MinimumSnapTrajectory.hpp"
+#include "tgl/CoefficientCache.hpp"
+#include "tgl/TrajectoryCache.hpp"
+#include "tgl/TrajectoryEvaluator.hpp"
+#include "tgl/AsyncTrajectoryBuilder.hpp"
+#include "tgl/PolynomialKernel.hpp"
+#include "tgl/SplineFitter.hpp"
+#include "tgl/DmpTrajectory.hpp"
+#include "tgl/PiecewisePolynomial.hpp"
+#include "tgl/PolynomialTrajectory.hpp"
+#include "tgl/PolySegment.hpp"
+#include "tgl/PerformanceCounters.hpp"
 #include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <dirent.h>
+#include <unistd.h>
 
 using namespace tgl;
 
@@ -61,6 +90,1472 @@ protected:
     }
 };
 
+class Se3BSplineTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        double s = std::sqrt(0.5);
+        WaypointSet wpts = {Waypoint(Eigen::Displacementd(0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0), 0.0),
+                            Waypoint(Eigen::Displacementd(0.5, 0.2, 0.1, s, s, 0.0, 0.0), 1.0),
+                            Waypoint(Eigen::Displacementd(1.0, 0.5, 0.0, s, 0.0, s, 0.0), 1.5),
+                            Waypoint(Eigen::Displacementd(1.2, 1.0, 0.3, 0.0, 0.0, 0.0, 1.0), 3.0)};
+        Se3BSplineTrajectory traj(wpts);
+
+        bool checks = true;
+        double tol = 1e-9;
+        Eigen::Displacementd pose, poseNext;
+        Eigen::Twistd twist, twistDerivative, twistPrev, twistNext;
+
+        // Clamped ends: exactly on the first and last waypoints, at rest.
+        checks &= traj.getDesired(pose, twist, twistDerivative, 0.0) == TGL_RUNNING;
+        checks &= (pose.getTranslation() - Eigen::Vector3d::Zero()).norm() < tol && twist.norm() < tol;
+        checks &= traj.getDesired(pose, twist, twistDerivative, 3.0) == TGL_FINISHED;
+        checks &= (pose.getTranslation() - Eigen::Vector3d(1.2, 1.0, 0.3)).norm() < tol && std::abs(std::abs(pose.getRotation().z()) - 1.0) < tol;
+        if(!checks){std::cout << "End points failed." << std::endl;}
+
+        // The body twist and its derivative must match finite differences of the pose.
+        double h = 1e-5;
+        for (double t : {0.3, 0.99, 1.2, 2.5}) {
+            Eigen::Twistd unused;
+            traj.getDesired(poseNext, twistNext, unused, t + h);
+            traj.getDesired(pose, twistPrev, unused, t - h);
+            traj.getDesired(pose, twist, twistDerivative, t);
+            Vector6d fdTwist = (pose.inverse() * poseNext).log() / h;
+            Vector6d fdTwistDerivative = (twistNext - twistPrev) / (2.0 * h);
+            checks &= (fdTwist - Vector6d(twist)).norm() < 1e-3;
+            checks &= (fdTwistDerivative - Vector6d(twistDerivative)).norm() < 1e-3;
+        }
+        if(!checks){std::cout << "Twist derivatives failed." << std::endl;}
+
+        // Batch and VectorXd interfaces agree with the typed interface.
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(50, -0.5, 3.5);
+        Eigen::MatrixXd poses, twists, twistDerivatives;
+        checks &= traj.getDesiredBatch(times, poses, twists, twistDerivatives) == TGL_OK;
+        Eigen::VectorXd pos, vel, acc;
+        for (int i = 0; i < times.size(); ++i) {
+            traj.getDesired(pos, vel, acc, times(i));
+            checks &= (pos - poses.col(i)).norm() < tol && (vel - twists.col(i)).norm() < tol && (acc - twistDerivatives.col(i)).norm() < tol;
+        }
+        if(!checks){std::cout << "Batch evaluation failed." << std::endl;}
+
+        // Wrong waypoint types are refused.
+        WaypointSet vecWpts = {Waypoint(Eigen::VectorXd::Ones(3), 0.0), Waypoint(Eigen::VectorXd::Ones(3), 1.0)};
+        checks &= !traj.setWaypoints(vecWpts);
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class CubicSplineTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        Eigen::VectorXd times(4); times << 0.0, 0.5, 1.5, 2.0;
+        Eigen::MatrixXd coords(2,4); coords << 0.0, 1.0, -1.0, 2.0,
+                                               0.0, 0.5,  0.5, 0.0;
+        WaypointSet wpts(times, coords);
+        CubicSplineTrajectory traj(wpts);
+
+        bool checks = true;
+        double tol = 1e-9;
+        Eigen::VectorXd pos, vel, acc, posL, velL, accL, posR, velR, accR;
+
+        // Passes through every waypoint, starts and ends at rest.
+        for (int i = 0; i < times.size(); ++i) {
+            traj.getDesired(pos, vel, acc, times(i));
+            checks &= (pos - coords.col(i)).norm() < tol;
+        }
+        traj.getDesired(pos, vel, acc, 0.0);
+        checks &= vel.norm() < tol;
+        checks &= traj.getDesired(pos, vel, acc, 2.0) == TGL_FINISHED;
+        checks &= (pos - coords.col(3)).norm() < tol;
+        checks &= traj.getDesired(pos, vel, acc, -0.5) == TGL_START;
+        if(!checks){std::cout << "Interpolation failed." << std::endl;}
+
+        // C2 continuity at the interior knots.
+        double h = 1e-9;
+        for (int i = 1; i < times.size() - 1; ++i) {
+            traj.getDesired(posL, velL, accL, times(i) - h);
+            traj.getDesired(posR, velR, accR, times(i));
+            checks &= (velL - velR).norm() < 1e-6 && (accL - accR).norm() < 1e-6;
+        }
+        if(!checks){std::cout << "Continuity failed." << std::endl;}
+
+        // Wrong waypoint types are refused.
+        WaypointSet dispWpts = {Waypoint(Eigen::Displacementd(0,0,0), 0.0), Waypoint(Eigen::Displacementd(1,0,0), 1.0)};
+        checks &= !traj.setWaypoints(dispWpts);
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class WrenchTrajectoryTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        Eigen::Wrenchd w0(0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+        Eigen::Wrenchd w1(0.1, 0.0, 0.0, 0.0, 0.0, -5.0);
+        Eigen::Wrenchd w2(0.0, 0.2, 0.0, 1.0, 0.0, -10.0);
+        WaypointSet wpts = {Waypoint(w0, 0.0), Waypoint(w1, 0.5), Waypoint(w2, 1.0)};
+        WrenchTrajectory traj(wpts);
+
+        bool checks = true;
+        Eigen::Wrenchd wrench, wrenchRate, wrenchRateDerivative;
+        checks &= traj.getDesired(wrench, wrenchRate, wrenchRateDerivative, 0.5) == TGL_RUNNING;
+        checks &= (wrench - w1).norm() < 1e-9;
+        checks &= traj.getDesired(wrench, wrenchRate, wrenchRateDerivative, 1.0) == TGL_FINISHED;
+        checks &= (wrench - w2).norm() < 1e-9;
+        if(!checks){std::cout << "Wrench interpolation failed." << std::endl;}
+
+        // Vector waypoints are refused by the force-profile trajectory.
+        WaypointSet vecWpts = {Waypoint(Eigen::VectorXd::Ones(6), 0.0), Waypoint(Eigen::VectorXd::Ones(6), 1.0)};
+        checks &= !traj.setWaypoints(vecWpts);
+        checks &= traj.setWaypoints(wpts);
+
+        // A 4 kHz control loop over the whole profile.
+        int nTicks = 4000;
+        std::cout << "\n-----------------\n\nStart chrono tests...\n\n" << std::endl;
+        TGL_CHRONO_START
+        for (int i = 0; i < nTicks; ++i) {
+            traj.getDesired(wrench, wrenchRate, wrenchRateDerivative, i / 4000.0);
+        }
+        TGL_CHRONO_STOP_US
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class BlendedTrajectoryTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        Eigen::VectorXd times(3); times << 0.0, 1.0, 2.0;
+        Eigen::MatrixXd coords(2,3); coords << 0.0, 1.0, 2.0,
+                                               0.0, 1.0, 0.0;
+        BlendedTrajectory traj;
+        bool checks = true;
+        checks &= traj.setWaypoints(WaypointSet(times, coords));
+
+        // Stream goals at 50 Hz, each one a new path ending at a different point.
+        double switchTime = 0.3, blendDuration = 0.1, h = 1e-7;
+        Eigen::VectorXd posL, velL, accL, posR, velR, accR;
+        for (int i = 0; i < 100; ++i) {
+            Eigen::VectorXd goalTimes(2); goalTimes << switchTime, switchTime + 1.0;
+            Eigen::MatrixXd goals(2,2); goals << 0.0, 1.0 + 0.01 * i,
+                                                0.0, -1.0;
+            traj.getDesired(posL, velL, accL, switchTime);
+            goals.col(0) = posL;
+            checks &= traj.blendTo(WaypointSet(goalTimes, goals), switchTime, blendDuration);
+
+            // C1/C2 at both ends of the blend.
+            for (double t : {switchTime, switchTime + blendDuration}) {
+                traj.getDesired(posL, velL, accL, t - h);
+                traj.getDesired(posR, velR, accR, t + h);
+                checks &= (posL - posR).norm() < 1e-5 && (velL - velR).norm() < 1e-4 && (accL - accR).norm() < 1e-2;
+            }
+            switchTime += 0.02;
+        }
+        if(!checks){std::cout << "Blend continuity failed." << std::endl;}
+
+        // Old pieces are dropped, so the trajectory stays small.
+        checks &= traj.getNumberOfPieces() <= 3;
+        if(!checks){std::cout << "Pieces are not bounded." << std::endl;}
+
+        // Follows the last path after the blend.
+        checks &= traj.getDesired(posR, velR, accR, switchTime + 5.0) == TGL_FINISHED;
+        checks &= (posR - Eigen::Vector2d(1.99, -1.0)).norm() < 1e-9;
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class SequenceTrajectoryTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        Eigen::VectorXd times(3); times << 0.0, 0.5, 1.0;
+        Eigen::MatrixXd coords(2,3); coords << 0.0, 0.5, 1.0,
+                                               0.0, 1.0, 2.0;
+        TrajectoryPtr spline = std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords));
+
+        // There, wait, and back again.
+        SequenceTrajectory roundTrip;
+        bool checks = true;
+        checks &= roundTrip.append(spline, 1.0);
+        checks &= roundTrip.appendHold(0.5);
+        checks &= roundTrip.appendReversed(spline, 1.0);
+        checks &= !roundTrip.appendHold(0.0);
+
+        Eigen::VectorXd pos, vel, acc, refPos, refVel, refAcc;
+        spline->getDesired(refPos, refVel, refAcc, 0.3);
+        checks &= roundTrip.getDesired(pos, vel, acc, 0.3) == TGL_RUNNING && (pos - refPos).norm() < 1e-12;
+        checks &= roundTrip.getDesired(pos, vel, acc, 1.2) == TGL_RUNNING && (pos - coords.col(2)).norm() < 1e-12 && vel.norm() == 0.0;
+        spline->getDesired(refPos, refVel, refAcc, 0.8);
+        checks &= roundTrip.getDesired(pos, vel, acc, 1.7) == TGL_RUNNING && (pos - refPos).norm() < 1e-12 && (vel + refVel).norm() < 1e-12;
+        checks &= roundTrip.getDesired(pos, vel, acc, 3.0) == TGL_FINISHED && (pos - coords.col(0)).norm() < 1e-12;
+        if(!checks){std::cout << "Hold or reversal failed." << std::endl;}
+
+        // A long program of lazily built steps, nested and shifted in time.
+        int nSteps = 10000;
+        std::shared_ptr<SequenceTrajectory> program = std::make_shared<SequenceTrajectory>();
+        for (int i = 0; i < nSteps; ++i) {
+            checks &= program->append([=](){ return std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords.array() + i)); }, 1.0);
+        }
+        SequenceTrajectory task;
+        checks &= task.append(program, program->getDuration());
+        task.setStartTime(10.0);
+        checks &= program->getNumberOfBuiltSteps() == 0 && task.getDuration() == nSteps;
+
+        checks &= task.getDesired(pos, vel, acc, 5.0) == TGL_START && (pos - coords.col(0)).norm() < 1e-12;
+        checks &= task.getDesired(pos, vel, acc, 10.0 + 4321.5) == TGL_RUNNING && (pos - (coords.col(1).array() + 4321).matrix()).norm() < 1e-12;
+        checks &= program->getNumberOfBuiltSteps() == 2;
+        if(!checks){std::cout << "Lazy nested sequence failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class RetimedTrajectoryTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        Eigen::VectorXd times(4); times << 0.0, 1.0, 2.0, 3.0;
+        Eigen::MatrixXd coords(2,4); coords << 0.0, 1.0, 0.5, 2.0,
+                                               0.0, -1.0, 1.0, 0.0;
+        TrajectoryPtr spline = std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords));
+        RetimedTrajectory traj(spline);
+
+        // Slow down to 40% at t = 0.5, then back up to 100% at t = 1.5.
+        bool checks = true;
+        checks &= traj.setSpeedOverride(0.4, 0.2, 0.5);
+        checks &= traj.setSpeedOverride(1.0, 0.3, 1.5);
+        checks &= !traj.setSpeedOverride(-0.1, 0.1, 2.0);
+
+        // The derivatives must match finite differences, across the ramps too.
+        double h = 1e-6;
+        Eigen::VectorXd pos, vel, acc, posM, velM, accM, posP, velP, accP;
+        for (double t = 0.05; t < 3.0; t += 0.05) {
+            traj.getDesired(pos, vel, acc, t);
+            traj.getDesired(posM, velM, accM, t - h);
+            traj.getDesired(posP, velP, accP, t + h);
+            checks &= ((posP - posM) / (2.0*h) - vel).norm() < 1e-6;
+            checks &= ((velP - velM) / (2.0*h) - acc).norm() < 1e-4;
+        }
+        if(!checks){std::cout << "Retimed derivatives failed." << std::endl;}
+
+        // After the ramps the path runs at the target speed, offset by the time lost while slowed down.
+        double lostTime = 0.2 * 0.3 + (1.5 - 0.7) * 0.6 + 0.3 * 0.3;
+        checks &= std::abs(traj.getSpeedScale(1.0) - 0.4) < 1e-12 && std::abs(traj.getSpeedScale(2.0) - 1.0) < 1e-12;
+        checks &= std::abs(traj.getPathTime(2.5) - (2.5 - lostTime)) < 1e-12;
+        checks &= traj.getDesired(pos, vel, acc, 3.0 + lostTime) == TGL_FINISHED && (pos - coords.col(3)).norm() < 1e-12;
+        if(!checks){std::cout << "Retimed path time failed." << std::endl;}
+
+        // An override given during a ramp continues from its rate, so the acceleration does not jump.
+        RetimedTrajectory interrupted(spline);
+        checks &= interrupted.setSpeedOverride(0.2, 1.0, 0.5);
+        interrupted.getDesired(posM, velM, accM, 0.8 - h);
+        checks &= interrupted.setSpeedOverride(1.0, 0.5, 0.8);
+        interrupted.getDesired(posP, velP, accP, 0.8 + h);
+        checks &= (accP - accM).norm() < 1e-4;
+        for (double t = 0.85; t < 1.3; t += 0.05) {
+            interrupted.getDesired(pos, vel, acc, t);
+            interrupted.getDesired(posM, velM, accM, t - h);
+            interrupted.getDesired(posP, velP, accP, t + h);
+            checks &= ((posP - posM) / (2.0*h) - vel).norm() < 1e-6;
+            checks &= ((velP - velM) / (2.0*h) - acc).norm() < 1e-4;
+        }
+        // Stopping quickly during a slow down never runs the path backwards.
+        checks &= interrupted.setSpeedOverride(0.0, 2.0, 2.0);
+        checks &= interrupted.setSpeedOverride(0.0, 0.01, 2.5);
+        for (double t = 2.5; t < 2.52; t += 0.001) {
+            checks &= interrupted.getSpeedScale(t) > -1e-12;
+        }
+        if(!checks){std::cout << "Retimed override during a ramp failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class ClosestTimeTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        // A long planar spiral, dense enough that neighbouring turns are close.
+        int nWpts = 100001;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, nWpts - 1.0);
+        Eigen::MatrixXd coords(2, nWpts);
+        for (int i = 0; i < nWpts; ++i) {
+            double angle = 0.05 * i, radius = 1.0 + 0.001 * i;
+            coords.col(i) << radius * std::cos(angle), radius * std::sin(angle);
+        }
+        CubicSplineTrajectory traj(WaypointSet(times, coords));
+
+        bool checks = true;
+        double closestTime, distance;
+        Eigen::VectorXd pos, vel, acc, point(2);
+
+        // Points on the path project onto themselves.
+        for (double t : {0.0, 12.3, 5000.7, 99999.5}) {
+            traj.getDesired(pos, vel, acc, t);
+            checks &= traj.getClosestTime(pos, closestTime, distance) && std::abs(closestTime - t) < 1e-6 && distance < 1e-9;
+        }
+        if(!checks){std::cout << "Projection of points on the path failed." << std::endl;}
+
+        // Off-path points agree with a brute force search on the first few turns.
+        int nShortWpts = 1001;
+        CubicSplineTrajectory shortTraj(WaypointSet(times.head(nShortWpts), coords.leftCols(nShortWpts)));
+        point << 0.5, -1.3;
+        double bruteTime = 0.0, bruteDistance = std::numeric_limits<double>::infinity();
+        for (double t = 0.0; t < nShortWpts - 1.0; t += 0.01) {
+            shortTraj.getDesired(pos, vel, acc, t);
+            if ((pos - point).norm() < bruteDistance) {
+                bruteDistance = (pos - point).norm();
+                bruteTime = t;
+            }
+        }
+        checks &= shortTraj.getClosestTime(point, closestTime, distance) && distance <= bruteDistance + 1e-12 && std::abs(closestTime - bruteTime) < 0.01;
+        if(!checks){std::cout << "Projection does not match brute force." << std::endl;}
+
+        // Warm started queries following a robot along the path.
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        closestTime = 50000.0;
+        int nQueries = 1000;
+        for (int i = 0; i < nQueries; ++i) {
+            traj.getDesired(pos, vel, acc, 50000.0 + 0.1 * i);
+            checks &= traj.getClosestTimeNear(pos + Eigen::Vector2d(0.01, 0.0), closestTime, 5.0, closestTime, distance);
+            checks &= std::abs(closestTime - (50000.0 + 0.1 * i)) < 0.5;
+        }
+        double queryTime = std::chrono::duration<double>(std::chrono::system_clock::now() - start).count() / nQueries;
+        std::cout << "Warm started query on " << nWpts - 1 << " segments: " << queryTime * 1e6 << " us." << std::endl;
+        if(!checks){std::cout << "Warm started projection failed." << std::endl;}
+
+        // The closed loop getDesired follows the measured position, first globally then within a window.
+        Eigen::VectorXd zero = Eigen::VectorXd::Zero(2), measured;
+        traj.getDesired(measured, vel, acc, 200.0);
+        checks &= traj.getDesired(pos, vel, acc, measured, zero, zero, 0.5) == TGL_RUNNING && (pos - measured).norm() < 1e-9;
+        traj.setProjectionWindow(5.0);
+        traj.getDesired(measured, vel, acc, 203.0);
+        checks &= traj.getDesired(pos, vel, acc, measured, zero, zero, 0.5) == TGL_RUNNING && (pos - measured).norm() < 1e-9;
+        traj.getDesired(measured, vel, acc, 300.0);
+        checks &= traj.getDesired(pos, vel, acc, measured, zero, zero, 0.5) == TGL_RUNNING && (pos - measured).norm() > 1e-3;
+        if(!checks){std::cout << "Closed loop projection failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class VerifyLimitsTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        int nWpts = 201;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, 0.1 * (nWpts - 1));
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(3, nWpts);
+        CubicSplineTrajectory traj(WaypointSet(times, coords));
+
+        // Dense sampling, the slow way.
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        Eigen::ArrayXXd sampledMax = Eigen::ArrayXXd::Zero(3, 3);
+        Eigen::VectorXd pos, vel, acc, velNext, accNext;
+        double dt = 1e-3;
+        for (double t = 0.0; t + dt < times(nWpts-1); t += dt) {
+            traj.getDesired(pos, vel, acc, t);
+            traj.getDesired(pos, velNext, accNext, t + dt);
+            sampledMax.row(0) = sampledMax.row(0).max(vel.array().abs().transpose());
+            sampledMax.row(1) = sampledMax.row(1).max(acc.array().abs().transpose());
+            sampledMax.row(2) = sampledMax.row(2).max(((accNext - acc) / dt).array().abs().transpose());
+        }
+        double samplingTime = std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+
+        // Limits half way to the peaks are violated on every DoF, with the exact peaks.
+        bool checks = true;
+        std::vector<TglLimitViolation> violations;
+        Eigen::VectorXd maxVel = 0.5 * sampledMax.row(0).transpose(), maxAcc = 0.5 * sampledMax.row(1).transpose(), maxJerk = 0.5 * sampledMax.row(2).transpose();
+        start = std::chrono::system_clock::now();
+        checks &= traj.verifyLimits(maxVel, maxAcc, maxJerk, violations) == TGL_WARNING;
+        double verificationTime = std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+        std::cout << "Sampling: " << samplingTime * 1e3 << " ms, verification: " << verificationTime * 1e3 << " ms." << std::endl;
+
+        checks &= violations.size() == 9;
+        for (const TglLimitViolation& violation : violations) {
+            // Exact peaks are never below the sampled ones and at most the sampling error above.
+            double peak = sampledMax(violation.derivative, violation.dof);
+            checks &= std::abs(violation.value) >= peak * (1.0 - 1e-9) && std::abs(violation.value) - peak < 1e-4 * peak;
+            traj.getDesired(pos, vel, acc, std::min(violation.time + 1e-12, times(nWpts-1) - 1e-12));
+            if (violation.derivative == TGL_VELOCITY) {
+                checks &= std::abs(vel(violation.dof) - violation.value) < 1e-6;
+            } else if (violation.derivative == TGL_ACCELERATION) {
+                checks &= std::abs(acc(violation.dof) - violation.value) < 1e-6;
+            }
+        }
+        for (std::size_t i = 1; i < violations.size(); ++i) {
+            checks &= std::abs(violations[i-1].value) / violations[i-1].limit >= std::abs(violations[i].value) / violations[i].limit;
+        }
+        if(!checks){std::cout << "Violations do not match sampling." << std::endl;}
+
+        // Generous limits pass, wrong sizes fail, empty limits are skipped.
+        checks &= traj.verifyLimits(4.0 * maxVel, 4.0 * maxAcc, Eigen::VectorXd(), violations) == TGL_OK && violations.empty();
+        checks &= traj.verifyLimits(maxVel.head(2), maxAcc, maxJerk, violations) == TGL_ERROR;
+        if(!checks){std::cout << "Limit checks failed." << std::endl;}
+
+        // A minimum snap trajectory (degree 7) needs the general root finding, check it against sampling too.
+        int nSnapWpts = 21;
+        MinimumSnapTrajectory snap(WaypointSet(times.head(nSnapWpts), coords.leftCols(nSnapWpts)));
+        sampledMax.setZero();
+        for (double t = 0.0; t + dt < times(nSnapWpts-1); t += dt) {
+            snap.getDesired(pos, vel, acc, t);
+            snap.getDesired(pos, velNext, accNext, t + dt);
+            sampledMax.row(0) = sampledMax.row(0).max(vel.array().abs().transpose());
+            sampledMax.row(1) = sampledMax.row(1).max(acc.array().abs().transpose());
+            sampledMax.row(2) = sampledMax.row(2).max(((accNext - acc) / dt).array().abs().transpose());
+        }
+        maxVel = 0.5 * sampledMax.row(0).transpose(); maxAcc = 0.5 * sampledMax.row(1).transpose(); maxJerk = 0.5 * sampledMax.row(2).transpose();
+        checks &= snap.verifyLimits(maxVel, maxAcc, maxJerk, violations) == TGL_WARNING && violations.size() == 9;
+        for (const TglLimitViolation& violation : violations) {
+            double peak = sampledMax(violation.derivative, violation.dof);
+            checks &= std::abs(violation.value) >= peak * (1.0 - 1e-9) && std::abs(violation.value) - peak < 1e-3 * peak;
+        }
+        checks &= snap.verifyLimits(4.0 * maxVel, 4.0 * maxAcc, 4.0 * maxJerk, violations) == TGL_OK && violations.empty();
+        if(!checks){std::cout << "Minimum snap limits do not match sampling." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class ArcLengthTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        // Unevenly timed waypoints, the spline speed varies a lot along the path.
+        Eigen::VectorXd times(5); times << 0.0, 0.2, 1.5, 1.8, 4.0;
+        Eigen::MatrixXd coords(3,5); coords << 0.0, 0.3, 1.0, 1.2, 2.0,
+                                               0.0, 0.5, 0.2, 0.9, 1.0,
+                                               0.0, 0.1, 0.0, -0.2, 0.0;
+        double speed = 0.25;
+        ArcLengthTrajectory traj(WaypointSet(times, coords), speed);
+        CubicSplineTrajectory spline(WaypointSet(times, coords));
+
+        // Reference length from a fine polyline.
+        bool checks = true;
+        Eigen::VectorXd pos, vel, acc, prevPos;
+        double polylineLength = 0.0;
+        spline.getDesired(prevPos, vel, acc, 0.0);
+        for (int i = 1; i <= 400000; ++i) {
+            spline.getDesired(pos, vel, acc, 4.0 * i / 400000.0);
+            polylineLength += (pos - prevPos).norm();
+            prevPos = pos;
+        }
+        checks &= std::abs(traj.getPathLength() - polylineLength) < 1e-8;
+        if(!checks){std::cout << "Path length " << traj.getPathLength() << " does not match " << polylineLength << std::endl;}
+
+        // Constant speed, consistent acceleration, ticking at 1 kHz.
+        double dt = 1e-3;
+        Eigen::VectorXd posNext, velNext, accNext;
+        for (double t = 0.01; t < traj.getDuration() - 0.01; t += dt) {
+            checks &= traj.getDesired(pos, vel, acc, t) == TGL_RUNNING;
+            traj.getDesired(posNext, velNext, accNext, t + 1e-6);
+            checks &= std::abs(vel.norm() - speed) < 1e-9;
+            checks &= std::abs((posNext - pos).norm() / 1e-6 - speed) < 1e-5;
+            checks &= ((velNext - vel) / 1e-6 - acc).norm() < 1e-3 * (1.0 + acc.norm());
+        }
+        if(!checks){std::cout << "Speed is not constant." << std::endl;}
+
+        checks &= traj.getDesired(pos, vel, acc, traj.getDuration() + dt) == TGL_FINISHED && (pos - coords.col(4)).norm() < 1e-12;
+        checks &= traj.getDesired(pos, vel, acc, -0.5) == TGL_START && (pos - coords.col(0)).norm() < 1e-12;
+        checks &= !traj.setSpeed(0.0);
+        if(!checks){std::cout << "Ends failed." << std::endl;}
+
+        // The table only depends on the shape of the path, not on its scale, and counts in the memory usage.
+        ArcLengthTrajectory scaled(WaypointSet(times, 1e6 * coords), speed);
+        checks &= std::abs(scaled.getPathLength() - 1e6 * traj.getPathLength()) < 1e-9 * scaled.getPathLength();
+        checks &= scaled.getMemoryUsage() < 1.1 * traj.getMemoryUsage() && traj.getMemoryUsage() > spline.getMemoryUsage();
+        if(!checks){std::cout << "Arc-length table depends on the path scale." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class MinimumSnapTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        Eigen::VectorXd pos, vel, acc;
+
+        // A single minimum jerk segment is the classic quintic 10 tau^3 - 15 tau^4 + 6 tau^5.
+        Eigen::VectorXd times(2); times << 1.0, 3.0;
+        Eigen::MatrixXd coords(1,2); coords << 0.0, 1.0;
+        MinimumSnapTrajectory minJerk(WaypointSet(times, coords), 3);
+        for (double tau = 0.1; tau < 1.0; tau += 0.1) {
+            minJerk.getDesired(pos, vel, acc, 1.0 + 2.0 * tau);
+            checks &= std::abs(pos(0) - tau*tau*tau * (10.0 - 15.0*tau + 6.0*tau*tau)) < 1e-10;
+        }
+        if(!checks){std::cout << "Minimum jerk segment failed." << std::endl;}
+
+        // Through many waypoints: interpolation, and the optimum is smoother than what is imposed (jerk continuous for r = 3).
+        int nWpts = 50;
+        times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, nWpts - 1.0);
+        times.tail(nWpts / 2).array() += 0.5 * Eigen::ArrayXd::LinSpaced(nWpts / 2, 0.0, 5.0);
+        coords = Eigen::MatrixXd::Random(3, nWpts);
+        MinimumSnapTrajectory jerkTraj(WaypointSet(times, coords), 3);
+        double h = 1e-5;
+        Eigen::VectorXd posL, velL, accL, posR, velR, accR, accLL, accRR;
+        for (int i = 1; i < nWpts - 1; ++i) {
+            jerkTraj.getDesired(pos, vel, acc, times(i));
+            checks &= (pos - coords.col(i)).norm() < 1e-9;
+            jerkTraj.getDesired(posL, velL, accL, times(i) - h);
+            jerkTraj.getDesired(posR, velR, accR, times(i) + h);
+            jerkTraj.getDesired(posL, velL, accLL, times(i) - 2.0 * h);
+            jerkTraj.getDesired(posR, velR, accRR, times(i) + 2.0 * h);
+            checks &= (velL - velR).norm() < 1e-3 && (accL - accR).norm() < 1e-3;
+            checks &= ((accL - accLL) / h - (accRR - accR) / h).norm() < 1e-2;
+        }
+        if(!checks){std::cout << "Minimum jerk continuity failed." << std::endl;}
+
+        // Giving the segment durations moves the knots.
+        Eigen::VectorXd durations = Eigen::VectorXd::Constant(nWpts - 1, 0.5);
+        checks &= jerkTraj.setWaypoints(WaypointSet(times, coords), durations);
+        jerkTraj.getDesired(pos, vel, acc, 0.5 * 7);
+        checks &= (pos - coords.col(7)).norm() < 1e-9 && std::isfinite(jerkTraj.getCost());
+        checks &= !jerkTraj.setWaypoints(WaypointSet(times, coords), durations.head(3));
+        if(!checks){std::cout << "Segment durations failed." << std::endl;}
+
+        // A long minimum snap trajectory is solved in linear time.
+        nWpts = 2001;
+        times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, 0.1 * (nWpts - 1.0));
+        coords = Eigen::MatrixXd::Random(3, nWpts);
+        std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+        MinimumSnapTrajectory snapTraj(WaypointSet(times, coords));
+        double solveTime = std::chrono::duration<double>(std::chrono::system_clock::now() - start).count();
+        std::cout << "Minimum snap with " << nWpts << " waypoints: " << solveTime * 1e3 << " ms." << std::endl;
+        for (int i = 0; i < nWpts; i += 100) {
+            snapTraj.getDesired(pos, vel, acc, times(i) + 1e-12);
+            checks &= (pos - coords.col(i)).norm() < 1e-8;
+        }
+        checks &= snapTraj.getDesired(pos, vel, acc, times(nWpts - 1) + 1.0) == TGL_FINISHED && (pos - coords.col(nWpts - 1)).norm() < 1e-8;
+        if(!checks){std::cout << "Long minimum snap failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class CoefficientCacheTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        char directoryTemplate[] = "/tmp/tgl_cache_XXXXXX";
+        if (!mkdtemp(directoryTemplate)) {
+            std::cout << "Could not create a temporary directory." << std::endl;
+            return TGL_TEST_FAILURE;
+        }
+        CoefficientCache cache(directoryTemplate);
+
+        int nWpts = 30;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, nWpts - 1.0);
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(3, nWpts);
+        WaypointSet wptSet(times, coords);
+
+        // Miss, then store, then hit with the same evaluation.
+        const uint64_t key = CoefficientCache::computeKey(wptSet, "MinimumSnapTrajectory/1", Eigen::VectorXd::Constant(1, 4.0));
+        StdDoubleVector knots;
+        Eigen::MatrixXd coefficients;
+        checks &= cache.load(key, knots, coefficients) == TGL_WARNING;
+        MinimumSnapTrajectory solved, loaded;
+        checks &= solved.setWaypoints(wptSet, cache) == TGL_OK;
+        checks &= cache.load(key, knots, coefficients) == TGL_OK && (int)knots.size() == nWpts;
+        checks &= loaded.setWaypoints(wptSet, cache) == TGL_OK;
+        checks &= std::abs(solved.getCost() - loaded.getCost()) < 1e-9 * solved.getCost();
+        Eigen::VectorXd pos, vel, acc, loadedPos, loadedVel, loadedAcc;
+        for (double t = 0.05; t < nWpts - 1.0; t += 0.7) {
+            solved.getDesired(pos, vel, acc, t);
+            loaded.getDesired(loadedPos, loadedVel, loadedAcc, t);
+            checks &= pos == loadedPos && vel == loadedVel && acc == loadedAcc;
+        }
+        if(!checks){std::cout << "Cache hit failed." << std::endl;}
+
+        // An entry whose knot times differ from the waypoint times, as after a key collision, is solved again.
+        StdDoubleVector shiftedKnots(knots);
+        shiftedKnots.back() += 1.0;
+        checks &= cache.store(key, shiftedKnots, coefficients) == TGL_OK;
+        checks &= loaded.setWaypoints(wptSet, cache) == TGL_OK;
+        checks &= std::abs(solved.getCost() - loaded.getCost()) < 1e-9 * solved.getCost();
+        checks &= cache.load(key, knots, coefficients) == TGL_OK && knots.back() == times(nWpts - 1);
+        if(!checks){std::cout << "Cache collision failed." << std::endl;}
+
+        // The generator parameters and the waypoints are part of the key.
+        checks &= key != CoefficientCache::computeKey(wptSet, "MinimumSnapTrajectory/1", Eigen::VectorXd::Constant(1, 3.0));
+        coords(1, 5) += 1e-12;
+        checks &= key != CoefficientCache::computeKey(WaypointSet(times, coords), "MinimumSnapTrajectory/1", Eigen::VectorXd::Constant(1, 4.0));
+        if(!checks){std::cout << "Cache keys failed." << std::endl;}
+
+        // A corrupted entry is a miss and is deleted.
+        std::size_t sizeOnDisk = cache.getSizeOnDisk();
+        char path[64];
+        std::snprintf(path, sizeof(path), "%s/%016llx.tglc", directoryTemplate, (unsigned long long)key);
+        FILE* file = std::fopen(path, "r+b");
+        checks &= file != NULL;
+        if (file) {
+            std::fseek(file, -3, SEEK_END);
+            std::fputc(0x55, file);
+            std::fclose(file);
+        }
+        checks &= cache.load(key, knots, coefficients) == TGL_WARNING && cache.getSizeOnDisk() == 0 && sizeOnDisk > 0;
+
+        // So is an entry whose sizes overflow: 2^32 x 2^32 coefficients wrap to a payload of only the knot times.
+        const double craftedKnots[4] = {0.0, 1.0, 2.0, 3.0};
+        uint64_t craftedHeader[7] = {0, 0, key, 4, 1ULL << 32, 1ULL << 32, TglTools::hashBytes(craftedKnots, sizeof(craftedKnots))};
+        const uint32_t craftedFormat[4] = {0, TGL_COEFFICIENT_CACHE_VERSION, 0x01020304, 0};
+        std::memcpy(craftedHeader, craftedFormat, sizeof(craftedFormat));
+        std::memcpy(craftedHeader, "TGLC", 4);
+        file = std::fopen(path, "wb");
+        checks &= file != NULL;
+        if (file) {
+            std::fwrite(craftedHeader, sizeof(craftedHeader), 1, file);
+            std::fwrite(craftedKnots, sizeof(craftedKnots), 1, file);
+            std::fclose(file);
+        }
+        checks &= cache.load(key, knots, coefficients) == TGL_WARNING && cache.getSizeOnDisk() == 0;
+        if(!checks){std::cout << "Corrupted entry failed." << std::endl;}
+
+        // A spline uses its own key, and a small budget evicts the least recently used entries.
+        CubicSplineTrajectory spline;
+        checks &= spline.setWaypoints(wptSet, cache) == TGL_OK;
+        const std::size_t entrySize = cache.getSizeOnDisk();
+        CoefficientCache smallCache(directoryTemplate, 2 * entrySize + entrySize / 2);
+        for (int i = 0; i < 4; ++i) {
+            // File times can be coarse, space the stores so the LRU order is well defined.
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            coords(0, 0) = i;
+            checks &= spline.setWaypoints(WaypointSet(times, coords), smallCache) == TGL_OK;
+            checks &= smallCache.getSizeOnDisk() <= 2 * entrySize + entrySize / 2;
+        }
+        checks &= smallCache.getSizeOnDisk() == 2 * entrySize;
+        checks &= smallCache.load(CoefficientCache::computeKey(WaypointSet(times, coords), "CubicSplineTrajectory/1"), knots, coefficients) == TGL_OK;
+        checks &= smallCache.load(CoefficientCache::computeKey(wptSet, "CubicSplineTrajectory/1"), knots, coefficients) == TGL_WARNING;
+        if(!checks){std::cout << "Cache eviction failed." << std::endl;}
+
+        smallCache.clear();
+        checks &= smallCache.getSizeOnDisk() == 0;
+        rmdir(directoryTemplate);
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class TrajectoryCacheTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        Eigen::VectorXd times(2); times << 0.0, 2.0;
+        Eigen::MatrixXd home(3,2); home << 0.0, 1.0,
+                                          0.0, 0.5,
+                                          0.0, -0.5;
+        Eigen::VectorXd limits(2); limits << 1.5, std::numeric_limits<double>::infinity();
+        int builds = 0;
+        auto builderFor = [&](const Eigen::MatrixXd& coords) {
+            return [&builds, &times, coords]() {
+                ++builds;
+                return TrajectoryPtr(std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords)));
+            };
+        };
+
+        // Near-identical requests share the entry, a different goal, generator or limit does not.
+        TrajectoryCache cache(1024 * 1024, 1e-6);
+        const uint64_t key = cache.computeKey(WaypointSet(times, home), "CubicSplineTrajectory", limits);
+        Eigen::MatrixXd nearHome = home;
+        nearHome(1, 1) += 1e-9;
+        checks &= cache.computeKey(WaypointSet(times, nearHome), "CubicSplineTrajectory", limits) == key;
+        Eigen::MatrixXd pick = home;
+        pick(1, 1) += 1e-3;
+        checks &= cache.computeKey(WaypointSet(times, pick), "CubicSplineTrajectory", limits) != key;
+        checks &= cache.computeKey(WaypointSet(times, home), "MinimumSnapTrajectory", limits) != key;
+        checks &= cache.computeKey(WaypointSet(times, home), "CubicSplineTrajectory", 2.0 * limits) != key;
+        if(!checks){std::cout << "Quantized keys failed." << std::endl;}
+
+        TrajectoryCache::CachedTrajectory first = cache.getOrBuild(key, builderFor(home));
+        TrajectoryCache::CachedTrajectory second = cache.getOrBuild(cache.computeKey(WaypointSet(times, nearHome), "CubicSplineTrajectory", limits), builderFor(nearHome));
+        checks &= first.core && first.core == second.core && first.waypoints == second.waypoints && builds == 1;
+        checks &= first.waypoints && first.waypoints->asMatrixView() == home;
+        const std::size_t entryBytes = CubicSplineTrajectory(WaypointSet(times, home)).getMemoryUsage();
+        TrajectoryCache::Statistics statistics = cache.getStatistics();
+        checks &= statistics.hits == 1 && statistics.misses == 1 && statistics.entries == 1 && statistics.bytes == entryBytes;
+        checks &= !cache.find(cache.computeKey(WaypointSet(times, pick), "CubicSplineTrajectory", limits)).core;
+        if(!checks){std::cout << "Cache hits failed." << std::endl;}
+
+        // Each caller gets its own evaluator, sampling through one does not move the cursor or the clock of another.
+        Eigen::VectorXd pos, vel, acc, otherPos, otherVel, otherAcc;
+        checks &= first.evaluator.getCore() == first.core && second.evaluator.getCore() == first.core;
+        checks &= first.evaluator.getDesired(pos, vel, acc, 1.9) == TGL_RUNNING;
+        checks &= second.evaluator.getDesired(otherPos, otherVel, otherAcc, 0.1) == TGL_RUNNING;
+        checks &= first.evaluator.getDesired(pos, vel, acc, 2.5) == TGL_FINISHED && pos == home.col(1);
+        checks &= second.evaluator.getDesired(otherPos, otherVel, otherAcc, 0.2) == TGL_RUNNING;
+        if(!checks){std::cout << "Cache evaluators failed." << std::endl;}
+
+        // The budget evicts the least recently used entry.
+        TrajectoryCache smallCache(entryBytes * 2 + 1, 1e-6);
+        Eigen::MatrixXd goals = Eigen::MatrixXd::Random(3, 3);
+        std::vector<uint64_t> keys;
+        for (int i = 0; i < 3; ++i) {
+            Eigen::MatrixXd coords = home;
+            coords.col(1) = goals.col(i);
+            keys.push_back(smallCache.computeKey(WaypointSet(times, coords), "CubicSplineTrajectory"));
+            smallCache.getOrBuild(keys.back(), builderFor(coords));
+            if (i == 1) {
+                checks &= !!smallCache.find(keys[0]).core;
+            }
+        }
+        checks &= smallCache.find(keys[0]).core && !smallCache.find(keys[1]).core && smallCache.find(keys[2]).core;
+        checks &= smallCache.getStatistics().evictions == 1 && smallCache.getStatistics().entries == 2;
+        if(!checks){std::cout << "Cache eviction failed." << std::endl;}
+
+        // Many threads asking for the same few moves share them.
+        builds = 0;
+        std::vector<std::thread> threads;
+        std::vector<TrajectoryCorePtr> results(8);
+        TrajectoryCache sharedCache;
+        const uint64_t homeKey = sharedCache.computeKey(WaypointSet(times, home), "CubicSplineTrajectory");
+        sharedCache.getOrBuild(homeKey, builderFor(home));
+        for (int i = 0; i < 8; ++i) {
+            threads.push_back(std::thread([&, i]() {
+                Eigen::VectorXd threadPos, threadVel, threadAcc;
+                for (int j = 0; j < 100; ++j) {
+                    TrajectoryCache::CachedTrajectory cached = sharedCache.getOrBuild(homeKey, builderFor(home));
+                    cached.evaluator.getDesired(threadPos, threadVel, threadAcc, 0.02 * j);
+                    results[i] = cached.core;
+                }
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (int i = 0; i < 8; ++i) {
+            checks &= results[i] == results[0];
+        }
+        checks &= builds == 1 && sharedCache.getStatistics().hits == 800;
+        if(!checks){std::cout << "Concurrent cache hits failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class TrajectoryEvaluatorTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        int nWpts = 40;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, nWpts - 1.0);
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(7, nWpts);
+        CubicSplineTrajectory spline(WaypointSet(times, coords));
+        MinimumSnapTrajectory snap(WaypointSet(times, coords));
+
+        // Evaluators give what the trajectories give.
+        Eigen::VectorXd pos, vel, acc, corePos, coreVel, coreAcc;
+        TrajectoryEvaluator splineEvaluator(spline.getCore()), snapEvaluator(snap.getCore());
+        for (double t = -0.5; t < nWpts; t += 0.37) {
+            checks &= spline.getDesired(pos, vel, acc, t) == splineEvaluator.getDesired(corePos, coreVel, coreAcc, t);
+            checks &= pos == corePos && vel == coreVel && acc == coreAcc;
+            checks &= snap.getDesired(pos, vel, acc, t) == snapEvaluator.getDesired(corePos, coreVel, coreAcc, t);
+            checks &= pos == corePos && vel == coreVel && acc == coreAcc;
+        }
+        checks &= !Trajectory().getCore();
+        if(!checks){std::cout << "Evaluator values failed." << std::endl;}
+
+        // Evaluators are cache line aligned, also when allocated.
+        std::unique_ptr<TrajectoryEvaluator> allocated(new TrajectoryEvaluator(spline.getCore()));
+        checks &= sizeof(TrajectoryEvaluator) % TGL_CACHE_LINE_SIZE == 0;
+        checks &= reinterpret_cast<std::uintptr_t>(allocated.get()) % TGL_CACHE_LINE_SIZE == 0;
+        if(!checks){std::cout << "Evaluator alignment failed." << std::endl;}
+
+        // Many threads sample the same core, which outlives a rebuild of its trajectory.
+        TrajectoryCorePtr core = spline.getCore();
+        Eigen::MatrixXd expected(7, 1000);
+        for (int k = 0; k < 1000; ++k) {
+            spline.getDesired(pos, vel, acc, 0.039 * k);
+            expected.col(k) = pos;
+        }
+        spline.setWaypoints(WaypointSet(times, 2.0 * coords));
+        std::vector<std::thread> threads;
+        std::vector<int> matches(4, 0);
+        for (int i = 0; i < 4; ++i) {
+            threads.push_back(std::thread([&, i]() {
+                TrajectoryEvaluator evaluator(core);
+                Eigen::VectorXd p, v, a;
+                for (int k = 0; k < 1000; ++k) {
+                    evaluator.getDesired(p, v, a, 0.039 * k);
+                    matches[i] += p == expected.col(k);
+                }
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        for (int i = 0; i < 4; ++i) {
+            checks &= matches[i] == 1000;
+        }
+        checks &= spline.getCore() != core;
+        if(!checks){std::cout << "Concurrent evaluators failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class AsyncBuildTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(30, 0.0, 29.0);
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(3, 30);
+        TrajectoryExecutor executor(1);
+        int readyCalls = 0;
+        TrajectoryPtr readyTrajectory;
+
+        // A build runs in the background and becomes the latest trajectory.
+        AsyncTrajectoryBuilder builder(executor);
+        checks &= !builder.getLatest();
+        std::shared_future<TrajectoryPtr> first = builder.submit(std::make_shared<CubicSplineTrajectory>(), WaypointSet(times, coords),
+                                                                 [&](TrajectoryPtr traj) { ++readyCalls; readyTrajectory = traj; });
+        checks &= first.get() && first.get() == builder.getLatest();
+        builder.wait();
+        checks &= readyCalls == 1 && readyTrajectory == first.get() && !builder.isBuilding();
+        if(!checks){std::cout << "Asynchronous build failed." << std::endl;}
+
+        // While a slow build runs, newer requests supersede it and each other: only the newest one lands.
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::shared_future<TrajectoryPtr> slow = builder.submit([&, released]() {
+            released.wait();
+            return TrajectoryPtr(std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords)));
+        }, [&](TrajectoryPtr) { ++readyCalls; });
+        std::shared_future<TrajectoryPtr> skipped = builder.submit(std::make_shared<CubicSplineTrajectory>(), WaypointSet(times, 2.0 * coords),
+                                                                   [&](TrajectoryPtr) { ++readyCalls; });
+        std::shared_future<TrajectoryPtr> newest = builder.submit(std::make_shared<CubicSplineTrajectory>(), WaypointSet(times, 3.0 * coords));
+        checks &= builder.isBuilding() && builder.getLatest() == first.get();
+        release.set_value();
+        checks &= !slow.get() && !skipped.get() && newest.get() && builder.getLatest() == newest.get();
+        builder.wait();
+        checks &= readyCalls == 1;
+        if(!checks){std::cout << "Superseded builds failed." << std::endl;}
+
+        // Cancel drops what is pending, failures resolve to null and keep the latest trajectory.
+        std::promise<void> releaseAgain;
+        std::shared_future<void> releasedAgain = releaseAgain.get_future().share();
+        std::shared_future<TrajectoryPtr> cancelled = builder.submit([releasedAgain]() {
+            releasedAgain.wait();
+            return TrajectoryPtr(std::make_shared<CubicSplineTrajectory>());
+        });
+        builder.cancel();
+        releaseAgain.set_value();
+        checks &= !cancelled.get();
+        std::shared_future<TrajectoryPtr> failed = builder.submit(std::make_shared<CubicSplineTrajectory>(), WaypointSet());
+        checks &= !failed.get() && builder.getLatest() == newest.get();
+        if(!checks){std::cout << "Cancelled builds failed." << std::endl;}
+
+        // The latest trajectory is never rebuilt in place, and a build or a callback throwing anything still ends.
+        checks &= !builder.submit(newest.get(), WaypointSet(times, 4.0 * coords)).get() && builder.getLatest() == newest.get();
+        std::shared_future<TrajectoryPtr> thrown = builder.submit([]() -> TrajectoryPtr { throw 42; });
+        checks &= !thrown.get();
+        builder.wait();
+        checks &= !builder.isBuilding() && builder.getLatest() == newest.get();
+        checks &= builder.submit(std::make_shared<CubicSplineTrajectory>(), WaypointSet(times, 5.0 * coords),
+                                 [](TrajectoryPtr) { throw std::runtime_error("callback"); }).get() != nullptr;
+        std::shared_future<TrajectoryPtr> callbackThrown = builder.submit(std::make_shared<CubicSplineTrajectory>(), WaypointSet(times, 6.0 * coords),
+                                                                          [](TrajectoryPtr) { throw 42; });
+        builder.wait();
+        checks &= callbackThrown.get() && !builder.isBuilding() && builder.getLatest() == callbackThrown.get();
+        if(!checks){std::cout << "Rejected builds failed." << std::endl;}
+
+        checks &= TrajectoryExecutor::getDefault().getNumberOfThreads() >= 1;
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class SampleRangeTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        int nWpts = 20;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, nWpts - 1.0);
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(4, nWpts);
+        CubicSplineTrajectory spline(WaypointSet(times, coords));
+        CubicSplineTrajectory reference(WaypointSet(times, coords));
+
+        // The samples are those of getDesired() on the time grid, end included.
+        Eigen::VectorXd pos, vel, acc;
+        long count = 0;
+        const double* buffer = NULL;
+        SampleRange range = spline.samples(0.01, 0.0, nWpts - 1.0);
+        for (const TrajectorySample& s : range) {
+            TglMessage status = reference.getDesired(pos, vel, acc, 0.01 * count);
+            checks &= s.time == 0.01 * count && s.status == status;
+            checks &= s.position == pos && s.velocity == vel && s.acceleration == acc;
+            // The buffer is reused, not reallocated.
+            checks &= buffer == NULL || buffer == s.position.data();
+            buffer = s.position.data();
+            ++count;
+        }
+        checks &= count == range.size() && count == 100 * (nWpts - 1) + 1;
+        if(!checks){std::cout << "Sample range failed." << std::endl;}
+
+        // Evaluators give ranges too, and empty ranges are empty.
+        TrajectoryEvaluator evaluator(spline.getCore());
+        SampleRange evaluatorRange = evaluator.samples(0.25, 1.0, 2.0);
+        SampleRange::Iterator it = evaluatorRange.begin();
+        checks &= it->time == 1.0 && evaluatorRange.size() == 5;
+        for (int k = 0; k < 4; ++k) {
+            ++it;
+        }
+        reference.getDesired(pos, vel, acc, 2.0);
+        checks &= it->time == 2.0 && it->position == pos && ++it == evaluatorRange.end();
+        checks &= spline.samples(0.1, 2.0, 1.0).size() == 0;
+        SampleRange empty = spline.samples(0.0, 0.0, 1.0);
+        checks &= empty.begin() == empty.end();
+        if(!checks){std::cout << "Evaluator sample range failed." << std::endl;}
+
+        // A grid time of exactly -1 is sampled at -1, before the start, not on the internal clock. Post-increment gives the previous sample.
+        SampleRange earlyRange = spline.samples(0.5, -2.0, 0.0);
+        SampleRange::Iterator earlyIt = earlyRange.begin();
+        const TrajectorySample previous = *earlyIt++;
+        checks &= previous.time == -2.0 && earlyIt->time == -1.5;
+        ++earlyIt;
+        checks &= earlyIt->time == -1.0 && earlyIt->status == TGL_START && earlyIt->position == coords.col(0) && earlyIt->velocity.isZero();
+        if(!checks){std::cout << "Sample range at -1 failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class PolynomialKernelTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        int nWpts = 1001;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, nWpts - 1.0);
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(7, nWpts);
+        CubicSplineTrajectory spline(WaypointSet(times, coords));
+        MinimumSnapTrajectory snap(WaypointSet(times, coords));
+        Trajectory* trajectories[2] = {&spline, &snap};
+        const char* names[2] = {"Cubic spline", "Minimum snap"};
+        const double tolerances[2][3] = {{2e-6, 1e-5, 5e-5}, {2e-6, 2e-5, 2e-4}};
+
+        // Float against double on the same polynomials. The maximum errors are those documented in PolynomialKernel.hpp.
+        for (int i = 0; i < 2; ++i) {
+            std::shared_ptr<const PiecewisePolynomial> core = std::dynamic_pointer_cast<const PiecewisePolynomial>(trajectories[i]->getCore());
+            checks &= core != nullptr;
+            if (!core) {
+                continue;
+            }
+            PolynomialKernelf kernelf(*core);
+            PolynomialKerneld kerneld(*core);
+            checks &= kernelf.getMemoryUsage() < kerneld.getMemoryUsage() && kernelf.getDimension() == 7;
+            Eigen::VectorXd pos, vel, acc, posd, veld, accd;
+            Eigen::VectorXf posf, velf, accf;
+            Eigen::Array3d maxError = Eigen::Array3d::Zero();
+            int cursor = 0, cursorf = 0, cursord = 0;
+            for (double t = 0.0013; t < nWpts - 1.0; t += 0.0977) {
+                TglMessage status = core->evaluate(pos, vel, acc, t, cursor);
+                checks &= kerneld.evaluate(posd, veld, accd, t, cursord) == status && kernelf.evaluate(posf, velf, accf, t, cursorf) == status;
+                checks &= (posd - pos).norm() < 1e-12 && (veld - vel).norm() < 1e-12 && (accd - acc).norm() < 1e-12;
+                maxError = maxError.max(Eigen::Array3d((posf.cast<double>() - pos).cwiseAbs().maxCoeff(),
+                                                       (velf.cast<double>() - vel).cwiseAbs().maxCoeff(),
+                                                       (accf.cast<double>() - acc).cwiseAbs().maxCoeff()));
+            }
+            std::cout << names[i] << " float error: position " << maxError(0) << ", velocity " << maxError(1) << ", acceleration " << maxError(2) << std::endl;
+            checks &= maxError(0) < tolerances[i][0] && maxError(1) < tolerances[i][1] && maxError(2) < tolerances[i][2];
+
+            // Lookup tables.
+            Eigen::MatrixXf table(7, 101);
+            kernelf.samplePositions(10.0, 0.01, table);
+            core->evaluate(pos, vel, acc, 10.5, cursor);
+            checks &= (table.col(50).cast<double>() - pos).norm() < 1e-5;
+        }
+        if(!checks){std::cout << "Float kernels failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class SplineFitTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+
+        // A dense noisy recording, big enough for the parallel accumulation.
+        int n = 300000;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(n, 0.0, 10.0);
+        Eigen::MatrixXd truth(2, n);
+        truth.row(0) = times.array().sin().matrix().transpose();
+        truth.row(1) = (0.5 * times.array()).cos().matrix().transpose();
+        Eigen::MatrixXd samples = truth + 0.01 * Eigen::MatrixXd::Random(2, n);
+
+        SplineFitter fitter(0.0, 10.0, 50, 2, 1e-6);
+        std::size_t emptyMemory = fitter.getMemoryUsage();
+        checks &= fitter.addSamples(times, samples) == TGL_OK;
+        checks &= fitter.getNumberOfSamples() == n && fitter.getMemoryUsage() == emptyMemory;
+        std::shared_ptr<const PiecewisePolynomial> core;
+        checks &= fitter.solve(core) == TGL_OK && core->getOrder() == 4 && core->getKnotTimes().size() == 51;
+        double maxError = 0.0;
+        Eigen::VectorXd pos, vel, acc;
+        int cursor = 0;
+        for (int i = 0; i < n; i += 97) {
+            core->evaluate(pos, vel, acc, times(i), cursor);
+            maxError = std::max(maxError, (pos - truth.col(i)).cwiseAbs().maxCoeff());
+        }
+        checks &= maxError < 2e-3;
+        if(!checks){std::cout << "Spline fit failed, max error " << maxError << "." << std::endl;}
+
+        // The same samples from a WaypointSet and from a text stream give the same spline.
+        SplineFitter wptFitter(0.0, 10.0, 50, 2, 1e-6), streamFitter(0.0, 10.0, 50, 2, 1e-6), serialFitter(0.0, 10.0, 50, 2, 1e-6);
+        int nSmall = 5000;
+        checks &= wptFitter.addSamples(WaypointSet(times.head(nSmall), samples.leftCols(nSmall))) == TGL_OK;
+        std::stringstream stream;
+        stream.precision(17);
+        stream << "# t x y\n";
+        for (int i = 0; i < nSmall; ++i) {
+            stream << times(i) << " " << samples(0, i) << "\t" << samples(1, i) << "\n";
+            serialFitter.addSample(times(i), samples.col(i));
+        }
+        checks &= streamFitter.addSamples(stream) == TGL_OK && streamFitter.getNumberOfSamples() == nSmall;
+        std::shared_ptr<const PiecewisePolynomial> wptCore, streamCore, serialCore;
+        checks &= wptFitter.solve(wptCore) == TGL_OK && streamFitter.solve(streamCore) == TGL_OK && serialFitter.solve(serialCore) == TGL_OK;
+        checks &= (wptCore->getCoefficients() - serialCore->getCoefficients()).norm() < 1e-9 * serialCore->getCoefficients().norm();
+        checks &= (streamCore->getCoefficients() - serialCore->getCoefficients()).norm() < 1e-9 * serialCore->getCoefficients().norm();
+        if(!checks){std::cout << "Spline fit inputs failed." << std::endl;}
+
+        // Samples outside of the spline are rejected, and segments without samples need smoothing.
+        checks &= serialFitter.addSample(11.0, samples.col(0)) == TGL_ERROR;
+        checks &= serialFitter.addSamples(times.tail(3) * 2.0, samples.rightCols(3)) == TGL_WARNING;
+        SplineFitter sparseFitter(0.0, 10.0, 50, 2);
+        sparseFitter.addSamples(times.head(n / 2), samples.leftCols(n / 2));
+        checks &= sparseFitter.solve(core) == TGL_ERROR;
+        sparseFitter.reset(0.0, 10.0, 50, 2, 1e-3);
+        sparseFitter.addSamples(times.head(n / 2), samples.leftCols(n / 2));
+        checks &= sparseFitter.solve(core) == TGL_OK;
+        std::stringstream badStream("0.0 1.0\n");
+        checks &= sparseFitter.addSamples(badStream) == TGL_ERROR;
+        if(!checks){std::cout << "Spline fit validation failed." << std::endl;}
+
+        // The fitted spline drives a CubicSplineTrajectory.
+        CubicSplineTrajectory traj;
+        checks &= fitter.solve(traj) == TGL_OK && traj.getDimension() == 2;
+        Eigen::VectorXd trajPos, trajVel, trajAcc;
+        checks &= traj.getDesired(trajPos, trajVel, trajAcc, 3.3) == TGL_RUNNING;
+        cursor = 0;
+        fitter.solve(core);
+        core->evaluate(pos, vel, acc, 3.3, cursor);
+        checks &= (trajPos - pos).norm() < 1e-12 && (trajVel - vel).norm() < 1e-12;
+        double closestTime, distance;
+        checks &= traj.getClosestTime(pos, closestTime, distance) == TGL_OK && std::abs(closestTime - 3.3) < 1e-6;
+        checks &= traj.setCore(std::make_shared<PiecewisePolynomial>()) == TGL_ERROR;
+        if(!checks){std::cout << "Fitted spline trajectory failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class DmpTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+
+        // A demonstration with a bump, over [1, 3].
+        int n = 2001;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(n, 1.0, 3.0);
+        Eigen::ArrayXd u = (times.array() - 1.0) / 2.0;
+        Eigen::ArrayXd minJerk = u.cube() * (10.0 - 15.0 * u + 6.0 * u.square());
+        Eigen::MatrixXd demo(2, n);
+        demo.row(0) = (minJerk + 0.3 * (M_PI * u).sin()).matrix().transpose();
+        demo.row(1) = (-0.5 * minJerk).matrix().transpose() + Eigen::RowVectorXd::Constant(n, 0.2);
+        DmpTrajectory dmp(WaypointSet(times, demo), 50);
+        checks &= dmp.getDimension() == 2 && dmp.getWeights().cols() == 50 && std::abs(dmp.getDuration() - 2.0) < 1e-12;
+
+        // Reproduction.
+        Eigen::VectorXd pos, vel, acc;
+        double maxError = 0.0;
+        for (int i = 0; i < n; i += 10) {
+            checks &= dmp.getDesired(pos, vel, acc, times(i)) == (i == n - 1 ? TGL_FINISHED : TGL_RUNNING);
+            maxError = std::max(maxError, (pos - demo.col(i)).norm());
+        }
+        checks &= maxError < 2e-3;
+        checks &= dmp.getDesired(pos, vel, acc, 0.5) == TGL_START && pos == demo.col(0);
+        if(!checks){std::cout << "DMP reproduction failed, max error " << maxError << "." << std::endl;}
+
+        // A goal change in the middle of the motion bends it without a jump.
+        Eigen::VectorXd newGoal(2); newGoal << -1.0, 1.0;
+        Eigen::VectorXd before, after;
+        dmp.getDesired(before, vel, acc, 2.0);
+        checks &= dmp.setGoal(newGoal) == TGL_OK;
+        dmp.getDesired(after, vel, acc, 2.001);
+        checks &= (after - before).norm() < 0.01;
+        dmp.getDesired(pos, vel, acc, 5.0);
+        checks &= (pos - newGoal).norm() < 0.02 && (dmp.getGoal() - newGoal).norm() == 0.0;
+        checks &= dmp.setGoal(Eigen::VectorXd::Zero(3)) == TGL_ERROR;
+        if(!checks){std::cout << "DMP goal change failed." << std::endl;}
+
+        // A longer duration slows the motion down.
+        checks &= dmp.setDuration(4.0) == TGL_OK && dmp.setDuration(-1.0) == TGL_ERROR;
+        checks &= dmp.getDesired(pos, vel, acc, 3.0) == TGL_RUNNING && (pos - newGoal).norm() > 0.1;
+        checks &= dmp.getDesired(pos, vel, acc, 5.0) == TGL_FINISHED && (pos - newGoal).norm() < 0.05;
+        dmp.setDuration(2.0);
+        if(!checks){std::cout << "DMP duration change failed." << std::endl;}
+
+        // Batch rollout, identical to the online rollout for the same goal.
+        int nGoals = 16;
+        Eigen::MatrixXd goals = Eigen::MatrixXd::Random(2, nGoals);
+        std::vector<Eigen::MatrixXd> rollouts;
+        checks &= dmp.rollout(goals, 0.01, rollouts) == TGL_OK && (int)rollouts.size() == nGoals;
+        for (int j = 0; j < nGoals; ++j) {
+            checks &= rollouts[j].cols() == 201 && (rollouts[j].col(200) - goals.col(j)).norm() < 0.05;
+        }
+        dmp.setGoal(goals.col(3));
+        dmp.getDesired(pos, vel, acc, 0.5);
+        double maxDifference = 0.0;
+        for (int k = 0; k < 201; ++k) {
+            dmp.getDesired(pos, vel, acc, 1.0 + k * 0.01);
+            maxDifference = std::max(maxDifference, (pos - rollouts[3].col(k)).norm());
+        }
+        checks &= maxDifference < 1e-12;
+        checks &= dmp.rollout(Eigen::MatrixXd::Zero(3, 2), 0.01, rollouts) == TGL_ERROR;
+        if(!checks){std::cout << "DMP batch rollout failed, max difference " << maxDifference << "." << std::endl;}
+
+        DmpTrajectory empty;
+        checks &= empty.setWaypoints(WaypointSet(times.head(2), demo.leftCols(2))) == TGL_ERROR;
+        checks &= empty.getDesired(pos, vel, acc, 1.0) == TGL_ERROR;
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class PiecewisePolynomialTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        int nWpts = 201;
+        Eigen::VectorXd uniformTimes = Eigen::VectorXd::LinSpaced(nWpts, 0.3, 20.3);
+        Eigen::VectorXd randomTimes = uniformTimes;
+        for (int i = 1; i < nWpts - 1; ++i) {
+            randomTimes(i) += 0.03 * std::sin(7.0 * i);
+        }
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(3, nWpts);
+        MinimumSnapTrajectory snap(WaypointSet(randomTimes, coords));
+        CubicSplineTrajectory spline(WaypointSet(uniformTimes, coords));
+        std::shared_ptr<const PiecewisePolynomial> snapPoly = std::dynamic_pointer_cast<const PiecewisePolynomial>(snap.getCore());
+        std::shared_ptr<const PiecewisePolynomial> splinePoly = std::dynamic_pointer_cast<const PiecewisePolynomial>(spline.getCore());
+        checks &= snapPoly && splinePoly && snapPoly->getNumberOfSegments() == nWpts - 1 && snapPoly->getOrder() == 8;
+        if (!checks) {
+            return TGL_TEST_FAILURE;
+        }
+
+        // The segment lookup agrees with the general search, with and without uniform knots.
+        for (int k = 0; k < 2000; ++k) {
+            double t = -1.0 + 23.0 * k / 1999.0;
+            if (k % 10 == 0) {
+                t = uniformTimes(k / 10 % nWpts);
+            }
+            int cursor = (k * 37) % nWpts, referenceCursor = cursor;
+            checks &= splinePoly->findSegment(t, cursor) == TrajectoryCore::findSegment(splinePoly->getKnotTimes(), t, referenceCursor);
+            cursor = (k * 37) % nWpts; referenceCursor = cursor;
+            checks &= snapPoly->findSegment(t, cursor) == TrajectoryCore::findSegment(snapPoly->getKnotTimes(), t, referenceCursor);
+        }
+        if(!checks){std::cout << "Segment lookup failed." << std::endl;}
+
+        // Slices evaluate like the original over their window, with knots or arbitrary times at their ends.
+        const double windows[3][2] = {{1.234, 7.777}, {uniformTimes(10), uniformTimes(20)}, {5.01, 5.02}};
+        for (int w = 0; w < 3; ++w) {
+            std::shared_ptr<const PiecewisePolynomial> slice;
+            checks &= snapPoly->slice(windows[w][0], windows[w][1], slice) == TGL_OK;
+            checks &= slice->getStartTime() == windows[w][0] && slice->getEndTime() == windows[w][1];
+            Eigen::VectorXd pos, vel, acc, slicePos, sliceVel, sliceAcc;
+            int cursor = 0, sliceCursor = 0;
+            for (double t = windows[w][0]; t < windows[w][1]; t += (windows[w][1] - windows[w][0]) / 97.0) {
+                snapPoly->evaluate(pos, vel, acc, t, cursor);
+                checks &= slice->evaluate(slicePos, sliceVel, sliceAcc, t, sliceCursor) == TGL_RUNNING;
+                checks &= (slicePos - pos).norm() < 1e-9 && (sliceVel - vel).norm() < 1e-8 && (sliceAcc - acc).norm() < 1e-6;
+            }
+        }
+        std::shared_ptr<const PiecewisePolynomial> badSlice;
+        checks &= snapPoly->slice(5.0, 4.0, badSlice) == TGL_ERROR && snapPoly->slice(0.0, 4.0, badSlice) == TGL_ERROR;
+        if(!checks){std::cout << "Polynomial slice failed." << std::endl;}
+
+        // Serialization round trip, and corrupt or truncated data is rejected.
+        std::stringstream stream;
+        checks &= snapPoly->serialize(stream) == TGL_OK;
+        std::string bytes = stream.str();
+        std::shared_ptr<const PiecewisePolynomial> readPoly;
+        checks &= PiecewisePolynomial::deserialize(stream, readPoly) == TGL_OK;
+        checks &= readPoly->getKnotTimes() == snapPoly->getKnotTimes() && readPoly->getCoefficients() == snapPoly->getCoefficients() && readPoly->getOrder() == 8;
+        std::string corrupt = bytes;
+        corrupt[bytes.size() / 2] ^= 0x10;
+        std::stringstream corruptStream(corrupt), truncatedStream(bytes.substr(0, bytes.size() - 8));
+        checks &= PiecewisePolynomial::deserialize(corruptStream, readPoly) == TGL_ERROR;
+        checks &= PiecewisePolynomial::deserialize(truncatedStream, readPoly) == TGL_ERROR;
+        checks &= PiecewisePolynomial().serialize(stream) == TGL_ERROR;
+        // Headers asking for a huge order or more data than the stream holds are rejected before allocating.
+        std::string hugeOrder = bytes, hugeKnots = bytes, missingData = bytes;
+        const uint32_t order = 1000;
+        const uint64_t nKnots[2] = {1ULL << 40, 1000000};
+        std::memcpy(&hugeOrder[12], &order, sizeof(order));
+        std::memcpy(&hugeKnots[16], &nKnots[0], sizeof(nKnots[0]));
+        std::memcpy(&missingData[16], &nKnots[1], sizeof(nKnots[1]));
+        std::stringstream hugeOrderStream(hugeOrder), hugeKnotsStream(hugeKnots), missingDataStream(missingData);
+        checks &= PiecewisePolynomial::deserialize(hugeOrderStream, readPoly) == TGL_ERROR;
+        checks &= PiecewisePolynomial::deserialize(hugeKnotsStream, readPoly) == TGL_ERROR;
+        checks &= PiecewisePolynomial::deserialize(missingDataStream, readPoly) == TGL_ERROR;
+        if(!checks){std::cout << "Serialization failed." << std::endl;}
+
+        // A slice backs a PolynomialTrajectory.
+        std::shared_ptr<const PiecewisePolynomial> slice;
+        snapPoly->slice(2.5, 6.5, slice);
+        PolynomialTrajectory traj(slice);
+        Eigen::VectorXd pos, vel, acc, trajPos, trajVel, trajAcc;
+        int cursor = 0;
+        checks &= traj.getDimension() == 3 && traj.getCore() == slice;
+        checks &= traj.getDesired(trajPos, trajVel, trajAcc, 4.0) == TGL_RUNNING && traj.getDesired(trajPos, trajVel, trajAcc, 7.0) == TGL_FINISHED;
+        traj.getDesired(trajPos, trajVel, trajAcc, 4.0);
+        snapPoly->evaluate(pos, vel, acc, 4.0, cursor);
+        checks &= (trajPos - pos).norm() < 1e-9;
+        checks &= traj.setWaypoints(WaypointSet(uniformTimes, coords)) == TGL_ERROR && traj.setPolynomial(nullptr) == TGL_ERROR;
+        if(!checks){std::cout << "Polynomial trajectory failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class PolySegmentTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        int nWpts = 101;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 1.0, 51.0);
+        Eigen::MatrixXd coords7 = Eigen::MatrixXd::Random(7, nWpts), coords9 = Eigen::MatrixXd::Random(9, nWpts);
+
+        // Unrolled kernels for the cubic, quintic and degree 7 orders, and the generic loop for 9 DoF and order 10.
+        std::vector<TrajectoryPtr> trajectories;
+        trajectories.push_back(std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords7)));
+        trajectories.push_back(std::make_shared<MinimumSnapTrajectory>(WaypointSet(times, coords7), 3));
+        trajectories.push_back(std::make_shared<MinimumSnapTrajectory>(WaypointSet(times, coords7.topRows(2)), 4));
+        trajectories.push_back(std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords9)));
+        trajectories.push_back(std::make_shared<MinimumSnapTrajectory>(WaypointSet(times, coords7), 5));
+
+        int nSamples = 5000;
+        Eigen::VectorXd sampleTimes = Eigen::VectorXd::LinSpaced(nSamples, -1.0, 53.0);
+        for (int i = 0; i < nWpts - 1; i += 10) {
+            sampleTimes(50 * i) = times(i);
+        }
+        std::sort(sampleTimes.data(), sampleTimes.data() + nSamples);
+        for (auto& trajectory : trajectories) {
+            std::shared_ptr<const PiecewisePolynomial> poly = std::dynamic_pointer_cast<const PiecewisePolynomial>(trajectory->getCore());
+            Eigen::MatrixXd positions, velocities, accelerations;
+            checks &= poly->evaluateSorted(sampleTimes, positions, velocities, accelerations) == TGL_OK;
+            Eigen::VectorXd pos, vel, acc;
+            int cursor = 0;
+            double maxError = 0.0;
+            for (int i = 0; i < nSamples; ++i) {
+                poly->evaluate(pos, vel, acc, sampleTimes(i), cursor);
+                maxError = std::max(maxError, (positions.col(i) - pos).cwiseAbs().maxCoeff());
+                maxError = std::max(maxError, (velocities.col(i) - vel).cwiseAbs().maxCoeff());
+                maxError = std::max(maxError, (accelerations.col(i) - acc).cwiseAbs().maxCoeff());
+            }
+            checks &= positions.cols() == nSamples && maxError < 1e-9;
+            if(!checks){std::cout << "Segment kernels failed for order " << poly->getOrder() << " with " << poly->getDimension() << " DoF, max error " << maxError << "." << std::endl;}
+        }
+
+        // The compile-time tables and a single unrolled evaluation.
+        checks &= polyDerivativeFactor(5, 2) == 20.0 && polyDerivativeFactor(1, 2) == 0.0 && polyDerivativeFactor(3, 0) == 1.0;
+        PolySegment<4, 2>::Coefficients c; c << 1, 2, 3, 4,
+                                                5, 6, 7, 8;
+        PolySegment<4, 2>::Vector p, v, a;
+        PolySegment<4, 2>::evaluate(c, 2.0, p, v, a);
+        checks &= p == Eigen::Vector2d(1 + 4 + 12 + 32, 5 + 12 + 28 + 64) && v == Eigen::Vector2d(2 + 12 + 48, 6 + 28 + 96) && a == Eigen::Vector2d(6 + 48, 14 + 96);
+
+        Eigen::MatrixXd positions, velocities, accelerations;
+        std::shared_ptr<const PiecewisePolynomial> poly = std::dynamic_pointer_cast<const PiecewisePolynomial>(trajectories[0]->getCore());
+        checks &= poly->evaluateSorted(sampleTimes.reverse(), positions, velocities, accelerations) == TGL_ERROR;
+        checks &= PiecewisePolynomial().evaluateSorted(sampleTimes, positions, velocities, accelerations) == TGL_ERROR;
+        if(!checks){std::cout << "Unrolled segment kernel failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class BatchEvaluationTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        int nWpts = 101;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 1.0, 51.0);
+        Eigen::VectorXd randomTimes = times;
+        for (int i = 1; i < nWpts - 1; ++i) {
+            randomTimes(i) += 0.1 * std::sin(3.0 * i);
+        }
+        Eigen::MatrixXd coords7 = Eigen::MatrixXd::Random(7, nWpts), coords9 = Eigen::MatrixXd::Random(9, nWpts);
+
+        // Uniform knots with an unrolled kernel, non-uniform knots with an unrolled kernel, and the generic loop.
+        std::vector<TrajectoryPtr> trajectories;
+        trajectories.push_back(std::make_shared<CubicSplineTrajectory>(WaypointSet(times, coords7)));
+        trajectories.push_back(std::make_shared<MinimumSnapTrajectory>(WaypointSet(randomTimes, coords7.topRows(3)), 4));
+        trajectories.push_back(std::make_shared<CubicSplineTrajectory>(WaypointSet(randomTimes, coords9)));
+        // Coefficients larger than TGL_BATCH_SORT_BYTES, evaluated through the segment buckets.
+        int nLarge = 20001;
+        Eigen::VectorXd largeTimes = Eigen::VectorXd::LinSpaced(nLarge, 1.0, 51.0);
+        for (int i = 1; i < nLarge - 1; ++i) {
+            largeTimes(i) += 0.0005 * std::sin(3.0 * i);
+        }
+        trajectories.push_back(std::make_shared<CubicSplineTrajectory>(WaypointSet(largeTimes, Eigen::MatrixXd::Random(7, nLarge))));
+        checks &= trajectories.back()->getMemoryUsage() > TGL_BATCH_SORT_BYTES;
+
+        // Unsorted times, with repeats, knot times and times out of bounds.
+        int nSamples = 70000;
+        Eigen::VectorXd sampleTimes = 27.0 * (Eigen::VectorXd::Random(nSamples).array() + 1.0) - 1.0;
+        for (int i = 0; i < nWpts; ++i) {
+            sampleTimes(97 * i) = randomTimes(i);
+            sampleTimes(97 * i + 1) = times(i);
+        }
+        sampleTimes.segment(20000, 1000) = sampleTimes.segment(30000, 1000);
+        for (auto& trajectory : trajectories) {
+            TrajectoryCorePtr core = trajectory->getCore();
+            Eigen::MatrixXd positions, velocities, accelerations, corePositions, coreVelocities, coreAccelerations;
+            checks &= trajectory->getDesiredBatch(sampleTimes, positions, velocities, accelerations) == TGL_OK;
+            checks &= core->TrajectoryCore::evaluateBatch(sampleTimes.head(5000), corePositions, coreVelocities, coreAccelerations) == TGL_OK;
+            Eigen::VectorXd pos, vel, acc;
+            int cursor = 0;
+            double maxError = 0.0, maxDefaultError = 0.0;
+            for (int i = 0; i < nSamples; ++i) {
+                core->evaluate(pos, vel, acc, sampleTimes(i), cursor);
+                maxError = std::max(maxError, (positions.col(i) - pos).cwiseAbs().maxCoeff());
+                maxError = std::max(maxError, (velocities.col(i) - vel).cwiseAbs().maxCoeff());
+                maxError = std::max(maxError, (accelerations.col(i) - acc).cwiseAbs().maxCoeff());
+                if (i < 5000) {
+                    maxDefaultError = std::max(maxDefaultError, (corePositions.col(i) - pos).cwiseAbs().maxCoeff());
+                    maxDefaultError = std::max(maxDefaultError, (coreAccelerations.col(i) - acc).cwiseAbs().maxCoeff());
+                }
+            }
+            checks &= positions.cols() == nSamples && maxError < 1e-9 && corePositions.cols() == 5000 && maxDefaultError == 0.0;
+            if(!checks){std::cout << "Batch evaluation failed with " << core->getDimension() << " DoF, max error " << maxError << ", max default error " << maxDefaultError << "." << std::endl;}
+        }
+
+        // A trajectory without a core goes through its own implementation.
+        int nDemo = 201;
+        Eigen::VectorXd demoTimes = Eigen::VectorXd::LinSpaced(nDemo, 0.0, 1.0);
+        Eigen::MatrixXd demo(1, nDemo);
+        demo.row(0) = demoTimes.array().square().matrix().transpose();
+        DmpTrajectory dmp(WaypointSet(demoTimes, demo), 20);
+        Eigen::VectorXd dmpTimes = 0.6 * (Eigen::VectorXd::Random(200).array() + 1.0) - 0.1;
+        Eigen::MatrixXd positions, velocities, accelerations;
+        checks &= dmp.getCore() == nullptr && dmp.getDesiredBatch(dmpTimes, positions, velocities, accelerations) == TGL_OK;
+        Eigen::VectorXd pos, vel, acc;
+        double maxDmpError = 0.0;
+        for (int i = 0; i < dmpTimes.size(); ++i) {
+            dmp.getDesired(pos, vel, acc, dmpTimes(i));
+            maxDmpError = std::max(maxDmpError, (positions.col(i) - pos).norm() + (velocities.col(i) - vel).norm());
+        }
+        checks &= positions.cols() == dmpTimes.size() && maxDmpError < 1e-12;
+        if(!checks){std::cout << "DMP batch evaluation failed, max error " << maxDmpError << "." << std::endl;}
+
+        // Bad input.
+        Eigen::VectorXd nanTimes = sampleTimes.head(10);
+        nanTimes(5) = std::numeric_limits<double>::quiet_NaN();
+        checks &= trajectories[0]->getDesiredBatch(nanTimes, positions, velocities, accelerations) == TGL_ERROR;
+        checks &= dmp.getDesiredBatch(nanTimes, positions, velocities, accelerations) == TGL_ERROR;
+        checks &= PiecewisePolynomial().evaluateBatch(sampleTimes, positions, velocities, accelerations) == TGL_ERROR;
+        checks &= CubicSplineTrajectory().getDesiredBatch(sampleTimes, positions, velocities, accelerations) == TGL_ERROR;
+        if(!checks){std::cout << "Batch evaluation input checks failed." << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class PerformanceCountersTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool checks = true;
+        int nWpts = 51;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(nWpts, 0.0, 5.0);
+        Eigen::MatrixXd coords = Eigen::MatrixXd::Random(3, nWpts);
+
+        // Waypoint sets count their assignments and lookups.
+        WaypointSet wptSet(times, coords);
+        PerformanceCounters::Snapshot wptSnapshot = wptSet.getPerformanceSnapshot();
+        checks &= wptSnapshot.rebuilds == 1 && wptSnapshot.allocatedBytes > sizeof(double) * coords.size() && wptSnapshot.evaluations == 0;
+        wptSet.getWaypointAtTime(times(3));
+        checks &= wptSet.assign(times, Eigen::MatrixXd::Constant(3, nWpts, std::numeric_limits<double>::quiet_NaN())) == TGL_ERROR;
+        wptSnapshot = wptSet.getPerformanceSnapshot();
+        checks &= wptSnapshot.rebuilds == 1 && wptSnapshot.evaluations == 1 && WaypointSet(wptSet).getPerformanceSnapshot().rebuilds == 0;
+        if(!checks){std::cout << "Waypoint set counters failed." << std::endl;}
+
+        // Trajectories count their builds, evaluations and segment lookups.
+        CubicSplineTrajectory spline(wptSet);
+        PerformanceCounters::Snapshot snapshot = spline.getPerformanceSnapshot();
+        checks &= snapshot.rebuilds == 1 && snapshot.allocatedBytes == spline.getMemoryUsage() && snapshot.lastBuildTime > 0.0 && snapshot.totalBuildTime == snapshot.lastBuildTime;
+        Eigen::VectorXd pos, vel, acc;
+        for (int i = 0; i < 500; ++i) {
+            spline.getDesired(pos, vel, acc, 0.01 * i);
+        }
+        snapshot = spline.getPerformanceSnapshot();
+        checks &= snapshot.evaluations == 500 && snapshot.segmentHits == 500 && snapshot.segmentMisses == 0 && snapshot.lastEvaluationLatency > 0.0;
+        Eigen::MatrixXd positions, velocities, accelerations;
+        spline.getDesired(pos, vel, acc, 0.5);
+        const PerformanceCounters::Clock::time_point batchStart = PerformanceCounters::Clock::now();
+        spline.getDesiredBatch(times, positions, velocities, accelerations);
+        const double batchTime = std::chrono::duration<double>(PerformanceCounters::Clock::now() - batchStart).count();
+        snapshot = spline.getPerformanceSnapshot();
+        checks &= snapshot.lastEvaluationLatency > 0.0 && snapshot.lastEvaluationLatency * nWpts <= batchTime;
+        checks &= spline.setWaypoints(wptSet) == TGL_OK;
+        snapshot = spline.getPerformanceSnapshot();
+        checks &= snapshot.evaluations == uint64_t(501 + nWpts) && snapshot.segmentMisses == 1 && snapshot.rebuilds == 2 && snapshot.allocatedBytes == 2 * spline.getMemoryUsage();
+        checks &= CubicSplineTrajectory(spline).getPerformanceSnapshot().evaluations == 0;
+        if(!checks){std::cout << "Trajectory counters failed." << std::endl;}
+
+        // Snapshots can be taken while another thread evaluates.
+        MinimumSnapTrajectory snap(wptSet);
+        std::thread worker([&snap]() {
+            Eigen::VectorXd workerPos, workerVel, workerAcc;
+            for (int i = 0; i < 20000; ++i) {
+                snap.getDesired(workerPos, workerVel, workerAcc, 5.0 * (i % 1000) / 1000.0);
+            }
+        });
+        uint64_t previousEvaluations = 0;
+        for (int i = 0; i < 100; ++i) {
+            const uint64_t evaluations = snap.getPerformanceSnapshot().evaluations;
+            checks &= evaluations >= previousEvaluations;
+            previousEvaluations = evaluations;
+        }
+        worker.join();
+        snapshot = snap.getPerformanceSnapshot();
+        checks &= snapshot.evaluations == 20000 && snapshot.segmentHits + snapshot.segmentMisses == 20000 && snapshot.segmentMisses == 19;
+        snap.resetPerformanceCounters();
+        checks &= snap.getPerformanceSnapshot().evaluations == 0 && snap.getPerformanceSnapshot().rebuilds == 0;
+        if(!checks){std::cout << "Concurrent counters failed, " << snapshot.segmentMisses << " misses." << std::endl;}
+
+        // Prometheus text export.
+        PerformanceCounters::NamedSnapshots snapshots;
+        snapshots.push_back(std::make_pair("spline \"a\"", spline.getPerformanceSnapshot()));
+        snapshots.push_back(std::make_pair("waypoints", wptSet.getPerformanceSnapshot()));
+        std::stringstream stream;
+        PerformanceCounters::writePrometheus(stream, snapshots);
+        const std::string text = stream.str();
+        checks &= text.find("# TYPE tgl_evaluations_total counter\n") != std::string::npos;
+        checks &= text.find("tgl_evaluations_total{object=\"spline \\\"a\\\"\"} " + std::to_string(501 + nWpts) + "\n") != std::string::npos;
+        checks &= text.find("tgl_rebuilds_total{object=\"waypoints\"} 1\n") != std::string::npos;
+        checks &= text.find("# TYPE tgl_last_evaluation_latency_seconds gauge\n") != std::string::npos;
+        char directoryTemplate[] = "/tmp/tgl_metrics_XXXXXX";
+        if (!mkdtemp(directoryTemplate)) {
+            std::cout << "Could not create a temporary directory." << std::endl;
+            return TGL_TEST_FAILURE;
+        }
+        const std::string filename = std::string(directoryTemplate) + "/tgl.prom";
+        checks &= PerformanceCounters::writePrometheusFile(filename, snapshots) == TGL_OK;
+        std::ifstream file(filename.c_str());
+        std::stringstream fileText;
+        fileText << file.rdbuf();
+        checks &= fileText.str().find("tgl_rebuilds_total{object=\"waypoints\"} 1\n") != std::string::npos;
+        // No temporary file is left behind, the directory only holds ".", ".." and the metrics.
+        int nFiles = 0;
+        DIR* directory = opendir(directoryTemplate);
+        while (directory && readdir(directory)) {
+            ++nFiles;
+        }
+        if (directory) {
+            closedir(directory);
+        }
+        checks &= nFiles == 3;
+        checks &= PerformanceCounters::writePrometheusFile(std::string(directoryTemplate) + "/missing/tgl.prom", snapshots) == TGL_ERROR;
+        std::remove(filename.c_str());
+        rmdir(directoryTemplate);
+        if(!checks){std::cout << "Prometheus export failed:\n" << text << std::endl;}
+
+        return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
 /*************************************************
 *
 *   main
@@ -76,6 +1571,28 @@ int main(int argc, char const *argv[])
     *   e.g. testVector.push_back(new BlahTest);
     */
     testVector.push_back(new ConstructorTest);
+    testVector.push_back(new Se3BSplineTest);
+    testVector.push_back(new CubicSplineTest);
+    testVector.push_back(new WrenchTrajectoryTest);
+    testVector.push_back(new BlendedTrajectoryTest);
+    testVector.push_back(new SequenceTrajectoryTest);
+    testVector.push_back(new RetimedTrajectoryTest);
+    testVector.push_back(new ClosestTimeTest);
+    testVector.push_back(new VerifyLimitsTest);
+    testVector.push_back(new ArcLengthTest);
+    testVector.push_back(new MinimumSnapTest);
+    testVector.push_back(new CoefficientCacheTest);
+    testVector.push_back(new TrajectoryCacheTest);
+    testVector.push_back(new TrajectoryEvaluatorTest);
+    testVector.push_back(new AsyncBuildTest);
+    testVector.push_back(new SampleRangeTest);
+    testVector.push_back(new PolynomialKernelTest);
+    testVector.push_back(new SplineFitTest);
+    testVector.push_back(new DmpTest);
+    testVector.push_back(new PiecewisePolynomialTest);
+    testVector.push_back(new PolySegmentTest);
+    testVector.push_back(new BatchEvaluationTest);
+    testVector.push_back(new PerformanceCountersTest);
 
     /*****************************************/
     return runAllTests(testVector);
@@ -28,6 +28,9 @@
 
 #include "../TglTestTools.hpp"
 #include "tgl/WaypointSet.hpp"
+#include <limits>
+#include <cmath>
+#include <algorithm>
 
 using namespace tgl;
 
@@ -125,6 +128,178 @@ protected:
     }
 };
 
+class ViewTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        int nDof = 3; Eigen::VectorXd onesVec = Eigen::VectorXd::Ones(nDof);
+        StdWaypointVector wpt_vector = {Waypoint(onesVec*1.0, 0.0), Waypoint(onesVec*2.0, 1.1), Waypoint(onesVec*3.0, 2.1)};
+        WaypointSet wpts(wpt_vector);
+        const WaypointSet& constWpts = wpts;
+
+        bool testsOk = true;
+
+        testsOk &= constWpts.asMatrixView() == wpts.asMatrix(false, false);
+        if(!testsOk){LOG(ERROR) << "asMatrixView(false) does not match asMatrix(false, false).";}
+        testsOk &= constWpts.asMatrixView(true) == wpts.asMatrix(true, false);
+        if(!testsOk){LOG(ERROR) << "asMatrixView(true) does not match asMatrix(true, false).";}
+        testsOk &= constWpts.asRowMajorMatrixView() == wpts.asMatrix(false, true);
+        if(!testsOk){LOG(ERROR) << "asRowMajorMatrixView(false) does not match asMatrix(false, true).";}
+        testsOk &= constWpts.asRowMajorMatrixView(true) == wpts.asMatrix(true, true);
+        if(!testsOk){LOG(ERROR) << "asRowMajorMatrixView(true) does not match asMatrix(true, true).";}
+        testsOk &= constWpts.getWaypointTimesView() == wpts.getWaypointTimes();
+        if(!testsOk){LOG(ERROR) << "getWaypointTimesView() does not match getWaypointTimes().";}
+
+        // The column and row views must share the same memory.
+        testsOk &= constWpts.asMatrixView().data() == constWpts.asRowMajorMatrixView().data();
+        testsOk &= constWpts.asMatrixView(true).data() == constWpts.asRowMajorMatrixView(true).data();
+        if(!testsOk){LOG(ERROR) << "Views do not share the internal storage.";}
+
+        WaypointSet emptyWpts;
+        testsOk &= emptyWpts.asMatrixView().size() == 0;
+        testsOk &= emptyWpts.asRowMajorMatrixView(true).size() == 0;
+        if(!testsOk){LOG(ERROR) << "Views of an empty set are not empty.";}
+
+        return testsOk ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class BulkAssignTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        int nDof = 3; Eigen::VectorXd onesVec = Eigen::VectorXd::Ones(nDof);
+        StdWaypointVector wpt_vector = {Waypoint(onesVec*1.0, 0.0), Waypoint(onesVec*2.0, 1.1), Waypoint(onesVec*3.0, 2.1)};
+        Eigen::Vector3d wpt_times(0.0, 1.1, 2.1);
+        Eigen::MatrixXd testMat(nDof,3); testMat << onesVec*1.0, onesVec*2.0, onesVec*3.0;
+
+        WaypointSet wptRef(wpt_vector);
+        WaypointSet wptBulk(wpt_times, testMat);
+
+        bool testsOk = true;
+
+        testsOk &= wptBulk.asMatrix(true, false) == wptRef.asMatrix(true, false);
+        testsOk &= wptBulk.asMatrix(false, true) == wptRef.asMatrix(false, true);
+        testsOk &= wptBulk.getWaypointTimes() == wptRef.getWaypointTimes();
+        testsOk &= wptBulk.getNumberOfWaypoints() == 3 && wptBulk.getWaypointDimension() == nDof;
+        testsOk &= wptBulk.getWaypointType() == TGL_WPT_VECTOR_XD;
+        testsOk &= onesVec*2.0 == wptBulk.getWaypointAtTime(1.1);
+        if(!testsOk){LOG(ERROR) << "Bulk constructor does not match the Waypoint based constructor.";}
+
+        // Invalid inputs must be rejected and leave the set untouched.
+        Eigen::Vector3d badTimes(0.0, -1.0, 2.1);
+        testsOk &= !wptBulk.assign(badTimes, testMat);
+        testsOk &= !wptBulk.assign(wpt_times, testMat.leftCols(2));
+        Eigen::MatrixXd nanMat = testMat; nanMat(1,1) = std::numeric_limits<double>::quiet_NaN();
+        testsOk &= !wptBulk.assign(wpt_times, nanMat);
+        testsOk &= !wptBulk.assign(Eigen::Vector3d(0.0, 2.1, 1.1), testMat);
+        testsOk &= !wptBulk.assign(Eigen::Vector3d(0.0, 1.1, 1.1), testMat);
+        testsOk &= wptBulk.asMatrix() == testMat;
+        if(!testsOk){LOG(ERROR) << "Invalid bulk input was accepted.";}
+
+        // Displacement waypoints with quaternions.
+        Eigen::MatrixXd quats(4,3); quats << 1, 0, 0,
+                                            0, 1, 0,
+                                            0, 0, 0,
+                                            0, 0, 1;
+        WaypointSet dispRef = {Waypoint(Eigen::Displacementd(1,1,1,1,0,0,0), 0.0), Waypoint(Eigen::Displacementd(2,2,2,0,1,0,0), 1.1), Waypoint(Eigen::Displacementd(3,3,3,0,0,0,1), 2.1)};
+        WaypointSet dispBulk(wpt_times, testMat, quats);
+        testsOk &= dispBulk.getWaypointType() == TGL_WPT_LGSM_DISP;
+        testsOk &= dispBulk.rotationsAsMatrixView() == quats;
+        testsOk &= dispBulk.rotationsAsMatrixView() == dispRef.rotationsAsMatrixView();
+        testsOk &= dispBulk.asMatrix() == dispRef.asMatrix();
+        testsOk &= !dispBulk.assign(wpt_times, testMat, quats*2.0);
+        testsOk &= !dispBulk.assign(wpt_times, testMat, Eigen::MatrixXd(4, 0));
+        testsOk &= !dispBulk.assign(wpt_times, Eigen::MatrixXd(0, 3), Eigen::MatrixXd(4, 0));
+        testsOk &= dispBulk.rotationsAsMatrixView() == quats;
+        if(!testsOk){LOG(ERROR) << "Bulk quaternion assignment did not work.";}
+
+        // An empty waypoint vector empties the set.
+        testsOk &= wptBulk.setWaypoints(StdWaypointVector()) == TGL_OK;
+        testsOk &= wptBulk.empty() && wptBulk.getNumberOfWaypoints() == 0 && wptBulk.getWaypointType() == TGL_WPT_NONE;
+        if(!testsOk){LOG(ERROR) << "Setting no waypoints did not empty the set.";}
+
+        return testsOk ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
+class SimplifyTest : public TglTest{
+protected:
+    TglTestMessage test(){
+        bool testsOk = true;
+
+        // Collinear points collapse to the end points and keep their times.
+        int n = 11;
+        Eigen::VectorXd times = Eigen::VectorXd::LinSpaced(n, 0.0, 1.0);
+        Eigen::MatrixXd line(2, n); line.row(0) = times.transpose() * 3.0; line.row(1) = times.transpose() * -1.0;
+        WaypointSet lineSet(times, line), simplified;
+        testsOk &= lineSet.simplify(simplified, 1e-9) == TGL_OK;
+        testsOk &= simplified.getNumberOfWaypoints() == 2;
+        testsOk &= simplified.getWaypointTimesView()(1) == 1.0 && simplified.asMatrixView().col(1) == line.col(n-1);
+        testsOk &= lineSet.simplify(simplified, -1.0) == TGL_ERROR;
+        if(!testsOk){LOG(ERROR) << "Collinear waypoints were not simplified.";}
+
+        // A corner is kept.
+        line(1, 5) = 1.0;
+        lineSet.assign(times, line);
+        testsOk &= lineSet.simplify(simplified, 0.1) == TGL_OK && simplified.getNumberOfWaypoints() == 5;
+        testsOk &= simplified.getWaypointTimesView()(2) == times(5);
+        if(!testsOk){LOG(ERROR) << "A corner was removed.";}
+
+        // Quaternions turning at constant speed are removed, unless the orientations ignore the interpolation.
+        Eigen::MatrixXd quats(4, n);
+        for (int i = 0; i < n; ++i) {
+            double angle = (i < 6 ? i : 10 - i) * 0.1;
+            quats.col(i) << std::cos(angle / 2.0), 0.0, 0.0, std::sin(angle / 2.0);
+        }
+        Eigen::MatrixXd zeros = Eigen::MatrixXd::Zero(3, n);
+        WaypointSet quatSet(times, zeros, quats);
+        testsOk &= quatSet.simplify(simplified, 1e-6) == TGL_OK && simplified.getNumberOfWaypoints() == 2;
+        testsOk &= quatSet.simplify(simplified, 1e-6, 0.01) == TGL_OK && simplified.getNumberOfWaypoints() == 3;
+        testsOk &= simplified.getWaypointType() == TGL_WPT_LGSM_DISP && simplified.rotationsAsMatrixView().col(1) == quats.col(5);
+        if(!testsOk){LOG(ERROR) << "Orientation tolerance was not respected.";}
+
+        // A zero distance tolerance still checks the orientations of the waypoints lying exactly on the path.
+        Eigen::VectorXd fewTimes = Eigen::VectorXd::LinSpaced(5, 0.0, 1.0);
+        Eigen::MatrixXd fewCoords(3, 5), fewQuats(4, 5);
+        fewCoords.setZero();
+        fewCoords.row(0) = fewTimes.transpose();
+        fewQuats.colwise() = Eigen::Vector4d(1.0, 0.0, 0.0, 0.0);
+        fewQuats.col(2) << std::cos(0.5), 0.0, 0.0, std::sin(0.5);
+        WaypointSet rotatedSet(fewTimes, fewCoords, fewQuats);
+        testsOk &= rotatedSet.simplify(simplified, 0.0, 0.1) == TGL_OK && simplified.getNumberOfWaypoints() == 5;
+        testsOk &= rotatedSet.simplify(simplified, 1e-12, 0.1) == TGL_OK && simplified.getNumberOfWaypoints() == 5;
+        if(!testsOk){LOG(ERROR) << "A zero tolerance dropped a rotated waypoint, kept " << simplified.getNumberOfWaypoints() << ".";}
+
+        // A large noisy path goes through the parallel tasks. Every removed waypoint is within tolerance of its kept neighbours and the result is repeatable.
+        n = 200000;
+        double tolerance = 0.01;
+        Eigen::VectorXd bigTimes = Eigen::VectorXd::LinSpaced(n, 0.0, 100.0);
+        Eigen::MatrixXd path(3, n);
+        path.row(0) = bigTimes.array().sin().matrix().transpose();
+        path.row(1) = (0.3 * bigTimes.array()).cos().matrix().transpose();
+        path.row(2) = 0.001 * Eigen::RowVectorXd::Random(n);
+        WaypointSet bigSet(bigTimes, path), bigSimplified, bigAgain;
+        testsOk &= bigSet.simplify(bigSimplified, tolerance) == TGL_OK && bigSet.simplify(bigAgain, tolerance) == TGL_OK;
+        testsOk &= bigSimplified.getWaypointTimesView() == bigAgain.getWaypointTimesView();
+        int nKept = bigSimplified.getNumberOfWaypoints();
+        testsOk &= nKept > 2 && nKept < n / 10;
+        Eigen::VectorXd keptTimes = bigSimplified.getWaypointTimesView();
+        Eigen::MatrixXd keptPath = bigSimplified.asMatrixView();
+        double worstDistance = 0.0;
+        int k = 0;
+        for (int i = 0; i < n; ++i) {
+            while (k + 1 < nKept && keptTimes(k + 1) <= bigTimes(i)) { ++k; }
+            if (k + 1 >= nKept) { break; }
+            Eigen::Vector3d a = keptPath.col(k), ab = keptPath.col(k + 1) - a, ai = path.col(i) - a;
+            double u = std::min(1.0, std::max(0.0, ai.dot(ab) / ab.squaredNorm()));
+            worstDistance = std::max(worstDistance, (ai - u * ab).norm());
+        }
+        testsOk &= worstDistance <= tolerance;
+        if(!testsOk){LOG(ERROR) << "Large path simplification is wrong, kept " << nKept << " waypoints with a worst distance of " << worstDistance << ".";}
+
+        return testsOk ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
+    }
+};
+
 /*************************************************
 *
 *   main
@@ -141,6 +316,9 @@ int main(int argc, char const *argv[])
     */
     testVector.push_back(new ConstructorTest);
     testVector.push_back(new GetterTest);
+    testVector.push_back(new ViewTest);
+    testVector.push_back(new BulkAssignTest);
+    testVector.push_back(new SimplifyTest);
 
     /*****************************************/
     return runAllTests(testVector);
@@ -61,11 +61,14 @@ protected:
         Eigen::VectorXd ones(3); ones << 1, 1, 1;
         Eigen::Displacementd disp(2.0, 2.0, 2.0, 1.0, 0.0, 0.0, 0.0);
         Eigen::Rotation3d rot(1.0, 0.0, 0.0, 0.0);
+        Eigen::Wrenchd wrench(0.1, 0.2, 0.3, 1.0, 2.0, 3.0);
+        double wrench_time = 0.3;
 
         Waypoint empty_wpt;
         Waypoint vec_wpt(ones, vec_time);
         Waypoint disp_wpt(disp, disp_time);
         Waypoint rot_wpt(rot, rot_time);
+        Waypoint wrench_wpt(wrench, wrench_time);
 
         bool checks = true;
         checks &= empty_wpt.get() == Eigen::VectorXd::Zero(0);
@@ -98,6 +101,15 @@ protected:
         checks &= rot_wpt.getTime() == rot_time;
         if(!checks){std::cout << "Failed @ " << __LINE__ - 1 << std::endl;}
 
+        checks &= wrench_wpt.type() == TGL_WPT_LGSM_WRENCH;
+        if(!checks){std::cout << "Failed @ " << __LINE__ - 1 << std::endl;}
+        checks &= wrench_wpt.getDimension() == 6;
+        if(!checks){std::cout << "Failed @ " << __LINE__ - 1 << std::endl;}
+        checks &= wrench_wpt.getWrench() == wrench;
+        if(!checks){std::cout << "Failed @ " << __LINE__ - 1 << std::endl;}
+        checks &= wrench_wpt.getTime() == wrench_time;
+        if(!checks){std::cout << "Failed @ " << __LINE__ - 1 << std::endl;}
+
         return checks ? TGL_TEST_SUCCESS : TGL_TEST_FAILURE;
     }
 };
@@ -129,6 +141,11 @@ protected:
         checks &= ((wpt2 / 2.0) == wpt1);
         if(!checks){std::cout << "/ operator failed." << std::endl;}
 
+        Waypoint wptCopy;
+        wptCopy = wpt3;
+        checks &= wptCopy == wpt3 && wptCopy.getTime() == wpt3.getTime() && wptCopy.type() == wpt3.type();
+        if(!checks){std::cout << "= operator failed." << std::endl;}
+
         if (checks) {return TGL_TEST_SUCCESS;}
         else        {return TGL_TEST_FAILURE;}
     }